@@ -37,3 +37,27 @@ function(plainframework_enable_warnings target)
       -Wno-long-long -Wno-variadic-macros)
   endif()
 endfunction()
+
+# Generate the packet classes and factories from the .pkt schema files by
+# framework/tools/packetgen/packetgen.py, the generated sources are append to
+# ${out_sources} and the headers are in ${output_dir}.
+function(plainframework_generate_packets out_sources output_dir)
+  find_program(PLAINFRAMEWORK_PYTHON NAMES python3 python)
+  if(NOT PLAINFRAMEWORK_PYTHON)
+    message(FATAL_ERROR "python is required to generate packets.")
+  endif()
+  set(generator ${root_dir}/framework/tools/packetgen/packetgen.py)
+  set(sources)
+  foreach(schema ${ARGN})
+    get_filename_component(schema_path ${schema} ABSOLUTE)
+    get_filename_component(name ${schema} NAME_WE)
+    set(outputs ${output_dir}/${name}.h ${output_dir}/${name}.cc)
+    add_custom_command(OUTPUT ${outputs}
+      COMMAND ${PLAINFRAMEWORK_PYTHON} ${generator}
+              --output ${output_dir} ${schema_path}
+      DEPENDS ${schema_path} ${generator}
+      COMMENT "Generating packets from ${name}.pkt")
+    list(APPEND sources ${output_dir}/${name}.cc)
+  endforeach()
+  set(${out_sources} ${${out_sources}} ${sources} PARENT_SCOPE)
+endfunction()
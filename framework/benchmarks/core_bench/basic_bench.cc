@@ -0,0 +1,160 @@
+#include "env.h"
+#include "pf/basic/global.h"
+#include "pf/basic/logger.h"
+#include "pf/basic/trace.h"
+#include "pf/basic/time_manager.h"
+#include "pf/basic/task_queue.tcc"
+#include "pf/basic/hashmap/template.h"
+#include "pf/basic/type/variable.h"
+
+using namespace pf_basic;
+
+static void BM_hashmap_get(benchmark::State &state) {
+  auto count = static_cast<int32_t>(state.range(0));
+  hashmap::Template<int32_t, int32_t> map;
+  map.init(count);
+  for (int32_t i = 0; i < count; ++i) map.add(i, i);
+  int32_t key{0};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(map.get(key));
+    if (++key >= count) key = 0;
+  }
+}
+BENCHMARK(BM_hashmap_get)->Arg(64)->Arg(4096);
+
+static void BM_hashmap_set(benchmark::State &state) {
+  auto count = static_cast<int32_t>(state.range(0));
+  hashmap::Template<int32_t, int32_t> map;
+  map.init(count);
+  for (int32_t i = 0; i < count; ++i) map.add(i, i);
+  int32_t key{0};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(map.set(key, key));
+    if (++key >= count) key = 0;
+  }
+}
+BENCHMARK(BM_hashmap_set)->Arg(64)->Arg(4096);
+
+static void BM_hashmap_string_get(benchmark::State &state) {
+  hashmap::Template<std::string, int32_t> map;
+  map.init(64);
+  std::vector<std::string> keys;
+  for (int32_t i = 0; i < 64; ++i) {
+    keys.push_back("default.net.key" + std::to_string(i));
+    map.add(keys.back(), i);
+  }
+  size_t index{0};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(map.get(keys[index]));
+    if (++index >= keys.size()) index = 0;
+  }
+}
+BENCHMARK(BM_hashmap_string_get);
+
+static void BM_variable_from_int(benchmark::State &state) {
+  type::variable_t variable;
+  int32_t value{0};
+  for (auto _ : state) {
+    variable = ++value;
+    benchmark::DoNotOptimize(variable);
+  }
+}
+BENCHMARK(BM_variable_from_int);
+
+//Like a db row(the numbers and short strings).
+static void BM_variable_row_copy(benchmark::State &state) {
+  type::variable_array_t row;
+  for (int32_t i = 0; i < 4; ++i) {
+    row.push_back(i * 1000);
+    row.push_back("name" + std::to_string(i));
+  }
+  for (auto _ : state) {
+    type::variable_array_t copy(row);
+    benchmark::DoNotOptimize(copy.data());
+  }
+}
+BENCHMARK(BM_variable_row_copy);
+
+static void BM_variable_to_int(benchmark::State &state) {
+  type::variable_t variable{12345};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(variable.get<int32_t>());
+  }
+}
+BENCHMARK(BM_variable_to_int);
+
+static void BM_variable_to_double(benchmark::State &state) {
+  type::variable_t variable{123.45};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(variable.get<double>());
+  }
+}
+BENCHMARK(BM_variable_to_double);
+
+//The config read in the hot paths, like GLOBALS["log.print"] in the logger.
+static void BM_variable_globals(benchmark::State &state) {
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(GLOBALS["log.print"] == true);
+  }
+}
+BENCHMARK(BM_variable_globals);
+
+static void BM_config_handle(benchmark::State &state) {
+  static const pf_basic::config::handle<bool> print{"log.print"};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(print.get());
+  }
+}
+BENCHMARK(BM_config_handle);
+
+static void BM_trace_span(benchmark::State &state) {
+  pf_basic::trace::set_enable(state.range(0) != 0);
+  for (auto _ : state) {
+    TRACE_SCOPE("bench", "span");
+  }
+  pf_basic::trace::set_enable(false);
+}
+BENCHMARK(BM_trace_span)->Arg(0)->Arg(1);
+
+static void BM_time_tickcount(benchmark::State &state) {
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(TIME_MANAGER_POINTER->get_tickcount());
+  }
+}
+BENCHMARK(BM_time_tickcount);
+
+static void BM_time_log_timestr(benchmark::State &state) {
+  char time_str[256]{0};
+  for (auto _ : state) {
+    pf_basic::Logger::get_log_timestr(time_str, sizeof(time_str) - 1);
+    benchmark::DoNotOptimize(time_str);
+  }
+}
+BENCHMARK(BM_time_log_timestr);
+
+static void BM_task_queue_post_drain(benchmark::State &state) {
+  pf_basic::TaskQueue queue;
+  int64_t value{0};
+  auto count = state.range(0);
+  for (auto _ : state) {
+    for (int64_t i = 0; i < count; ++i)
+      queue.post([&value, i]() { value += i; });
+    queue.drain();
+  }
+  benchmark::DoNotOptimize(value);
+  state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_task_queue_post_drain)->Arg(1)->Arg(64);
+
+static void BM_logger_fast_savelog(benchmark::State &state) {
+  GLOBALS["log.active"] = true;
+  pf_basic::config::commit();
+  int32_t value{0};
+  for (auto _ : state) {
+    FAST_LOG("pf_bench", "[bench] fast_savelog value: %d, name: %s",
+             ++value, "pf_bench");
+  }
+  GLOBALS["log.active"] = false;
+  pf_basic::config::commit();
+}
+BENCHMARK(BM_logger_fast_savelog);
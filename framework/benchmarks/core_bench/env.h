@@ -0,0 +1,68 @@
+#ifndef PF_CORE_BENCH_ENV_H_
+#define PF_CORE_BENCH_ENV_H_
+
+#include "benchmark/benchmark.h"
+#include "pf/net/stream/input.h"
+#include "pf/net/stream/output.h"
+#include "pf/net/packet/interface.h"
+#include "pf/net/packet/factory.h"
+
+#define BENCH_PACKET_ID (NET_PACKET_ID_NORMAL_END)
+#define BENCH_PAYLOAD_MAX (4 * 1024)
+
+//The body is value(4) size(4) and payload(size), execute do nothing.
+class BenchPacket : public pf_net::packet::Interface {
+
+ public:
+   BenchPacket() : value_{0}, size_{0} {};
+   virtual ~BenchPacket() {};
+
+ public:
+   virtual bool read(pf_net::stream::Input &istream) {
+     istream >> value_ >> size_;
+     if (size_ > BENCH_PAYLOAD_MAX) return false;
+     return 0 == size_ || istream.read(payload_, size_) == size_;
+   };
+   virtual bool write(pf_net::stream::Output &ostream) {
+     ostream << value_ << size_;
+     return 0 == size_ || ostream.write(payload_, size_) == size_;
+   };
+   virtual uint32_t execute(pf_net::connection::Basic *) {
+     return kPacketExecuteStatusContinue;
+   };
+   virtual uint16_t get_id() const { return BENCH_PACKET_ID; };
+   virtual uint32_t size() const {
+     return sizeof(value_) + sizeof(size_) + size_;
+   };
+
+ public:
+   void set(int32_t value, uint32_t size) {
+     value_ = value;
+     size_ = size > BENCH_PAYLOAD_MAX ? BENCH_PAYLOAD_MAX : size;
+     memset(payload_, 'x', size_);
+   };
+
+ private:
+   int32_t value_;
+   uint32_t size_;
+   char payload_[BENCH_PAYLOAD_MAX];
+
+};
+
+class BenchPacketFactory : public pf_net::packet::Factory {
+
+ public:
+   virtual ~BenchPacketFactory() {};
+
+ public:
+   virtual pf_net::packet::Interface *packet_create() {
+     return new BenchPacket();
+   };
+   virtual uint16_t packet_id() const { return BENCH_PACKET_ID; };
+   virtual uint32_t packet_max_size() const {
+     return sizeof(int32_t) + sizeof(uint32_t) + BENCH_PAYLOAD_MAX;
+   };
+
+};
+
+#endif //PF_CORE_BENCH_ENV_H_
@@ -0,0 +1,77 @@
+#include "env.h"
+#include "pf/file/tab.h"
+
+using namespace pf_file;
+
+#define BENCH_TAB_RECORDS 1000
+
+//The first line is types, the second is field names.
+static std::unique_ptr<Tab> bench_tab() {
+  std::string memory{"INT\tSTRING\tFLOAT\nid\tname\tvalue\n"};
+  for (int32_t i = 1; i <= BENCH_TAB_RECORDS; ++i) {
+    memory += std::to_string(i) + "\tname" + std::to_string(i) + "\t" +
+              std::to_string(i * 0.5f) + "\n";
+  }
+  std::unique_ptr<Tab> tab(new Tab(1));
+  if (!tab->open_from_memory(memory.data(), memory.data() + memory.size()))
+    return nullptr;
+  tab->create_index(0);
+  return tab;
+}
+
+static void BM_tab_search_index(benchmark::State &state) {
+  auto tab = bench_tab();
+  if (is_null(tab)) {
+    state.SkipWithError("tab open failed");
+    return;
+  }
+  int32_t index{0};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(tab->search_index_equal(index + 1));
+    if (++index >= BENCH_TAB_RECORDS) index = 0;
+  }
+}
+BENCHMARK(BM_tab_search_index);
+
+static void BM_tab_search_position(benchmark::State &state) {
+  auto tab = bench_tab();
+  if (is_null(tab)) {
+    state.SkipWithError("tab open failed");
+    return;
+  }
+  int32_t line{0};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(tab->search_position(line, 2));
+    if (++line >= BENCH_TAB_RECORDS) line = 0;
+  }
+}
+BENCHMARK(BM_tab_search_position);
+
+static void BM_tab_search_first_column(benchmark::State &state) {
+  auto tab = bench_tab();
+  if (is_null(tab)) {
+    state.SkipWithError("tab open failed");
+    return;
+  }
+  int32_t value{0};
+  for (auto _ : state) {
+    Tab::field_data data(value + 1);
+    benchmark::DoNotOptimize(tab->search_first_column_equal(0, data));
+    if (++value >= BENCH_TAB_RECORDS) value = 0;
+  }
+}
+BENCHMARK(BM_tab_search_first_column);
+
+static void BM_tab_get_fielddata(benchmark::State &state) {
+  auto tab = bench_tab();
+  if (is_null(tab)) {
+    state.SkipWithError("tab open failed");
+    return;
+  }
+  int32_t line{0};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(tab->get_fielddata(line, "name"));
+    if (++line >= BENCH_TAB_RECORDS) line = 0;
+  }
+}
+BENCHMARK(BM_tab_get_fielddata);
@@ -0,0 +1,43 @@
+#include "env.h"
+#include "pf/basic/global.h"
+#include "pf/basic/time_manager.h"
+#include "pf/basic/logger.h"
+#include "pf/net/packet/factorymanager.h"
+#include "pf/util/compressor/minimanager.h"
+
+namespace {
+
+bool __stdcall register_factories() {
+  NET_PACKET_FACTORYMANAGER_POINTER->add_factory(new BenchPacketFactory());
+  return true;
+}
+
+} //namespace
+
+//The json result: --benchmark_out=pf_bench.json --benchmark_out_format=json
+int32_t main(int32_t argc, char **argv) {
+  GLOBALS["log.print"] = false;
+  GLOBALS["app.name"] = "pf_bench";
+  pf_basic::config::commit();
+  auto time_manager = new pf_basic::TimeManager();
+  unique_move(pf_basic::TimeManager, time_manager, g_time_manager);
+  if (!g_time_manager->init()) return 1;
+  auto logger = new pf_basic::Logger();
+  unique_move(pf_basic::Logger, logger, g_logger);
+  std::unique_ptr<pf_util::compressor::MiniManager>
+    minimanager(new pf_util::compressor::MiniManager());
+  if (!minimanager->init()) return 1;
+  {
+    using FactoryManager = pf_net::packet::FactoryManager;
+    std::unique_ptr<FactoryManager> pointer(new FactoryManager());
+    g_packetfactory_manager = std::move(pointer);
+    NET_PACKET_FACTORYMANAGER_POINTER->set_function_register_factories(
+        register_factories);
+    if (!NET_PACKET_FACTORYMANAGER_POINTER->init()) return 1;
+  }
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+  benchmark::RunSpecifiedBenchmarks();
+  LOGSYSTEM_POINTER->flush_alllog();
+  return 0;
+}
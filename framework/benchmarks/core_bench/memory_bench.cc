@@ -0,0 +1,56 @@
+#include "env.h"
+#include "pf/sys/memory/sharemap.h"
+
+using namespace pf_sys::memory;
+
+#define BENCH_SHAREMAP_KEY (0x7066b001)
+#define BENCH_SHAREMAP_SIZE (1024)
+
+static share::Map *bench_sharemap() {
+  static std::unique_ptr<share::Map> map;
+  if (map) return map.get();
+  map.reset(new share::Map());
+  if (!map->init(BENCH_SHAREMAP_KEY, BENCH_SHAREMAP_SIZE, 32, 64, true)) {
+    map.reset();
+    return nullptr;
+  }
+  return map.get();
+}
+
+static void bench_sharemap_keys(std::vector<std::string> &keys) {
+  for (int32_t i = 0; i < BENCH_SHAREMAP_SIZE / 2; ++i)
+    keys.push_back("key" + std::to_string(i));
+}
+
+static void BM_sharemap_set(benchmark::State &state) {
+  auto map = bench_sharemap();
+  if (is_null(map)) {
+    state.SkipWithError("share map init failed");
+    return;
+  }
+  std::vector<std::string> keys;
+  bench_sharemap_keys(keys);
+  size_t index{0};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(map->set(keys[index].c_str(), "value"));
+    if (++index >= keys.size()) index = 0;
+  }
+}
+BENCHMARK(BM_sharemap_set);
+
+static void BM_sharemap_get(benchmark::State &state) {
+  auto map = bench_sharemap();
+  if (is_null(map)) {
+    state.SkipWithError("share map init failed");
+    return;
+  }
+  std::vector<std::string> keys;
+  bench_sharemap_keys(keys);
+  for (auto &key : keys) map->set(key.c_str(), "value");
+  size_t index{0};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(map->get(keys[index].c_str()));
+    if (++index >= keys.size()) index = 0;
+  }
+}
+BENCHMARK(BM_sharemap_get);
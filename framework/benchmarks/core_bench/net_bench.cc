@@ -0,0 +1,88 @@
+#include "env.h"
+#include "pf/net/connection/basic.h"
+#include "pf/net/connection/manager/interface.h"
+#include "pf/net/protocol/interface.h"
+#include "pf/net/packet/factorymanager.h"
+
+using namespace pf_net;
+
+static bool bench_connection(connection::Basic &connection,
+                             protocol::Interface *protocol) {
+  if (!connection.init(protocol)) return false;
+  connection.clear();
+  connection.set_protocol(protocol);
+  connection.set_disconnect(false);
+  connection.set_empty(false);
+  return true;
+}
+
+//The packet bytes(header and body) as the protocol::Basic write.
+static std::string bench_packet_bytes(uint32_t size) {
+  BenchPacket packet;
+  packet.set(1, size);
+  char header[NET_PACKET_HEADERSIZE]{0};
+  uint16_t id = BENCH_PACKET_ID;
+  uint32_t packetcheck{0};
+  NET_PACKET_SETINDEX(packetcheck, 0);
+  NET_PACKET_SETLENGTH(packetcheck, packet.size());
+  memcpy(header, &id, sizeof(id));
+  memcpy(header + sizeof(id), &packetcheck, sizeof(packetcheck));
+  std::string result(header, sizeof(header));
+  int32_t value{1};
+  result.append(reinterpret_cast<const char *>(&value), sizeof(value));
+  result.append(reinterpret_cast<const char *>(&size), sizeof(size));
+  result.append(size, 'x');
+  return result;
+}
+
+static void BM_protocol_decode(benchmark::State &state) {
+  using namespace pf_net::connection::manager;
+  auto size = static_cast<uint32_t>(state.range(0));
+  auto protocol = Interface::protocol_default();
+  auto bytes = bench_packet_bytes(size);
+  connection::Basic connection;
+  if (!bench_connection(connection, protocol)) {
+    state.SkipWithError("connection init failed");
+    return;
+  }
+  auto length = static_cast<uint32_t>(bytes.size());
+  for (auto _ : state) {
+    connection.istream().write(bytes.data(), length);
+    if (!protocol->command(&connection, 1)) {
+      state.SkipWithError("command failed");
+      break;
+    }
+  }
+  state.SetBytesProcessed(state.iterations() * length);
+}
+BENCHMARK(BM_protocol_decode)->Arg(0)->Arg(64)->Arg(1024);
+
+static void BM_protocol_encode(benchmark::State &state) {
+  using namespace pf_net::connection::manager;
+  auto size = static_cast<uint32_t>(state.range(0));
+  auto protocol = Interface::protocol_default();
+  connection::Basic connection;
+  if (!bench_connection(connection, protocol)) {
+    state.SkipWithError("connection init failed");
+    return;
+  }
+  BenchPacket packet;
+  packet.set(1, size);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(protocol->send(&connection, &packet));
+    if (connection.ostream().size() > 32 * 1024)
+      connection.ostream().clear();
+  }
+  state.SetBytesProcessed(state.iterations() * packet.size());
+}
+BENCHMARK(BM_protocol_encode)->Arg(0)->Arg(64)->Arg(1024);
+
+static void BM_factory_create_remove(benchmark::State &state) {
+  for (auto _ : state) {
+    auto packet = NET_PACKET_FACTORYMANAGER_POINTER->packet_create(
+        BENCH_PACKET_ID);
+    benchmark::DoNotOptimize(packet);
+    NET_PACKET_FACTORYMANAGER_POINTER->packet_remove(packet);
+  }
+}
+BENCHMARK(BM_factory_create_remove);
@@ -0,0 +1,155 @@
+#include "env.h"
+#include "pf/net/stream/encryptor.h"
+#include "pf/net/stream/compressor.h"
+
+using namespace pf_net::stream;
+
+static void BM_stream_write_read(benchmark::State &state) {
+  auto size = static_cast<uint32_t>(state.range(0));
+  Input istream(nullptr, 64 * 1024, 64 * 1024);
+  istream.init();
+  std::vector<char> data(size, 'x');
+  std::vector<char> buffer(size);
+  for (auto _ : state) {
+    istream.write(data.data(), size);
+    benchmark::DoNotOptimize(istream.read(buffer.data(), size));
+  }
+  state.SetBytesProcessed(state.iterations() * size);
+}
+BENCHMARK(BM_stream_write_read)->Arg(16)->Arg(256)->Arg(4096);
+
+//The buffer is not the multiple of size, so head and tail wrap around.
+static void BM_stream_wrap(benchmark::State &state) {
+  auto size = static_cast<uint32_t>(state.range(0));
+  Input istream(nullptr, size * 2 + size / 2, size * 2 + size / 2);
+  istream.init();
+  std::vector<char> data(size, 'x');
+  std::vector<char> buffer(size);
+  for (auto _ : state) {
+    istream.write(data.data(), size);
+    benchmark::DoNotOptimize(istream.read(buffer.data(), size));
+  }
+  state.SetBytesProcessed(state.iterations() * size);
+}
+BENCHMARK(BM_stream_wrap)->Arg(256)->Arg(4096);
+
+static void BM_stream_read_pod(benchmark::State &state) {
+  Input istream(nullptr, 64 * 1024, 64 * 1024);
+  istream.init();
+  char data[sizeof(int32_t) + sizeof(uint64_t) + sizeof(uint16_t)]{0};
+  int32_t value1{0};
+  uint64_t value2{0};
+  uint16_t value3{0};
+  for (auto _ : state) {
+    istream.write(data, sizeof(data));
+    istream >> value1 >> value2 >> value3;
+    benchmark::DoNotOptimize(value2);
+  }
+}
+BENCHMARK(BM_stream_read_pod);
+
+static void BM_stream_output_write(benchmark::State &state) {
+  auto size = static_cast<uint32_t>(state.range(0));
+  Output ostream(nullptr, 64 * 1024, 64 * 1024);
+  ostream.init();
+  std::vector<char> data(size, 'x');
+  for (auto _ : state) {
+    ostream.write(data.data(), size);
+    if (ostream.size() > 32 * 1024) ostream.clear();
+  }
+  state.SetBytesProcessed(state.iterations() * size);
+}
+BENCHMARK(BM_stream_output_write)->Arg(16)->Arg(256)->Arg(4096);
+
+static void BM_stream_output_pod(benchmark::State &state) {
+  Output ostream(nullptr, 64 * 1024, 64 * 1024);
+  ostream.init();
+  int32_t value1{1};
+  uint64_t value2{2};
+  uint16_t value3{3};
+  for (auto _ : state) {
+    ostream << value1 << value2 << value3;
+    if (ostream.size() > 32 * 1024) ostream.clear();
+  }
+}
+BENCHMARK(BM_stream_output_pod);
+
+static void BM_encryptor_encrypt(benchmark::State &state) {
+  auto size = static_cast<uint32_t>(state.range(0));
+  Encryptor encryptor;
+  encryptor.setkey("pf_bench_encrypt");
+  encryptor.enable(true);
+  std::vector<char> in(size, 'x');
+  std::vector<char> out(size);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(encryptor.encrypt(out.data(), in.data(), size));
+  }
+  state.SetBytesProcessed(state.iterations() * size);
+}
+BENCHMARK(BM_encryptor_encrypt)->Arg(64)->Arg(1024)->Arg(16 * 1024);
+
+static void BM_encryptor_decrypt(benchmark::State &state) {
+  auto size = static_cast<uint32_t>(state.range(0));
+  Encryptor encryptor;
+  encryptor.setkey("pf_bench_encrypt");
+  encryptor.enable(true);
+  std::vector<char> in(size, 'x');
+  std::vector<char> out(size);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(encryptor.decrypt(out.data(), in.data(), size));
+  }
+  state.SetBytesProcessed(state.iterations() * size);
+}
+BENCHMARK(BM_encryptor_decrypt)->Arg(64)->Arg(1024)->Arg(16 * 1024);
+
+//The compressor only work with the input not less than the IN_SIZE.
+static void compressor_data(std::vector<char> &data) {
+  data.resize(NET_STREAM_COMPRESSOR_IN_SIZE);
+  for (size_t i = 0; i < data.size(); ++i)
+    data[i] = static_cast<char>('a' + (i * 7 % 13));
+}
+
+static void BM_compressor_compress(benchmark::State &state) {
+  std::vector<char> data;
+  compressor_data(data);
+  Compressor compressor;
+  compressor.alloc(NET_STREAM_COMPRESSOR_OUT_SIZE);
+  compressor.getassistant()->enable(true);
+  if (!compressor.getassistant()->isenable()) {
+    state.SkipWithError("compressor not enable");
+    return;
+  }
+  auto size = static_cast<uint32_t>(data.size());
+  uint32_t outsize{0};
+  for (auto _ : state) {
+    compressor.resetposition();
+    benchmark::DoNotOptimize(
+        compressor.compress(data.data(), size, compressor.getheader(), outsize));
+  }
+  state.SetBytesProcessed(state.iterations() * size);
+}
+BENCHMARK(BM_compressor_compress);
+
+static void BM_compressor_decompress(benchmark::State &state) {
+  std::vector<char> data;
+  compressor_data(data);
+  Compressor compressor;
+  compressor.alloc(NET_STREAM_COMPRESSOR_OUT_SIZE);
+  compressor.getassistant()->enable(true);
+  auto size = static_cast<uint32_t>(data.size());
+  uint32_t compress_size{0};
+  if (!compressor.getassistant()->isenable() ||
+      !compressor.compress(
+        data.data(), size, compressor.getheader(), compress_size)) {
+    state.SkipWithError("compress failed");
+    return;
+  }
+  std::vector<char> out(size);
+  for (auto _ : state) {
+    uint32_t outsize{size};
+    benchmark::DoNotOptimize(compressor.decompress(
+          compressor.getbuffer(), compress_size, out.data(), outsize));
+  }
+  state.SetBytesProcessed(state.iterations() * size);
+}
+BENCHMARK(BM_compressor_decompress);
@@ -22,6 +22,8 @@
 #include "pf/basic/type/variable.h"
 #include "pf/basic/base64.h"
 #include "pf/basic/global.h"
+#include "pf/basic/histogram.h"
+#include "pf/basic/trace.h"
 #include "pf/basic/io.tcc"
 #include "pf/basic/logger.h"
 #include "pf/basic/md5.h"
@@ -73,7 +75,9 @@
 
 /* engine */
 #include "pf/engine/application.h"
+#include "pf/engine/event.h"
 #include "pf/engine/kernel.h"
+#include "pf/engine/watchdog.h"
 
 /* file */
 #include "pf/file/api.h"
@@ -84,6 +88,7 @@
 /* net */
 #include "pf/net/connection/basic.h"
 #include "pf/net/connection/pool.h"
+#include "pf/net/connection/limiter.h"
 #include "pf/net/connection/manager/interface.h"
 #include "pf/net/connection/manager/connector.h"
 #include "pf/net/connection/manager/epoll.h"
@@ -92,12 +97,17 @@
 #include "pf/net/connection/manager/connector.h"
 #include "pf/net/connection/manager/listener.h"
 #include "pf/net/connection/manager/listener_factory.h"
+#include "pf/net/metrics.h"
+#include "pf/net/capture.h"
+#include "pf/net/handoff.h"
 #include "pf/net/packet/interface.h"
 #include "pf/net/packet/dynamic.h"
 #include "pf/net/packet/factory.h"
 #include "pf/net/packet/factorymanager.h"
 #include "pf/net/protocol/interface.h"
 #include "pf/net/protocol/basic.h"
+#include "pf/net/protocol/compact.h"
+#include "pf/net/protocol/http.h"
 #include "pf/net/socket/api.h"
 #include "pf/net/socket/listener.h"
 #include "pf/net/socket/basic.h"
@@ -119,6 +129,8 @@
 #include "pf/sys/assert.h"
 #include "pf/sys/process.h"
 #include "pf/sys/thread.h"
+#include "pf/sys/executor.h"
+#include "pf/sys/awaitable.h"
 #include "pf/sys/util.h"
 
 /* util */
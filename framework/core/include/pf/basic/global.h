@@ -17,8 +17,93 @@ namespace pf_basic {
 
 PF_API type::variable_set_t &get_globals();
 
+//The typed handles read the GLOBALS from an immutable snapshot(a pointer load
+//without the map walk and the mutex), call commit after set the GLOBALS.
+namespace config {
+
+//The value converted once(like the variable_t::get).
+struct value_struct {
+  std::string data;
+  int64_t integer;
+  double number;
+  bool boolean;
+  value_struct() : data{""}, integer{0}, number{0.0}, boolean{false} {}
+};
+
+using value_t = value_struct;
+
+//Indexed by the interned names.
+struct snapshot_struct {
+  std::vector<value_t> values;
+};
+
+using snapshot_t = snapshot_struct;
+
+//The index of the name, the snapshot has it after return.
+PF_API size_t intern(const std::string &name);
+
+//Publish the GLOBALS to a new snapshot.
+PF_API void commit();
+
+//The committed value of the name(any thread, not read the GLOBALS), false
+//if not committed.
+PF_API bool find(const std::string &name, value_t &value);
+
+//The current snapshot, not null.
+PF_API const snapshot_t *snapshot();
+
+template <typename T>
+inline T value_cast(const value_t &value) {
+  return static_cast<T>(value.integer);
+}
+
+template <>
+inline bool value_cast<bool>(const value_t &value) {
+  return value.boolean;
+}
+
+template <>
+inline float value_cast<float>(const value_t &value) {
+  return static_cast<float>(value.number);
 }
 
+template <>
+inline double value_cast<double>(const value_t &value) {
+  return value.number;
+}
+
+template <>
+inline std::string value_cast<std::string>(const value_t &value) {
+  return value.data;
+}
+
+//The committed value or the default, not insert like the GLOBALS[name].
+template <typename T>
+inline T get(const std::string &name, const T &_default = T()) {
+  value_t value;
+  return find(name, value) ? value_cast<T>(value) : _default;
+}
+
+//Resolve once, like: static const handle<int32_t> frame{"default.engine.frame"};
+template <typename T>
+class handle {
+
+ public:
+   explicit handle(const std::string &name) : index_{intern(name)} {}
+
+ public:
+   T get() const { return value_cast<T>(snapshot()->values[index_]); }
+   operator T() const { return get(); }
+
+ private:
+   size_t index_;
+
+};
+
+} //namespace config
+
+} //namespace pf_basic
+
 #define GLOBALS pf_basic::get_globals()
 
 #endif //PF_BASIC_GLOBAL_H_
@@ -0,0 +1,128 @@
+/**
+ * PLAIN FRAMEWORK ( https://github.com/viticm/plainframework )
+ * $Id histogram.h
+ * @link https://github.com/viticm/plainframework for the canonical source repository
+ * @copyright Copyright (c) 2014- viticm( viticm.ti@gmail.com )
+ * @license
+ * @user viticm<viticm.ti@gmail.com>
+ * @date 2019/03/23 10:12
+ * @uses The log-linear(HDR style) histogram, each power of two split to
+ *       8 linear buckets(about 12.5% relative error), whole uint64 range.
+ *       只允许一个线程写入（记录时不使用原子加），其他线程可以同时读取并合并。
+ */
+#ifndef PF_BASIC_HISTOGRAM_H_
+#define PF_BASIC_HISTOGRAM_H_
+
+#include "pf/basic/config.h"
+
+#define BASIC_HISTOGRAM_SUB_BITS 3
+#define BASIC_HISTOGRAM_SUB_COUNT (1 << BASIC_HISTOGRAM_SUB_BITS)
+#define BASIC_HISTOGRAM_SIZE \
+  ((64 - BASIC_HISTOGRAM_SUB_BITS + 1) * BASIC_HISTOGRAM_SUB_COUNT)
+
+namespace pf_basic {
+
+class PF_API Histogram {
+
+ public:
+   Histogram() { clear(); };
+   ~Histogram() {};
+
+ public:
+   //Single writer, so the relaxed load and store is enough(no lock prefix).
+   void record(uint64_t value) {
+     add(counts_[index(value)], 1);
+     add(count_, 1);
+     add(sum_, value);
+     if (value > max_.load(std::memory_order_relaxed))
+       max_.store(value, std::memory_order_relaxed);
+   };
+   //Merge other(may be recording in other thread) into this local one.
+   void merge(const Histogram &other) {
+     for (uint32_t i = 0; i < BASIC_HISTOGRAM_SIZE; ++i) {
+       auto value = other.counts_[i].load(std::memory_order_relaxed);
+       if (value != 0) add(counts_[i], value);
+     }
+     add(count_, other.count());
+     add(sum_, other.sum());
+     if (other.maximum() > maximum()) max_.store(other.maximum());
+   };
+   void clear() {
+     for (uint32_t i = 0; i < BASIC_HISTOGRAM_SIZE; ++i) counts_[i] = 0;
+     count_ = 0;
+     sum_ = 0;
+     max_ = 0;
+   };
+   uint64_t count() const { return count_.load(std::memory_order_relaxed); };
+   uint64_t sum() const { return sum_.load(std::memory_order_relaxed); };
+   uint64_t maximum() const { return max_.load(std::memory_order_relaxed); };
+   //The bucket upper bound of the percentile(0.0 - 1.0).
+   uint64_t percentile(double value) const {
+     auto total = count();
+     if (0 == total) return 0;
+     uint64_t rank = static_cast<uint64_t>(value * total + 0.5);
+     if (rank < 1) rank = 1;
+     uint64_t current = 0;
+     for (uint32_t i = 0; i < BASIC_HISTOGRAM_SIZE; ++i) {
+       current += counts_[i].load(std::memory_order_relaxed);
+       if (current >= rank) {
+         auto result = upper(i);
+         return result > maximum() ? maximum() : result;
+       }
+     }
+     return maximum();
+   };
+
+ public:
+   static uint32_t index(uint64_t value) {
+     if (value < BASIC_HISTOGRAM_SUB_COUNT) return static_cast<uint32_t>(value);
+     uint32_t exponent = 63 - static_cast<uint32_t>(clz64(value));
+     uint32_t shift = exponent - BASIC_HISTOGRAM_SUB_BITS;
+     uint32_t sub =
+       static_cast<uint32_t>(value >> shift) & (BASIC_HISTOGRAM_SUB_COUNT - 1);
+     return ((shift + 1) << BASIC_HISTOGRAM_SUB_BITS) + sub;
+   };
+   static uint64_t lower(uint32_t index) {
+     if (index < BASIC_HISTOGRAM_SUB_COUNT) return index;
+     uint32_t shift = (index >> BASIC_HISTOGRAM_SUB_BITS) - 1;
+     uint64_t sub = index & (BASIC_HISTOGRAM_SUB_COUNT - 1);
+     return (BASIC_HISTOGRAM_SUB_COUNT + sub) << shift;
+   };
+   static uint64_t upper(uint32_t index) {
+     if (index + 1 >= BASIC_HISTOGRAM_SIZE) return UINT64_MAX;
+     return lower(index + 1) - 1;
+   };
+
+ private:
+   static void add(std::atomic<uint64_t> &counter, uint64_t value) {
+     counter.store(counter.load(std::memory_order_relaxed) + value,
+                   std::memory_order_relaxed);
+   };
+   static int32_t clz64(uint64_t value) {
+#if defined(__GNUC__)
+     return __builtin_clzll(value);
+#else
+     int32_t result = 0;
+     while (!(value & (1ULL << 63))) {
+       value <<= 1;
+       ++result;
+     }
+     return result;
+#endif
+   };
+
+ private:
+   explicit Histogram(Histogram &);
+   Histogram &operator = (Histogram &);
+
+ private:
+   std::atomic<uint64_t> counts_[BASIC_HISTOGRAM_SIZE];
+   std::atomic<uint64_t> count_;
+   std::atomic<uint64_t> sum_;
+   std::atomic<uint64_t> max_;
+
+};
+
+} //namespace pf_basic
+
+#endif //PF_BASIC_HISTOGRAM_H_
@@ -7,6 +7,17 @@
  * @user viticm<viticm.ti@gmail.com>
  * @date 2016/05/07 14:59
  * @uses server log class
+ *       The logs write to the per thread buffer(one writer, no lock) and the
+ *       logger thread drain them to the files and the console, so the log
+ *       threads never do the file io.
+ *       普通日志在缓冲区满时丢弃并计数（pf_log_dropped_total），警告、错误
+ *       和慢日志等待日志线程写出，不丢弃。
+ *       The binary logs(BINARY_LOG) only save the format pointer and the
+ *       arguments, the logger thread format them or write the .blog file
+ *       (log.binary) for pf_logdecode.
+ *       日志文件写入预分配的内存映射区（log.mapsize），按小时和大小
+ *       （log.rotatesize）滚动，滚动的文件压缩归档（log.compress）并按
+ *       log.keepfiles/log.keepdays 清理。
  */
 #ifndef PF_BASIC_LOGGER_H_
 #define PF_BASIC_LOGGER_H_
@@ -22,6 +33,14 @@ PF_API extern std::mutex g_log_mutex;
 const uint32_t kLogBufferTemp = 4096;
 const uint32_t kLogNameTemp = 128;
 const uint32_t kDefaultLogCacheSize = 1024 * 1024 * 4;
+const uint32_t kLogThreadBufferSize = 1024 * 1024; //Each thread(log.ringsize).
+const uint32_t kLogThreadBufferMin = 64 * 1024;
+const uint32_t kLogFlushInterval = 50; //The logger thread drain(ms).
+const uint8_t kLogRecordBinary = 2; //The record flag of the binary log.
+
+struct log_buffer_struct;
+struct log_file_struct;
+struct log_archiver_struct;
 
 class PF_API Logger : public Singleton<Logger> {
 
@@ -33,15 +52,11 @@ class PF_API Logger : public Singleton<Logger> {
 
  public:
    typedef pf_basic::hashmap::Template< std::string, int32_t > logids_t;
-   typedef pf_basic::hashmap::Template< int32_t, int32_t > log_position_t;
-   typedef pf_basic::hashmap::Template< int32_t, char * > 
-     logcache_t;
-   typedef pf_basic::hashmap::Template< int32_t, std::mutex * > loglock_t;
 
  public:
    bool init(int32_t cache_size = kDefaultLogCacheSize);
+   //Wait the logger thread write all the buffers.
    void flush_log(const char *logname);
-   int32_t get_logsize(uint8_t logid);
    static void get_log_filename(const char *filename_prefix, 
                                 char *filename, 
                                 uint8_t type = 0);
@@ -49,24 +64,107 @@ class PF_API Logger : public Singleton<Logger> {
    static void get_serial(char *serial, int16_t worldid, int16_t serverid);
    static void remove_log(const char *filename);
    static void get_log_timestr(char *time_str, int32_t length);
+   //The buffered bytes not write to file.
+   uint64_t backlog();
+   //The logs dropped for the full buffer.
+   uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
 
  public:
    bool register_fastlog(const char *logname);
+   //The fast log handle(register if not exists), 0 is failed.
+   int32_t get_fastlog_id(const char *logname);
 
  public:
    //模板函数 type 0 普通日志 1 警告日志 2 错误日志 3 调试日志 9 只写日志
    template <uint8_t type>
    void fast_savelog(const char *logname, const char *format, ...);
+   template <uint8_t type>
+   void fast_savelog(int32_t logid, const char *format, ...);
 
    //模板函数 type 0 普通日志 1 警告日志 2 错误日志 3 调试日志 9 只写日志
    template <uint8_t type>
    static void slow_savelog(const char *logname, const char *format, ...);
 
+   //The format must be a string literal(only the pointer saved, formatted
+   //later), the pointer or the char buffer not compile. The arguments: the
+   //numbers, the strings(copied) and the pointers.
+   template <uint8_t type, size_t N, typename... TS>
+   void binary_savelog(const char *logname, 
+                       const char (&format)[N], 
+                       const TS &... args);
+   template <uint8_t type, size_t N, typename... TS>
+   void binary_savelog(int32_t logid, 
+                       const char (&format)[N], 
+                       const TS &... args);
+   template <uint8_t type, size_t N, typename... TS>
+   void binary_savelog(const char *, char (&)[N], const TS &...) = delete;
+   template <uint8_t type, size_t N, typename... TS>
+   void binary_savelog(int32_t, char (&)[N], const TS &...) = delete;
+
+ public:
+   //Format the binary log arguments like printf.
+   static void format_binary(const char *format, 
+                             const char *args, 
+                             size_t size, 
+                             std::string &result);
+   //Decode the .blog file to the text lines.
+   static bool decode_binary(const char *filename, FILE *out);
+
+ private:
+   //Append to current thread buffer, the slow log with the name(logid 0).
+   //The full buffer drop the fast normal logs, wait the others.
+   void push(int32_t logid, 
+             uint8_t type, 
+             const char *name, 
+             const char *text, 
+             size_t length,
+             uint8_t flags = 0);
+   //Write in current thread(no logger).
+   static void savelog(const char *filename_prefix, 
+                       uint8_t type, 
+                       const char *text);
+   log_buffer_struct *buffer();
+   //Wait the logger thread drain count times, false if can't(stopped or 
+   //in the logger thread).
+   bool wait_drain(uint64_t count);
+   void start();
+   void run();
+   void drain();
+   void write(log_buffer_struct *buffer, const char *record);
+   void flush_files();
+   //Roll over the file over the size(X.log.N).
+   void rotate(log_file_struct *file);
+   //Compress the closed file in the archiver thread.
+   void archive(const std::string &filename);
+   //Remove the log files of the directory(log.clear).
+   static void clear_logs(const char *directory);
+   bool write_binary(log_file_struct *file, 
+                     log_buffer_struct *buffer, 
+                     const char *record, 
+                     int64_t runtime);
+   static void atfork_prepare();
+   static void atfork_parent();
+   static void atfork_child();
+
  private:
    logids_t logids_;
-   log_position_t log_position_;
-   logcache_t logcache_;
-   loglock_t loglock_;
+   std::vector<std::string> lognames_; //Index by the logid.
+   std::mutex logid_mutex_; //The ids.
+   std::mutex mutex_; //The buffers list(not held in the file io).
+   std::mutex drain_mutex_; //The drain(the fork wait it).
+   std::list< std::unique_ptr<log_buffer_struct> > buffers_;
+   std::map< std::string, std::unique_ptr<log_file_struct> > files_;
+   std::unique_ptr<log_archiver_struct> archiver_;
+   std::unique_ptr<std::thread> thread_; //Start with the first log.
+   std::atomic<bool> running_;
+   std::mutex thread_mutex_;
+   std::condition_variable condition_;
+   std::condition_variable flushed_;
+   bool stop_;
+   uint64_t drained_; //The drain count.
+   std::atomic<bool> wakeup_;
+   std::atomic<uint64_t> dropped_;
+   uint64_t start_; //The start time of the time manager(ms).
    int32_t cache_size_;
 
 };
@@ -87,6 +185,11 @@ extern std::unique_ptr< pf_basic::Logger > g_logger;
 #define SLOW_ERRORLOG pf_basic::Logger::slow_savelog<2>
 #define SLOW_DEBUGLOG pf_basic::Logger::slow_savelog<3> 
 #define SLOW_WRITELOG pf_basic::Logger::slow_savelog<9>
+#define BINARY_LOG LOGSYSTEM_POINTER->binary_savelog<0>
+#define BINARY_WARNINGLOG LOGSYSTEM_POINTER->binary_savelog<1>
+#define BINARY_ERRORLOG LOGSYSTEM_POINTER->binary_savelog<2>
+#define BINARY_DEBUGLOG LOGSYSTEM_POINTER->binary_savelog<3>
+#define BINARY_WRITELOG LOGSYSTEM_POINTER->binary_savelog<9>
 
 #if OS_UNIX
 #define SaveErrorLog() (SLOW_ERRORLOG( \
@@ -19,122 +19,206 @@
 
 namespace pf_basic {
 
+//Read on every log, so the config handles.
+struct log_config_struct {
+  config::handle<bool> fast{"log.fast"};
+  config::handle<bool> print{"log.print"};
+  config::handle<bool> active{"log.active"};
+  config::handle<bool> singlefile{"log.singlefile"};
+  config::handle<bool> binary{"log.binary"};
+};
+
+inline const log_config_struct &log_config() {
+  static const log_config_struct config;
+  return config;
+}
+
 template <uint8_t type>
 void Logger::fast_savelog(const char *logname, const char *format, ...) {
-  if (!logids_.isfind(logname) && !register_fastlog(logname)) {
-    return;
-  }
-  uint8_t logid = static_cast<uint8_t>(logids_.get(logname));
-  char *cache = logcache_.get(logid);
-  if (is_null(cache)) return;
-  auto mutex = loglock_.get(logid);
-  if (is_null(mutex)) return;
-  uint32_t position = log_position_.get(logid);
-  char buffer[4096]{0};
-  char temp[4096]{0};
+  if (!log_config().active.get() && !log_config().print.get()) return;
+  char buffer[kLogBufferTemp];
   va_list argptr;
-  try {
-    va_start(argptr, format);
-    vsnprintf(temp, sizeof(temp) - 1, format, argptr);
-    va_end(argptr);
-    if (GLOBALS["log.fast"] == false) { //disable fast log.
-      char log_filename[FILENAME_MAX]{0};
-      get_log_filename(logname, log_filename);
-      slow_savelog<type>(log_filename, temp);
-      return;
-    }
-    char time_str[256]{0};
-    get_log_timestr(time_str, sizeof(time_str) - 1);
-    snprintf(buffer, sizeof(buffer) - 1,"%s %s", time_str, temp);
-  } catch(...) {
-    Assert(false);
+  va_start(argptr, format);
+  auto length = vsnprintf(buffer, sizeof(buffer), format, argptr);
+  va_end(argptr);
+  if (length < 0) return;
+  if (length >= static_cast<int32_t>(sizeof(buffer))) 
+    length = sizeof(buffer) - 1;
+  if (!log_config().fast.get()) { //disable fast log.
+    push(0, type, logname, buffer, length);
     return;
   }
-  if (GLOBALS["log.print"] == true) {
-    switch (type) {
-    case 1:
-      io_cwarn(buffer);
-      break;
-    case 2:
-      io_cerr(buffer);
-      break;
-    case 3:
-      io_cdebug(buffer);
-      break;
-    case 9:
-      break;
-    default:
-      printf("%s" LF "", buffer);
-      break;
-    }
-  }
-  strncat(buffer, LF, sizeof(LF)); //add wrap
-  if (GLOBALS["log.active"] == false) return; //save log condition
-  int32_t length = static_cast<int32_t>(strlen(buffer));
-  if (length <= 0 || length + position > kDefaultLogCacheSize) return;
-  if (GLOBALS["log.singlefile"] == true) {
-    //do nothing(one log file is not active now)
-  }
-  {
-    std::unique_lock<std::mutex> autolock(*mutex);
-    try {
-      memcpy(cache + position, buffer, length);
-    } catch(...) {
-    //do nogthing
-    }
-    log_position_.set(logid, position + length);
-  }
-  if (position + length > (kDefaultLogCacheSize * 2) / 3) {
-    flush_log(logname);
-  }
+  auto logid = get_fastlog_id(logname);
+  if (0 == logid) return;
+  push(logid, type, nullptr, buffer, length);
+}
+
+template <uint8_t type>
+void Logger::fast_savelog(int32_t logid, const char *format, ...) {
+  if (!log_config().active.get() && !log_config().print.get()) return;
+  char buffer[kLogBufferTemp];
+  va_list argptr;
+  va_start(argptr, format);
+  auto length = vsnprintf(buffer, sizeof(buffer), format, argptr);
+  va_end(argptr);
+  if (length < 0) return;
+  if (length >= static_cast<int32_t>(sizeof(buffer))) 
+    length = sizeof(buffer) - 1;
+  push(logid, type, nullptr, buffer, length);
 }
 
 //模板函数 type 0 普通日志 1 警告日志 2 错误日志 3 调试日志 9 只写日志
 template <uint8_t type>
 void Logger::slow_savelog(const char *filename_prefix, 
     const char *format, ...) {
-  std::unique_lock<std::mutex> autolock(g_log_mutex);
-  char buffer[4096]{0};
-  char temp[4096]{0};
+  if (!log_config().active.get() && !log_config().print.get()) return;
+  char buffer[kLogBufferTemp];
   va_list argptr;
-  try {
-    va_start(argptr, format);
-    vsnprintf(temp, sizeof(temp) - 1, format, argptr);
-    va_end(argptr);
-    char time_str[256]{0};
-    get_log_timestr(time_str, sizeof(time_str) - 1);
-    snprintf(buffer, sizeof(buffer) - 1,"%s %s", time_str, temp);
-
-    if (GLOBALS["log.print"] == true) {
-      switch (type) {
-        case 1:
-        io_cwarn(buffer);
-        break;
-        case 2:
-        io_cerr(buffer);
-        break;
-        case 3:
-        io_cdebug(buffer);
-        break;
-        case 9:
-        break;
-        default:
-        printf("%s" LF "", buffer);
-      }
+  va_start(argptr, format);
+  auto length = vsnprintf(buffer, sizeof(buffer), format, argptr);
+  va_end(argptr);
+  if (length < 0) return;
+  if (length >= static_cast<int32_t>(sizeof(buffer))) 
+    length = sizeof(buffer) - 1;
+  auto logger = getsingleton_pointer();
+  if (!is_null(logger)) {
+    logger->push(0, type, filename_prefix, buffer, length);
+  } else {
+    savelog(filename_prefix, type, buffer);
+  }
+}
+
+namespace log_binary {
+
+//The argument tags(1 byte), the numbers 8 bytes and the strings with the 
+//2 bytes length.
+enum {
+  kArgInt = 1,
+  kArgUint,
+  kArgDouble,
+  kArgChar,
+  kArgString,
+  kArgPointer,
+};
+
+struct writer_struct {
+  char *data;
+  size_t size;
+  size_t capacity;
+  void put(uint8_t tag, const void *value, size_t length) {
+    if (size + 1 + length > capacity) {
+      size = capacity; //The left arguments not save.
+      return;
     }
-    strncat(buffer, LF, sizeof(LF)); //add wrap
-    if (GLOBALS["log.active"] == 0) return;
-    char log_filename[FILENAME_MAX]{0};
-    get_log_filename(filename_prefix, log_filename, type);
-    FILE* fp;
-    fp = fopen(log_filename, "ab");
-    if (fp) {
-      fwrite(buffer, 1, strlen(buffer), fp);
-      fclose(fp);
+    data[size] = static_cast<char>(tag);
+    memcpy(data + size + 1, value, length);
+    size += 1 + length;
+  }
+  void put_string(const char *value, size_t length) {
+    if (size + 3 > capacity) {
+      size = capacity;
+      return;
     }
-  } catch(...) {
-    io_cerr("pf_basic::Logger::save_log have some log error in here" LF "");
+    if (length > capacity - size - 3) length = capacity - size - 3;
+    if (length > 0xffff) length = 0xffff;
+    uint16_t length16 = static_cast<uint16_t>(length);
+    data[size] = static_cast<char>(kArgString);
+    memcpy(data + size + 1, &length16, sizeof(length16));
+    memcpy(data + size + 3, value, length);
+    size += 3 + length;
   }
+};
+
+using writer_t = writer_struct;
+
+template <typename T>
+void put_number(writer_t &writer, T value, std::true_type) { //floating
+  double number = static_cast<double>(value);
+  writer.put(kArgDouble, &number, sizeof(number));
+}
+
+template <typename T>
+void put_number(writer_t &writer, T value, std::false_type) {
+  if (std::is_same<T, char>::value) {
+    int64_t number = static_cast<int64_t>(value);
+    writer.put(kArgChar, &number, sizeof(number));
+  } else if (std::is_signed<T>::value) {
+    int64_t number = static_cast<int64_t>(value);
+    writer.put(kArgInt, &number, sizeof(number));
+  } else {
+    uint64_t number = static_cast<uint64_t>(value);
+    writer.put(kArgUint, &number, sizeof(number));
+  }
+}
+
+template <typename T>
+typename std::enable_if<std::is_arithmetic<T>::value>::type
+encode(writer_t &writer, const T &value) {
+  put_number(writer, value, std::is_floating_point<T>());
+}
+
+template <typename T>
+typename std::enable_if<std::is_enum<T>::value>::type
+encode(writer_t &writer, const T &value) {
+  int64_t number = static_cast<int64_t>(value);
+  writer.put(kArgInt, &number, sizeof(number));
+}
+
+inline void encode(writer_t &writer, const char *value) {
+  if (is_null(value)) value = "(null)";
+  writer.put_string(value, strlen(value));
+}
+
+inline void encode(writer_t &writer, const std::string &value) {
+  writer.put_string(value.data(), value.size());
+}
+
+template <typename T>
+void encode(writer_t &writer, const T *value) {
+  uint64_t pointer = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(value));
+  writer.put(kArgPointer, &pointer, sizeof(pointer));
+}
+
+inline void encode_all(writer_t &) {}
+
+template <typename T, typename... TS>
+void encode_all(writer_t &writer, const T &value, const TS &... args) {
+  encode(writer, value);
+  encode_all(writer, args...);
+}
+
+} //namespace log_binary
+
+template <uint8_t type, size_t N, typename... TS>
+void Logger::binary_savelog(const char *logname, 
+                            const char (&format)[N], 
+                            const TS &... args) {
+  if (!log_config().active.get() && !log_config().print.get()) return;
+  if (!log_config().fast.get()) {
+    const char *pointer = format;
+    char buffer[kLogBufferTemp];
+    log_binary::writer_t writer{buffer, sizeof(pointer), sizeof(buffer)};
+    memcpy(buffer, &pointer, sizeof(pointer));
+    log_binary::encode_all(writer, args...);
+    push(0, type, logname, buffer, writer.size, kLogRecordBinary);
+    return;
+  }
+  binary_savelog<type>(get_fastlog_id(logname), format, args...);
+}
+
+template <uint8_t type, size_t N, typename... TS>
+void Logger::binary_savelog(int32_t logid, 
+                            const char (&format)[N], 
+                            const TS &... args) {
+  if (!log_config().active.get() && !log_config().print.get()) return;
+  if (0 == logid) return;
+  //No formatting here, the pointer of the format and the raw arguments.
+  const char *pointer = format;
+  char buffer[kLogBufferTemp];
+  log_binary::writer_t writer{buffer, sizeof(pointer), sizeof(buffer)};
+  memcpy(buffer, &pointer, sizeof(pointer));
+  log_binary::encode_all(writer, args...);
+  push(logid, type, nullptr, buffer, writer.size, kLogRecordBinary);
 }
 
 } //namespace pf_basic;
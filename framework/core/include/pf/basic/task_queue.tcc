@@ -7,6 +7,10 @@
  * @user viticm<viticm.ti@gmail.com>
  * @date 2017/05/10 11:23
  * @uses The task queue for single thread.
+ *       Multi producer and single consumer, the producers claim the slot of
+ *       the ring without lock, the small callable construct in the slot(no
+ *       allocation). The ring full use the overflow list with lock.
+ *       消费线程按预算批量执行（drain），空闲时入队会唤醒（set_wakeup/wait）。
 */
 #ifndef PF_BASIC_TASK_QUEUE_TCC_
 #define PF_BASIC_TASK_QUEUE_TCC_
@@ -15,60 +19,257 @@
 
 namespace pf_basic {
 
+const uint32_t kTaskQueueCapacity = 1024; //The ring slots(power of 2).
+const size_t kTaskQueueInlineSize = 48; //The callable size store in slot.
+
 class TaskQueue {
 
  public:
-   TaskQueue() : stop_{false} {};
+   explicit TaskQueue(uint32_t capacity = kTaskQueueCapacity) :
+     mask_{0},
+     enqueue_position_{0},
+     dequeue_position_{0},
+     overflow_size_{0},
+     signaled_{false},
+     stop_{false} {
+     size_t size{2};
+     while (size < capacity) size <<= 1;
+     mask_ = size - 1;
+     slots_.reset(new slot_t[size]);
+     for (size_t i = 0; i < size; ++i)
+       slots_[i].sequence.store(i, std::memory_order_relaxed);
+   };
    ~TaskQueue() {
-     {
-       std::unique_lock<std::mutex> lock(queue_mutex_);
-       stop_ = true;
-     }
+     stop_ = true;
      work_all();
    };
 
  public:
    template<class F, class... Args>
-   auto enqueue(F&& f, Args&&... args) 
+   auto enqueue(F&& f, Args&&... args)
      -> std::future<typename std::result_of<F(Args...)>::type> {
      using return_type = typename std::result_of<F(Args...)>::type;
      auto task = std::make_shared< std::packaged_task<return_type()> >(
          std::bind(std::forward<F>(f), std::forward<Args>(args)...)
        );
      std::future<return_type> res = task->get_future();
-     {
-       std::unique_lock<std::mutex> lock(queue_mutex_);
+     //Don't allow enqueueing after stopping the TaskQueue
+     if (!post([task](){ (*task)(); }))
+       throw std::runtime_error("enqueue on stopped TaskQueue");
+     return res;
+   }
 
-       //Don't allow enqueueing after stopping the TaskQueue
-       if (stop_)
-         throw std::runtime_error("enqueue on stopped TaskQueue");
-       tasks_.emplace([task](){ (*task)(); });
+   //Not need the result, false if stopped.
+   template <class F>
+   bool post(F &&f) {
+     using function_t = typename std::decay<F>::type;
+     if (stop_) return false;
+     size_t position{0};
+     //Keep the order of the producer, not use the ring if has overflow.
+     auto slot = 0 == overflow_size_.load(std::memory_order_acquire) ?
+                 claim(position) : nullptr;
+     if (slot) {
+       try {
+         construct<function_t>(
+             slot,
+             std::forward<F>(f),
+             std::integral_constant<bool,
+               sizeof(function_t) <= sizeof(storage_t) &&
+               alignof(function_t) <= alignof(storage_t)>());
+       } catch(...) {
+         slot->call = &call_none;
+         slot->sequence.store(position + 1, std::memory_order_release);
+         throw;
+       }
+       slot->sequence.store(position + 1, std::memory_order_release);
+     } else {
+       auto pointer = std::make_shared<function_t>(std::forward<F>(f));
+       std::unique_lock<std::mutex> lock(mutex_);
+       overflow_.emplace_back([pointer](){ (*pointer)(); });
+       overflow_size_.fetch_add(1, std::memory_order_release);
      }
-     return res;
+     signal();
+     return true;
    }
 
  public:
-   void work_one() {
-     std::function<void()> task;
-     {
-       std::unique_lock<std::mutex> lock(queue_mutex_);
-       if (tasks_.empty()) return;
-       task = std::move(tasks_.front());
-       tasks_.pop();
+   //Run the tasks not more than the budget(0 is no limit) in the consumer
+   //thread, return the count. The tasks left wakeup again.
+   uint32_t drain(uint32_t budget = 0) {
+     if (0 == budget) budget = UINT32_MAX;
+     signaled_.store(false);
+     std::atomic_thread_fence(std::memory_order_seq_cst);
+     uint32_t count{0};
+     while (count < budget) {
+       if (run_one()) {
+         ++count;
+         continue;
+       }
+       if (0 == overflow_size_.load(std::memory_order_acquire)) break;
+       std::function<void()> task;
+       {
+         std::unique_lock<std::mutex> lock(mutex_);
+         if (overflow_.empty()) break;
+         task = std::move(overflow_.front());
+         overflow_.pop_front();
+         overflow_size_.fetch_sub(1, std::memory_order_release);
+       }
+       ++count;
+       task();
      }
-     task();
+     if (count == budget && ready()) signal();
+     return count;
+   };
+   void work_one() {
+     drain(1);
    };
    void work_all() {
-     while (!tasks_.empty()) work_one();
+     drain(0);
+   };
+
+   //Wait in the consumer thread until has task or the time point, return
+   //true if has task.
+   bool wait_until(const std::chrono::steady_clock::time_point &point) {
+     signaled_.store(false);
+     std::atomic_thread_fence(std::memory_order_seq_cst);
+     std::unique_lock<std::mutex> lock(mutex_);
+     condition_.wait_until(lock, point, [this](){ return ready() || stop_; });
+     return ready();
+   };
+   bool wait_for(uint32_t milliseconds) {
+     return wait_until(std::chrono::steady_clock::now() +
+                       std::chrono::milliseconds(milliseconds));
+   };
+
+   //The function call in the producer thread when enqueue to the idle queue,
+   //can't enqueue in it.
+   void set_wakeup(const std::function<void()> &function) {
+     std::unique_lock<std::mutex> lock(mutex_);
+     wakeup_ = function;
+   };
+
+   //The tasks not run(approximate if the producers running).
+   size_t size() const {
+     auto enqueue_position = enqueue_position_.load(std::memory_order_relaxed);
+     auto dequeue_position = dequeue_position_.load(std::memory_order_relaxed);
+     auto count = enqueue_position > dequeue_position ?
+                  enqueue_position - dequeue_position : 0;
+     return count + overflow_size_.load(std::memory_order_relaxed);
+   };
+   bool empty() const { return 0 == size(); };
+
+ private:
+   using storage_t =
+     typename std::aligned_storage<kTaskQueueInlineSize>::type;
+   struct slot_struct {
+     std::atomic<size_t> sequence;
+     void (*call)(void *storage, bool run); //Run(or not) and destroy.
+     storage_t storage;
+   };
+   using slot_t = slot_struct;
+
+   //Release the slot for the producers after run.
+   struct release_struct {
+     slot_t *slot;
+     size_t sequence;
+     ~release_struct() {
+       slot->sequence.store(sequence, std::memory_order_release);
+     };
+   };
+
+ private:
+   template <class T>
+   static void call_inline(void *storage, bool run) {
+     struct destroy_struct {
+       T *function;
+       ~destroy_struct() { function->~T(); };
+     } destroy{static_cast<T *>(storage)};
+     if (run) (*destroy.function)();
+   };
+   template <class T>
+   static void call_heap(void *storage, bool run) {
+     std::unique_ptr<T> function{*static_cast<T **>(storage)};
+     if (run) (*function)();
+   };
+   static void call_none(void *, bool) {};
+   template <class T, class F>
+   static void construct(slot_t *slot, F &&f, std::true_type) {
+     new (&slot->storage) T(std::forward<F>(f));
+     slot->call = &call_inline<T>;
+   };
+   template <class T, class F>
+   static void construct(slot_t *slot, F &&f, std::false_type) {
+     auto function = new T(std::forward<F>(f));
+     *reinterpret_cast<T **>(&slot->storage) = function;
+     slot->call = &call_heap<T>;
+   };
+
+   //Claim the slot of the position, nullptr if full.
+   slot_t *claim(size_t &position) {
+     position = enqueue_position_.load(std::memory_order_relaxed);
+     for (;;) {
+       auto slot = &slots_[position & mask_];
+       auto sequence = slot->sequence.load(std::memory_order_acquire);
+       auto diff =
+         static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+       if (0 == diff) {
+         if (enqueue_position_.compare_exchange_weak(
+               position, position + 1, std::memory_order_relaxed))
+           return slot;
+       } else if (diff < 0) {
+         return nullptr;
+       } else {
+         position = enqueue_position_.load(std::memory_order_relaxed);
+       }
+     }
+   };
+
+   //The consumer position move first, so the task can drain again.
+   bool run_one() {
+     auto position = dequeue_position_.load(std::memory_order_relaxed);
+     auto slot = &slots_[position & mask_];
+     if (slot->sequence.load(std::memory_order_acquire) != position + 1)
+       return false;
+     dequeue_position_.store(position + 1, std::memory_order_relaxed);
+     release_struct release{slot, position + mask_ + 1};
+     slot->call(&slot->storage, true);
+     return true;
+   };
+
+   bool ready() const {
+     auto position = dequeue_position_.load(std::memory_order_relaxed);
+     auto &slot = slots_[position & mask_];
+     return slot.sequence.load(std::memory_order_acquire) == position + 1 ||
+            overflow_size_.load(std::memory_order_acquire) > 0;
+   };
+
+   //Wakeup once until the consumer drain.
+   void signal() {
+     std::atomic_thread_fence(std::memory_order_seq_cst);
+     if (signaled_.load(std::memory_order_relaxed) || signaled_.exchange(true))
+       return;
+     std::unique_lock<std::mutex> lock(mutex_);
+     if (wakeup_) wakeup_();
+     condition_.notify_one();
    };
 
  private:
-   //The task queue
-   std::queue< std::function<void()> > tasks_;
-   //Synchronization
-   std::mutex queue_mutex_;
+   std::unique_ptr<slot_t[]> slots_;
+   size_t mask_;
+   char padding0_[64];
+   std::atomic<size_t> enqueue_position_;
+   char padding1_[64];
+   std::atomic<size_t> dequeue_position_;
+   char padding2_[64];
+   std::atomic<size_t> overflow_size_;
+   std::atomic<bool> signaled_;
+   //The overflow list, wakeup and wait.
+   std::mutex mutex_;
+   std::condition_variable condition_;
+   std::deque< std::function<void()> > overflow_;
+   std::function<void()> wakeup_;
    //Stop flag
-   bool stop_;
+   std::atomic<bool> stop_;
 
 };
 
@@ -7,6 +7,9 @@
  * @user viticm<viticm@126.com>
  * @date 2014/06/18 15:53
  * @uses the base time manager class
+ *       The tick count is the coarse monotonic clock(64 bits ms from the 
+ *       init, never wrap and not changed by the wall clock), the nano time
+ *       for the latency and the wall clock string cached per second.
  */
 #ifndef PF_BASIC_TIME_MANAGER_H_
 #define PF_BASIC_TIME_MANAGER_H_
@@ -27,20 +30,24 @@ class PF_API TimeManager : public Singleton<TimeManager> {
  public:
    TimeManager();
    ~TimeManager();
-   uint32_t start_time_;
-   uint32_t current_time_;
+   uint64_t start_time_; //The monotonic clock of the init(ms).
+   std::atomic<uint64_t> current_time_; //The last tick count.
    time_t set_time_;
    tm tm_;
-#if OS_UNIX
-   struct timeval start_, end_;
-   struct timezone time_zone_;
-#endif
 
  public:
    bool init();
-   uint32_t get_tickcount(); //获取从程序启动到现在经历的时间(ms)
-   uint32_t get_saved_time() const;
-   uint32_t get_start_time() const;
+   uint64_t get_tickcount(); //获取从程序启动到现在经历的时间(ms)
+   //The tick count cached by the last tick(no clock read).
+   uint64_t get_saved_time() const;
+   uint64_t get_start_time() const;
+   //The monotonic clock(ns), for the latency.
+   static uint64_t get_nanotime();
+   //Cache the tick count and the time(the engine loop each frame).
+   void tick();
+   //The wall clock like "2013-11-29 15:38:09", formatted once a second 
+   //in each thread.
+   static const char *get_wallclock_str();
    static TimeManager &getsingleton();
    static TimeManager *getsingleton_pointer();
    void reset_time();
@@ -62,7 +69,7 @@ class PF_API TimeManager : public Singleton<TimeManager> {
    uint32_t diff_dword_time(uint32_t time1, uint32_t time2);
    int32_t diff_day_count(time_t ansi_time1, time_t ansi_time2);
    uint32_t get_day_time(); //20131129
-   uint32_t get_run_time();
+   uint64_t get_run_time();
    uint32_t get_current_time();
    uint32_t diff_time(uint32_t time1, uint32_t time2); //两个时间的差值，毫秒
    void time_totm(uint32_t time, tm *_tm);
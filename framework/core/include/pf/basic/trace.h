@@ -0,0 +1,118 @@
+/**
+ * PLAIN FRAMEWORK ( https://github.com/viticm/plainframework )
+ * $Id trace.h
+ * @link https://github.com/viticm/plainframework for the canonical source repository
+ * @copyright Copyright (c) 2014- viticm( viticm.ti@gmail.com )
+ * @license
+ * @user viticm<viticm.ti@gmail.com>
+ * @date 2019/04/18 10:36
+ * @uses The scoped spans record to the per thread ring buffer(only the owner
+ *       thread write, no lock), dump as the chrome trace event json(open in
+ *       the perfetto or chrome://tracing).
+ *       默认关闭（只检查一次开关），缓冲区满后覆盖最旧的记录，名称必须是
+ *       常量字符串（只保存指针）。
+ */
+#ifndef PF_BASIC_TRACE_H_
+#define PF_BASIC_TRACE_H_
+
+#include "pf/basic/config.h"
+#include "pf/basic/time_manager.h"
+
+#define BASIC_TRACE_BUFFER_SIZE (8192) //The events each thread(power of 2).
+#define BASIC_TRACE_ARG_NONE INT64_MIN
+
+namespace pf_basic {
+
+namespace trace {
+
+struct event_struct {
+  const char *category;
+  const char *name;
+  int64_t arg;
+  uint64_t begin;    //ns.
+  uint64_t duration; //ns.
+};
+
+using event_t = event_struct;
+
+PF_API bool enable();
+PF_API void set_enable(bool flag);
+
+//The thread name in the trace(pf_sys::thread::bind set it).
+PF_API void set_thread_name(const std::string &name);
+
+//Record the complete event in current thread.
+PF_API void record(const char *category,
+                   const char *name,
+                   int64_t arg,
+                   uint64_t begin,
+                   uint64_t duration);
+
+//The json of all threads events.
+PF_API void dump(std::string &content);
+PF_API bool save(const std::string &filename);
+
+//Drop the recorded events.
+PF_API void clear();
+
+//The current thread id in the trace(0 if not enabled).
+PF_API uint32_t thread_id();
+
+//The innermost open span("category/name") of the thread, "" if none.
+PF_API std::string current_span(uint32_t tid);
+
+//Open the span in current thread, return the last(close restore it).
+PF_API std::pair<const char *, const char *> open(const char *category,
+                                                  const char *name);
+PF_API void close(const std::pair<const char *, const char *> &last);
+
+//The monotonic time(ns).
+inline uint64_t now() {
+  return TimeManager::get_nanotime();
+}
+
+class Span {
+
+ public:
+   Span(const char *category,
+        const char *name,
+        int64_t arg = BASIC_TRACE_ARG_NONE) :
+     category_{category},
+     name_{name},
+     arg_{arg},
+     begin_{0},
+     last_{nullptr, nullptr} {
+     if (!enable()) return;
+     last_ = open(category, name);
+     begin_ = now();
+   }
+   ~Span() {
+     if (0 == begin_) return;
+     record(category_, name_, arg_, begin_, now() - begin_);
+     close(last_);
+   }
+
+ private:
+   const char *category_;
+   const char *name_;
+   int64_t arg_;
+   uint64_t begin_;
+   std::pair<const char *, const char *> last_;
+
+};
+
+} //namespace trace
+
+} //namespace pf_basic
+
+#define TRACE_CONCAT_IMPL(a,b) a##b
+#define TRACE_CONCAT(a,b) TRACE_CONCAT_IMPL(a,b)
+
+//The span to the end of the scope.
+#define TRACE_SCOPE(category,name) \
+  pf_basic::trace::Span TRACE_CONCAT(__trace_span_, __LINE__)(category, name)
+#define TRACE_SCOPE_ARG(category,name,arg) \
+  pf_basic::trace::Span TRACE_CONCAT(__trace_span_, __LINE__)( \
+      category, name, static_cast<int64_t>(arg))
+
+#endif //PF_BASIC_TRACE_H_
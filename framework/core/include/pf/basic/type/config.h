@@ -42,6 +42,13 @@ typedef enum {
   kVariableTypeNumber,
 } var_t; //变量的类型
 
+typedef enum {
+  kVariableStoreString = 0,
+  kVariableStoreInt64,
+  kVariableStoreUint64,
+  kVariableStoreDouble,
+} var_store_t; //变量的实际存储（类型只是声明）
+
 } //namespace type
 
 } //namespace pf_basic
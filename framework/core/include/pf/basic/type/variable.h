@@ -7,7 +7,10 @@
  * @user viticm<viticm.ti@gmail.com>
  * @date 2016/05/05 20:31
  * @uses Base module the variable type(like script variables).
- *       Base on string, also can do string convert to diffrent type.
+ *       Base on string, also can do string convert to diffrent type, the
+ *       number also cached inline so the get not parse the string.
+ *       The reads not change the value, but the writes not locked, the
+ *       shared values like GLOBALS read by pf_basic::config handles.
  *       Refer: php/lua or more script codes.
 */
 #ifndef PF_BASIC_TYPE_VARIABLE_H_
@@ -24,11 +27,17 @@ var_t std_convert_type(T);
 
 struct PF_API variable_struct {
   var_t type;
-  std::string data;
-  mutable std::mutex mutex;
-  variable_struct() : type{kVariableTypeInvalid}, data{""} {}
+  std::string data; //The string form(read only, write by the operators).
+
+  variable_struct() : 
+    type{kVariableTypeInvalid}, 
+    data{""},
+    store_{kVariableStoreString} {
+    value_.integer = 0;
+  }
 
   variable_struct(const variable_t &object); 
+  variable_struct(variable_t &&object);
   variable_struct(const variable_t *object);
   variable_struct(const std::string &value);
   variable_struct(const char *value);
@@ -38,10 +47,13 @@ struct PF_API variable_struct {
   template <typename T>
   T get() const; 
   template <typename T>
-  T _get() const; //Not safe in multi threads.
-  const char *c_str() const;
+  T _get() const; //Same as get(the old no lock version).
+  const char *c_str() const { return data.c_str(); }
+  size_t size() const { return data.size(); }
+  var_store_t store() const { return static_cast<var_store_t>(store_); }
 
   variable_t &operator = (const variable_t &object);
+  variable_t &operator = (variable_t &&object);
   variable_t *operator = (const variable_t *object);
   variable_t &operator = (const std::string &value);
   variable_t &operator = (const char *value);
@@ -109,6 +121,20 @@ struct PF_API variable_struct {
   template <typename T>
   operator T();
 
+ private:
+   template <typename T>
+   void set_number(T value);
+   int64_t get_integer() const;
+   double get_number() const;
+
+ private:
+   uint8_t store_;
+   union {
+     int64_t integer;
+     uint64_t unsigned_integer;
+     double number; //The value of the string form(std::to_string).
+   } value_;
+
 }; //PF变量，类似脚本变量
 
 } //namespace type
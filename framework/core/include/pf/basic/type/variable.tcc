@@ -33,24 +33,29 @@ var_t std_convert_type(T) {
   return kVariableTypeString; //Default is string.
 }
 
-inline variable_struct::variable_struct(const variable_t &object) {
-  data = object.data;
-  type = object.type;
+inline variable_struct::variable_struct(const variable_t &object) :
+  variable_struct() {
+  *this = object;
+}
+
+inline variable_struct::variable_struct(variable_t &&object) :
+  variable_struct() {
+  *this = std::move(object);
 }
   
-inline variable_struct::variable_struct(const variable_t *object) {
-  if (object) {
-    data = object->data;
-    type = object->type;
-  }
+inline variable_struct::variable_struct(const variable_t *object) :
+  variable_struct() {
+  if (object) *this = *object;
 }
 
-inline variable_struct::variable_struct(const std::string &value) {
+inline variable_struct::variable_struct(const std::string &value) :
+  variable_struct() {
   type = kVariableTypeString;
   data = value;
 }
 
-inline variable_struct::variable_struct(const char *value) {
+inline variable_struct::variable_struct(const char *value) :
+  variable_struct() {
   if (value) {
     type = kVariableTypeString;
     data = value;
@@ -58,24 +63,61 @@ inline variable_struct::variable_struct(const char *value) {
 }
   
 template <typename T>
-inline variable_struct::variable_struct(T value) {
+inline variable_struct::variable_struct(T value) : variable_struct() {
   type = std_convert_type(value);
+  set_number(value);
+}
+
+//The cache is the value read from the string form, so the get same as the
+//string(the double rounded by "%f" and the integer saturated by strtoll).
+template <typename T>
+inline void variable_struct::set_number(T value) {
   data = std::to_string(value);
+  if (std::is_floating_point<T>::value) {
+    store_ = kVariableStoreDouble;
+    value_.number = atof(data.c_str());
+  } else if (std::is_unsigned<T>::value) {
+    store_ = kVariableStoreUint64;
+    value_.unsigned_integer = static_cast<uint64_t>(value);
+  } else {
+    store_ = kVariableStoreInt64;
+    value_.integer = static_cast<int64_t>(value);
+  }
+}
+
+inline int64_t variable_struct::get_integer() const {
+  switch (store_) {
+    case kVariableStoreInt64:
+      return value_.integer;
+    case kVariableStoreUint64:
+      return value_.unsigned_integer > INT64_MAX ? 
+             INT64_MAX : static_cast<int64_t>(value_.unsigned_integer);
+    default:
+      break;
+  }
+  char *endpointer = nullptr;
+  return strtoint64(data.c_str(), &endpointer, 10);
+}
+
+inline double variable_struct::get_number() const {
+  switch (store_) {
+    case kVariableStoreInt64:
+      return static_cast<double>(value_.integer);
+    case kVariableStoreUint64:
+      return static_cast<double>(value_.unsigned_integer);
+    case kVariableStoreDouble:
+      return value_.number;
+    default:
+      break;
+  }
+  return atof(data.c_str());
 }
  
 template <typename T>
 inline T variable_struct::_get() const {
-  T result{(T)0};
-  if (is_same(float, T)) {
-    result = static_cast<T>(atof(data.c_str()));
-  } else if (is_same(double, T)) {
-    result = static_cast<T>(atof(data.c_str()));
-  } else {
-    char *endpointer = nullptr;
-    int64_t temp = strtoint64(data.c_str(), &endpointer, 10);
-    result = static_cast<T>(temp);
-  }
-  return result;
+  if (std::is_floating_point<T>::value) 
+    return static_cast<T>(get_number());
+  return static_cast<T>(get_integer());
 }
 
 template <>
@@ -85,60 +127,62 @@ inline bool variable_struct::_get<bool>() const {
   
 template <typename T>
 inline T variable_struct::get() const {
-  std::unique_lock<std::mutex> auto_lock(mutex);
   return _get<T>();
 }
 
-inline const char * variable_struct::c_str() const {
-  return data.c_str();
-}
-
 inline variable_t &variable_struct::operator = (const variable_t &object) {
   if (this == &object) return *this;
-  std::unique_lock<std::mutex> auto_lock(mutex);
   type = object.type;
   data = object.data;
+  store_ = object.store_;
+  value_ = object.value_;
+  return *this;
+}
+
+inline variable_t &variable_struct::operator = (variable_t &&object) {
+  if (this == &object) return *this;
+  type = object.type;
+  data = std::move(object.data);
+  store_ = object.store_;
+  value_ = object.value_;
+  object.data.clear();
+  object.store_ = kVariableStoreString;
   return *this;
 }
 
 inline variable_t *variable_struct::operator = (const variable_t *object) {
   if (this == object) return this;
-  std::unique_lock<std::mutex> auto_lock(mutex);
-  if (object) {
-    type = object->type;
-    data = object->data;
-  }
+  if (object) *this = *object;
   return this;
 }
 
 inline variable_t &variable_struct::operator = (const std::string &value) {
-  std::unique_lock<std::mutex> auto_lock(mutex);
   type = kVariableTypeString;
+  store_ = kVariableStoreString;
   data = value;
   return *this;
 }
 
 inline variable_t &variable_struct::operator = (const char *value) {
   if (is_null(value)) return *this;
-  std::unique_lock<std::mutex> auto_lock(mutex);
   type = kVariableTypeString;
+  store_ = kVariableStoreString;
   data = value;
   return *this;
 }
   
 inline variable_t &variable_struct::operator = (char *value) {
   if (is_null(value)) return *this;
-  std::unique_lock<std::mutex> auto_lock(mutex);
   type = kVariableTypeString;
+  store_ = kVariableStoreString;
   data = value;
   return *this;
 }
 
 template <typename T>
 inline variable_t &variable_struct::operator = (T value) {
-  std::unique_lock<std::mutex> auto_lock(mutex);
   type = std_convert_type(value);
-  data = std::to_string(value);
+  set_number(value);
   return *this;
 }
 
@@ -187,26 +231,25 @@ inline variable_t *variable_struct::operator += (const variable_t *object) {
 }
 
 inline variable_t &variable_struct::operator += (const std::string &value) {
-  std::unique_lock<std::mutex> auto_lock(mutex);
   type = kVariableTypeString;
+  store_ = kVariableStoreString;
   data += value;
   return *this;
 }
 
 inline variable_t &variable_struct::operator += (const char *value) {
   if (is_null(value)) return *this;
-  std::unique_lock<std::mutex> auto_lock(mutex);
   type = kVariableTypeString;
+  store_ = kVariableStoreString;
   data += value;
   return *this;
 }
 
 template <typename T>
 inline variable_t &variable_struct::operator += (T value) {
-  std::unique_lock<std::mutex> auto_lock(mutex);
   auto last = _get<T>();
   last += value;
-  data = std::to_string(last);
+  set_number(last);
   return *this;
 }
 
@@ -255,10 +298,9 @@ inline variable_t *variable_struct::operator -= (const variable_t *object) {
   
 template <typename T>
 inline variable_t &variable_struct::operator -= (T value) {
-  std::unique_lock<std::mutex> auto_lock(mutex);
   auto last = _get<T>();
   last -= value;
-  data = std::to_string(last);
+  set_number(last);
   return *this;
 }
 
@@ -307,10 +349,9 @@ inline variable_t *variable_struct::operator *= (const variable_t *object) {
   
 template <typename T>
 inline variable_t &variable_struct::operator *= (T value) {
-  std::unique_lock<std::mutex> auto_lock(mutex);
   auto last = _get<T>();
   last *= value;
-  data = std::to_string(last);
+  set_number(last);
   return *this;
 }
 
@@ -359,10 +400,9 @@ inline variable_t *variable_struct::operator /= (const variable_t *object) {
 
 template <typename T>
 inline variable_t &variable_struct::operator /= (T value) {
-  std::unique_lock<std::mutex> auto_lock(mutex);
   auto last = _get<T>();
   last /= value;
-  data = std::to_string(last);
+  set_number(last);
   return *this;
 }
 
@@ -400,6 +440,7 @@ inline bool variable_struct::operator == (const std::string &value) const {
 }
 
 inline bool variable_struct::operator == (const char *value) const {
+  if (is_null(value)) return false;
   return data == value;
 }
   
@@ -423,6 +464,7 @@ inline bool variable_struct::operator != (const std::string &value) const {
 }
 
 inline bool variable_struct::operator != (const char *value) const {
+  if (is_null(value)) return true;
   return data != value;
 }
   
@@ -485,7 +527,7 @@ inline variable_struct::operator const std::string() {
 }
   
 inline variable_struct::operator const char *() {
-  return data.c_str();
+  return c_str();
 }
   
 template <typename T>
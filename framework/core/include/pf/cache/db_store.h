@@ -45,6 +45,7 @@
 #include "pf/sys/memory/sharemap.h"
 #include "pf/sys/memory/share.h"
 #include "pf/sys/config.h"
+#include "pf/sys/awaitable.h"
 #include "pf/cache/storeinterface.h"
 #include "pf/cache/db_define.h"
 
@@ -164,9 +165,15 @@ class PF_API DBStore : public StoreInterface {
    //Set the share service.
    void set_service(bool flag) { service_ = flag; };
 
+   //Run the query workers in the executor(set before init), not own pool.
+   void set_executor(pf_sys::Executor *executor) { executor_ = executor; };
+
    //Query sql from db.
    bool query(const std::string &key);
 
+   //Query in the workers, the value is the query result(by net is sent).
+   pf_sys::Awaitable<bool> load(const std::string &key);
+
    //Wait query in query list.
    bool waitquery(const char *key);
 
@@ -354,6 +361,9 @@ class PF_API DBStore : public StoreInterface {
    //The workers for tick.
    std::unique_ptr<pf_sys::ThreadPool> workers_;
 
+   //The shared executor for tick workers.
+   pf_sys::Executor *executor_;
+
    //The cache last check time.
    uint32_t cache_last_check_time_;
 
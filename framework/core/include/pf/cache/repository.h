@@ -80,6 +80,10 @@ class PF_API Repository {
    //Store an item can recycle when the cache is full.
    void recycle(const char *key);
 
+   //The lookup counters(get/has).
+   uint64_t hits() const { return hits_.load(std::memory_order_relaxed); };
+   uint64_t misses() const { return misses_.load(std::memory_order_relaxed); };
+
  protected:
 
    //The cache store implementation.
@@ -88,6 +92,9 @@ class PF_API Repository {
    //The default number of minutes to store items.
    int32_t minutes_;
 
+   std::atomic<uint64_t> hits_;
+   std::atomic<uint64_t> misses_;
+
 };
 
 } //namespace pf_cache
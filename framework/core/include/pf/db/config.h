@@ -68,6 +68,14 @@ struct db_fetch_array_struct {
   void clear();
 };
 
+//The async query result.
+typedef struct PF_API db_result_struct db_result_t;
+struct db_result_struct {
+  bool success; //The select may success without rows.
+  db_fetch_array_t fetch;
+  db_result_struct() : success{false} {}
+};
+
 //The connector type.
 /**
 typedef enum {
@@ -0,0 +1,58 @@
+/**
+ * PLAIN FRAMEWORK ( https://github.com/viticm/plainframework )
+ * $Id event.h
+ * @link https://github.com/viticm/plainframework for the canonical source repository
+ * @copyright Copyright (c) 2014- viticm( viticm.ti@gmail.com )
+ * @license
+ * @user viticm<viticm.ti@gmail.com>
+ * @date 2019/04/09 14:12
+ * @uses The main loop event source, notify from any thread and wait until
+ *       notified or the deadline.
+ *       linux下使用eventfd（通知）和timerfd（定时）一起poll，其他系统使用
+ *       条件变量。
+ */
+#ifndef PF_ENGINE_EVENT_H_
+#define PF_ENGINE_EVENT_H_
+
+#include "pf/engine/config.h"
+
+namespace pf_engine {
+
+//The scheduled function in main loop.
+struct schedule_struct {
+  uint64_t deadline; //ns, steady clock(the same as pf_net::metrics::now).
+  uint64_t interval; //ns, 0 is run once.
+  std::function<void()> function;
+  schedule_struct() : deadline{0}, interval{0} {};
+  bool operator > (const schedule_struct &object) const {
+    return deadline > object.deadline;
+  };
+};
+
+using schedule_t = schedule_struct;
+
+class PF_API Event {
+
+ public:
+   Event();
+   ~Event();
+
+ public:
+   bool init();
+   //Wake up the wait, safe in any thread(and the signal handler on linux).
+   void notify();
+   //Wait until notified or the deadline(ns, steady clock), 0 is forever.
+   void wait(uint64_t deadline);
+
+ private:
+   int32_t eventfd_;
+   int32_t timerfd_;
+   std::mutex mutex_;
+   std::condition_variable condition_;
+   bool notified_;
+
+};
+
+} //namespace pf_engine
+
+#endif //PF_ENGINE_EVENT_H_
@@ -12,14 +12,35 @@
 #define PF_ENGINE_KERNEL_H_
 
 #include "pf/engine/config.h"
+#include "pf/engine/event.h"
+#include "pf/engine/watchdog.h"
+#include "pf/sys/executor.h"
+#include "pf/sys/awaitable.h"
 #include "pf/db/config.h"
 #include "pf/script/config.h"
 #include "pf/net/connection/manager/config.h"
+#include "pf/net/protocol/config.h"
 #include "pf/cache/manager.h"
 #include "pf/basic/type/variable.h"
+#include "pf/basic/histogram.h"
 
 namespace pf_engine {
 
+//The init phase run after the depends(listed before it) are ok.
+struct init_phase_struct {
+  std::string name;
+  std::function<bool()> function;
+  std::vector<std::string> depends;
+  init_phase_struct(const std::string &_name,
+                    const std::function<bool()> &_function,
+                    const std::vector<std::string> &_depends = {}) :
+    name{_name},
+    function{_function},
+    depends{_depends} {}
+};
+
+using init_phase_t = init_phase_struct;
+
 class PF_API Kernel : public pf_basic::Singleton< Kernel > {
 
  public:
@@ -33,6 +54,7 @@ class PF_API Kernel : public pf_basic::Singleton< Kernel > {
  public:
    virtual bool init();
    virtual void run();
+   //Request the loop stop, safe in the signal handler.
    virtual void stop();
 
  public:
@@ -50,20 +72,24 @@ class PF_API Kernel : public pf_basic::Singleton< Kernel > {
  public:
 
    //Use these interface will send handshake packt after connected.
+   //The compact protocol need encrypt string(negotiated by handshake).
    pf_net::connection::Basic *default_connect(const std::string &name, 
                                               const std::string &ip, 
                                               uint16_t port, 
-                                              const std::string &encrypt_str = "");
+                                              const std::string &encrypt_str = "",
+                                              bool compact = false);
    pf_net::connection::Basic *connect(const std::string &name);
    pf_net::connection::Basic *connect(const std::string &name, 
                                       const std::string &ip, 
                                       uint16_t port, 
-                                      const std::string &encrypt_str = "");
+                                      const std::string &encrypt_str = "",
+                                      bool compact = false);
    pf_net::connection::Basic *connect(pf_net::connection::manager::Basic *,
                                       const std::string &name, 
                                       const std::string &ip, 
                                       uint16_t port, 
-                                      const std::string &encrypt_str = "");
+                                      const std::string &encrypt_str = "",
+                                      bool compact = false);
 
    //Get the extra listener or connector.
    pf_net::connection::Basic *get_connector(const std::string &name);
@@ -88,12 +114,40 @@ class PF_API Kernel : public pf_basic::Singleton< Kernel > {
    //Get the net handle script function name.
    const std::string get_script_function(pf_net::connection::Basic *);
 
+   //The prometheus text format metrics(read from any thread).
+   bool metrics_exposition(std::string &content);
+   //The main loop frame time(ns, without sleep).
+   const pf_basic::Histogram &get_frame_time() const { return frame_time_; }
+   //The subsystem tick stats and the stall watchdog.
+   const Watchdog &get_watchdog() const { return watchdog_; }
+   //The work stealing executor(default.engine.workers), null is closed.
+   pf_sys::Executor *get_executor() { return executor_.get(); }
+
  public:
    //Enqueue an envet function in main loop.
    template<class F, class... Args>
    auto enqueue(F&& f, Args&&... args) 
    -> std::future<typename std::result_of<F(Args...)>::type>;
 
+   //Run the job in the executor(in main loop if the executor is closed).
+   template<class F, class... Args>
+   auto async(F&& f, Args&&... args) 
+   -> std::future<typename std::result_of<F(Args...)>::type>;
+
+   //Schedule the function in main loop after delay(ms), then repeat with the
+   //interval(ms) if not 0, safe in any thread.
+   void schedule(const std::function<void()> &function,
+                 uint32_t delay,
+                 uint32_t interval = 0);
+
+ public: //The awaitable resume in the creator's loop(net tick, executor).
+   //Query the sql in the executor(or main loop), not block the caller, the
+   //error(see on_error) if the db not found or the query failed.
+   pf_sys::Awaitable<db_result_t> query(const std::string &sql, 
+                                        const std::string &dbname = "");
+   //Ready after the delay(ms).
+   pf_sys::Awaitable<bool> delay(uint32_t time);
+
  public:
    template<class F, class... Args>
    std::thread::id newthread(F&& f, Args&&... args);
@@ -104,6 +158,12 @@ class PF_API Kernel : public pf_basic::Singleton< Kernel > {
    virtual bool init_db();
    virtual bool init_cache();
    virtual bool init_script();
+   virtual bool init_metrics();
+   //Adopt the handoff connections and listen the handoff path.
+   virtual bool init_handoff();
+   //Run the phases(in parallel by the depends or in order), false if one
+   //is failed.
+   bool init_phases(const std::vector<init_phase_t> &phases, bool parallel);
 
  protected:
    std::unique_ptr<pf_net::connection::manager::Basic> net_;
@@ -118,19 +178,49 @@ class PF_API Kernel : public pf_basic::Singleton< Kernel > {
    std::vector< std::thread > thread_workers_;
    std::map<std::string, int8_t> db_list_;  //Database name to factory id.
    std::map<std::string, int8_t> listen_list_; //Listen net name to factory id.
+   std::map<std::string, int8_t> listen_pending_; //Add in the net phase.
    std::map<std::string, int8_t> connect_list_; //Connect net name to id.
    std::map<std::string, int8_t> connect_env_; //Connect net name to config id.
    std::map<std::string, int8_t> listen_env_; //Listen net name to config id.
    bool isinit_;
+   std::unique_ptr<pf_net::protocol::Http> metrics_http_;
+   pf_basic::Histogram frame_time_;
+   std::unique_ptr<pf_sys::Executor> executor_;
 
  private:
    void loop();
+   //Stop the watchdog, the workers and the executor(once).
+   void shutdown();
+   //Run the tasks(not more than budget), return the count.
+   uint32_t run_tasks(uint32_t budget);
+   //Run the expired schedules, return the next deadline(0 is none).
+   uint64_t run_schedules();
+   void reconnect();
+   //The subsystem tick every frame, in the executor or a new thread(bind with
+   //the name, see pf_sys::thread::bind).
+   void tick(const std::string &name, 
+             const std::function<bool()> &function, 
+             int32_t hint);
+   void show_fps(uint32_t count);
+   //Run the phase and log the cost time.
+   bool init_phase(const init_phase_t &phase);
+   //Hand off the listeners to the new process(connected), then stop.
+   void handoff();
+   void handoff_listeners(
+       std::vector<pf_net::connection::manager::Listener *> &listeners);
+   //Replay the capture(default.net.replay) to the default service, then stop.
+   void replay();
 
  private:
    std::queue< std::function<void()> > tasks_;
    std::vector< std::function<void()> > thread_tasks_;
+   std::priority_queue<
+     schedule_t, std::vector<schedule_t>, std::greater<schedule_t> > schedules_;
    std::mutex queue_mutex_;
-   bool stop_;
+   Event event_;
+   Watchdog watchdog_;
+   std::atomic<bool> stop_;
+   bool shutdown_;
 
 };
 
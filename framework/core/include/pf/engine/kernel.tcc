@@ -18,12 +18,13 @@
 
 namespace pf_engine {
 
-inline void worksleep(uint32_t starttime) {
-  auto worktime = 
-    static_cast< int32_t >(TIME_MANAGER_POINTER->get_tickcount() - starttime);
-  auto time = static_cast<int32_t>(
-      1000 / GLOBALS["default.engine.frame"].get<int32_t>()) - worktime;
-  if (time > 0) std::this_thread::sleep_for(std::chrono::milliseconds(time));
+//The start time is the nano time, not the coarse tick count.
+inline void worksleep(uint64_t starttime) {
+  static const pf_basic::config::handle<int32_t> frame{"default.engine.frame"};
+  auto worktime = static_cast<int64_t>(
+      pf_basic::TimeManager::get_nanotime() - starttime);
+  auto time = static_cast<int64_t>(1000000000 / frame.get()) - worktime;
+  if (time > 0) std::this_thread::sleep_for(std::chrono::nanoseconds(time));
 }
 
 template<class F, class... Args>
@@ -40,7 +41,16 @@ auto Kernel::enqueue(F&& f, Args&&... args)
        throw std::runtime_error("enqueue on stopped Kernel");
     tasks_.emplace([task](){ (*task)(); });
   }
- return res;
+  event_.notify();
+  return res;
+}
+
+template<class F, class... Args>
+auto Kernel::async(F&& f, Args&&... args) 
+-> std::future<typename std::result_of<F(Args...)>::type> {
+  if (executor_)
+    return executor_->async(std::forward<F>(f), std::forward<Args>(args)...);
+  return enqueue(std::forward<F>(f), std::forward<Args>(args)...);
 }
 
 template<class F, class... Args>
@@ -60,7 +70,7 @@ std::thread::id Kernel::newthread(F&& f, Args&&... args) {
       std::future<return_type> task_res = task->get_future();
       for (;;) {
         if (pf_sys::thread::is_stopping()) break;
-        auto starttime = TIME_MANAGER_POINTER->get_tickcount();
+        auto starttime = pf_basic::TimeManager::get_nanotime();
         (*task)(); 
         if (std::is_same<decltype(task_res), bool>::value && !task_res.get())
           pf_sys::thread::stop();
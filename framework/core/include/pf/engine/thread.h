@@ -25,6 +25,8 @@ bool for_net(pf_net::connection::manager::Basic *net);
 bool for_db(pf_db::Interface *db);
 bool for_cache(pf_cache::Manager *cache);
 bool for_script(pf_script::Interface *env);
+//Drain the script tasks when enqueue, not wait the tick.
+bool for_script_tasks(pf_script::Interface *env);
 
 } //namespace thread
 
@@ -0,0 +1,83 @@
+/**
+ * PLAIN FRAMEWORK ( https://github.com/viticm/plainframework )
+ * $Id watchdog.h
+ * @link https://github.com/viticm/plainframework for the canonical source repository
+ * @copyright Copyright (c) 2014- viticm( viticm.ti@gmail.com )
+ * @license
+ * @user viticm<viticm.ti@gmail.com>
+ * @date 2019/04/19 11:20
+ * @uses The subsystem tick stats(time histogram and the frame budget
+ *       overruns), and the watchdog thread find the tick without heartbeat
+ *       for N frames, then log it with the open trace span and the stack.
+ *       卡住的tick只报告一次，恢复后再记录一次恢复日志。
+ */
+#ifndef PF_ENGINE_WATCHDOG_H_
+#define PF_ENGINE_WATCHDOG_H_
+
+#include "pf/engine/config.h"
+#include "pf/basic/histogram.h"
+
+namespace pf_engine {
+
+struct tick_stat_struct {
+  std::string name;
+  pf_basic::Histogram time;         //The tick time(ns).
+  std::atomic<uint64_t> overruns;   //The tick over the frame budget.
+  std::atomic<uint64_t> stalls;
+  std::atomic<uint64_t> begin;      //The current tick start(ns), 0 is idle.
+  std::atomic<uint64_t> heartbeat;  //The last tick start or end(ns).
+  std::atomic<uint32_t> trace_tid;
+  std::atomic<std::thread::native_handle_type> handle;
+  std::atomic<bool> stalled;
+  tick_stat_struct(const std::string &_name) :
+    name{_name},
+    overruns{0},
+    stalls{0},
+    begin{0},
+    heartbeat{0},
+    trace_tid{0},
+    handle{},
+    stalled{false} {}
+  //Only the ticking thread call these.
+  void on_begin();
+  void on_end(uint64_t budget);
+};
+
+using tick_stat_t = tick_stat_struct;
+
+class PF_API Watchdog {
+
+ public:
+   Watchdog();
+   ~Watchdog();
+
+ public:
+   //Add the subsystem before start, never release.
+   tick_stat_t *add(const std::string &name);
+   //The frame budget(ns), check the ticks without heartbeat for the frames
+   //in a thread if frames not 0.
+   void start(uint32_t frames, uint64_t budget);
+   void stop();
+   const std::vector< std::unique_ptr<tick_stat_t> > &stats() const {
+     return stats_;
+   }
+   uint64_t budget() const { return budget_; }
+
+ private:
+   void check(tick_stat_t *stat, uint64_t now);
+   void report(tick_stat_t *stat, uint64_t elapsed);
+
+ private:
+   std::vector< std::unique_ptr<tick_stat_t> > stats_;
+   std::thread thread_;
+   std::mutex mutex_;
+   std::condition_variable condition_;
+   uint64_t budget_;
+   uint32_t frames_;
+   bool stop_;
+
+};
+
+} //namespace pf_engine
+
+#endif //PF_ENGINE_WATCHDOG_H_
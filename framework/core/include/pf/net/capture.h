@@ -0,0 +1,121 @@
+/**
+ * PLAIN FRAMEWORK ( https://github.com/viticm/plainframework )
+ * $Id capture.h
+ * @link https://github.com/viticm/plainframework for the canonical source repository
+ * @copyright Copyright (c) 2014- viticm( viticm.ti@gmail.com )
+ * @license
+ * @user viticm<viticm.ti@gmail.com>
+ * @date 2019/04/02 10:36
+ * @uses The net traffic capture and replay, record the framed inbound
+ *       packets(header and body) to a binary file and feed them back.
+ *       每个线程先写到自己的缓冲区，满了再加文件锁写入，记录路径没有竞争。
+ *       File: magic(4) version(2) reserved(2) then records, each record is
+ *       time(8, ns from open) managerid(2) id(2) flags(1) reserved(1)
+ *       size(4) data(size), host byte order.
+ */
+#ifndef PF_NET_CAPTURE_H_
+#define PF_NET_CAPTURE_H_
+
+#include "pf/net/connection/config.h"
+#include "pf/net/stream/config.h"
+#include "pf/net/connection/manager/config.h"
+
+#define NET_CAPTURE_MAGIC (0x50434650) //"PFCP"
+#define NET_CAPTURE_VERSION (1)
+#define NET_CAPTURE_HEADER_SIZE (8)
+#define NET_CAPTURE_RECORD_HEADER_SIZE (18)
+#define NET_CAPTURE_BUFFER_SIZE (64 * 1024) //The thread buffer flush size.
+
+namespace pf_net {
+
+namespace capture {
+
+typedef enum {
+  kFlagNone = 0,
+  kFlagCompact = 1, //The compact protocol header.
+} flag_t;
+
+struct record_struct {
+  uint64_t time;
+  uint16_t managerid;
+  int16_t id;
+  uint8_t flags;
+  std::string data; //The packet header and body.
+  record_struct() : time{0}, managerid{0}, id{0}, flags{0} {};
+};
+
+using record_t = record_struct;
+
+PF_API bool open(const std::string &filename);
+PF_API void close();
+PF_API bool is_open();
+
+//Write all threads buffer to the file.
+PF_API void flush();
+
+//Record the full packet from the head of input stream.
+PF_API bool record(connection::Basic *connection,
+                   stream::Input &istream,
+                   uint32_t size);
+
+class PF_API Reader {
+
+ public:
+   Reader() : fp_{nullptr} {};
+   ~Reader() { close(); };
+
+ public:
+   bool open(const std::string &filename);
+   void close();
+   //Return false when end of the file or error.
+   bool next(record_t &record);
+
+ private:
+   FILE *fp_;
+
+};
+
+struct replay_stat_struct {
+  uint64_t records;
+  uint64_t bytes;
+  uint64_t failed;  //The connection failed(command return false).
+  uint64_t elapsed; //ns.
+  replay_stat_struct() : records{0}, bytes{0}, failed{0}, elapsed{0} {};
+};
+
+using replay_stat_t = replay_stat_struct;
+
+//Feed the capture into connections from the manager pool(without socket),
+//the packets execute as received from the network. The kernel replay to the
+//default service with GLOBALS["default.net.replay"].
+class PF_API Replayer {
+
+ public:
+   Replayer() : manager_{nullptr} {};
+   ~Replayer() { clear(); };
+
+ public:
+   bool init(const std::string &filename,
+             connection::manager::Interface *manager);
+   //The speed 1.0 is original, 2.0 is double and 0 is as fast as possible.
+   bool run(double speed = 1.0);
+   const replay_stat_t &stat() const { return stat_; };
+
+ private:
+   connection::Basic *get(const record_t &record);
+   void release(uint32_t key);
+   void clear();
+
+ private:
+   std::string filename_;
+   connection::manager::Interface *manager_;
+   std::map<uint32_t, connection::Basic *> connections_;
+   replay_stat_t stat_;
+
+};
+
+} //namespace capture
+
+} //namespace pf_net
+
+#endif //PF_NET_CAPTURE_H_
@@ -16,6 +16,7 @@
 #define PF_NET_CONNECTION_BASE_H_
 
 #include "pf/net/connection/config.h"
+#include "pf/net/connection/limiter.h"
 #include "pf/basic/type/variable.h"
 #include "pf/net/packet/interface.h"
 #include "pf/net/socket/basic.h"
@@ -64,8 +65,9 @@ class PF_API Basic {
    virtual bool process_input();
    virtual bool process_output();
    virtual bool process_command();
-   virtual bool heartbeat(uint32_t time = 0, uint32_t flag = 0);
+   virtual bool heartbeat(uint64_t time = 0, uint32_t flag = 0);
    virtual bool send(packet::Interface *packet);
+   bool flush(); //立即发送输出流中的数据，不等待网络帧
    virtual bool routing(const std::string &name, 
                         packet::Interface *packet, 
                         const std::string &service = "");
@@ -116,15 +118,34 @@ class PF_API Basic {
    void encrypt_set_key(const char *key);
    uint32_t get_receive_bytes();
    uint32_t get_send_bytes();
+   void set_send_policy(send_policy_t policy) { send_policy_ = policy; };
+   Limiter &limiter() { return limiter_; };
+   //The queue depths(bytes) and the flush count that can't send all data.
+   uint32_t input_pending() const { return istream_ ? istream_->size() : 0; };
+   uint32_t output_pending() const;
+   uint32_t get_flush_stalls() const { return flush_stalls_; };
+   //Record the inbound packets when the capture is open.
+   void set_capture(bool flag) { capture_ = flag; };
+   bool is_capture() const { return capture_; };
+   send_policy_t get_send_policy() const { return send_policy_; };
 
  public:
    stream::Input &istream() { return *istream_.get(); }
    stream::Output &ostream() { return *ostream_.get(); };
    stream::Input &istream_compress() { return *istream_compress_.get(); }
-   int8_t packet_index() { return packet_index_++; };
-   void set_protocol(protocol::Interface *_protocol) {
-     protocol_ = _protocol;
+   //Lane 0 is the output stream, others are the lower priority queues.
+   stream::Output &lane_ostream(uint8_t lane);
+   //The packet(header and body) is written to the lane.
+   void lane_commit(uint8_t lane, uint32_t size) {
+     if (lane > 0 && lane < NET_CONNECTION_LANE_MAX)
+       lane_packets_[lane].push_back(size);
+   }
+   void set_lane_weight(uint8_t lane, uint8_t weight) {
+     if (lane > 0 && lane < NET_CONNECTION_LANE_MAX)
+       lane_weights_[lane] = weight > 0 ? weight : 1;
    }
+   int8_t packet_index() { return packet_index_++; };
+   void set_protocol(protocol::Interface *_protocol);
    protocol::Interface *protocol() {
      return protocol_;
    }
@@ -146,6 +167,10 @@ class PF_API Basic {
 
  private:
    void process_input_compress();
+   //Need lock the mutex_ before call this, push send the corked data now.
+   bool flush_output(bool push = false);
+   void lane_schedule();
+   void lane_clear();
 
  private:
    int16_t id_;
@@ -170,6 +195,18 @@ class PF_API Basic {
  private:
    uint32_t receive_bytes_;
    uint32_t send_bytes_;
+   send_policy_t send_policy_;
+   Limiter limiter_;
+   uint32_t flush_stalls_;
+   bool capture_;
+   bool corked_; //The TCP_CORK keep across the ticks.
+   bool cork_bulk_; //The corked output can't send all in one flush.
+
+ private:
+   std::unique_ptr<stream::Output> lanes_[NET_CONNECTION_LANE_MAX];
+   std::deque<uint32_t> lane_packets_[NET_CONNECTION_LANE_MAX];
+   uint32_t lane_deficits_[NET_CONNECTION_LANE_MAX];
+   uint8_t lane_weights_[NET_CONNECTION_LANE_MAX];
 
  private:
    int8_t packet_index_;
@@ -19,6 +19,10 @@
 #define NET_CONNECTION_KICKTIME 6000000 //超过该时间则断开连接
 #define NET_CONNECTION_INCOME_KICKTIME 60000
 #define NET_CONNECTION_POOL_SIZE_DEFAULT 1280 //连接池默认大小
+#define NET_CONNECTION_LANE_MAX 4 //发送通道数量（含直接写入输出流的通道0）
+#define NET_CONNECTION_LANE_QUANTUM (4 * 1024) //通道每轮调度字节数（乘以权重）
+#define NET_CONNECTION_LANE_FLUSH_BUDGET (64 * 1024) //输出流低于该值才补充
+#define NET_CONNECTION_LANE_SIZEMAX (64 * 1024 * 1024) //通道缓存的最大字节数
 
 namespace pf_net {
 
@@ -32,6 +36,13 @@ typedef enum {
   kCompressModeAll = 3,     //无论是输入流还是输出流都压缩
 } compress_mode_t;
 
+//发送策略 默认在每个网络帧统一发送，使同一帧内的多个包合并为较少的系统调用
+typedef enum {
+  kSendPolicyTick = 0,       //帧内合并，由process_output统一发送
+  kSendPolicyImmediate = 1,  //写入后立即发送，适用于延迟敏感的连接
+  kSendPolicyCork = 2,       //帧内合并并使用TCP_CORK，内核只发送满包
+} send_policy_t;
+
 class Basic;
 class Pool;
 
@@ -0,0 +1,127 @@
+/**
+ * PLAIN FRAMEWORK ( https://github.com/viticm/plainframework )
+ * $Id limiter.h
+ * @link https://github.com/viticm/plainframework for the canonical source repository
+ * @copyright Copyright (c) 2014- viticm( viticm.ti@gmail.com )
+ * @license
+ * @user viticm<viticm.ti@gmail.com>
+ * @date 2019/03/16 11:05
+ * @uses The ingress rate limiter of connection, token buckets for the whole
+ *       connection and the packet ids, checked before the packet create.
+ *       规则由监听器持有，连接只保存自己的令牌桶状态；没有规则时只有一次判空。
+ */
+#ifndef PF_NET_CONNECTION_LIMITER_H_
+#define PF_NET_CONNECTION_LIMITER_H_
+
+#include "pf/net/connection/config.h"
+
+#define NET_CONNECTION_LIMIT_TOKEN_SCALE 1000 //令牌精度（毫秒补充）
+
+namespace pf_net {
+
+namespace connection {
+
+//超出限制时的处理
+typedef enum {
+  kLimitActionNone = 0,         //通过
+  kLimitActionDrop = 1,         //丢弃该消息
+  kLimitActionDelay = 2,        //留在输入流中，下一帧再处理
+  kLimitActionDisconnect = 3,   //断开连接
+} limit_action_t;
+
+struct limit_rule_struct {
+  uint32_t rate;              //每秒令牌数，0为不限制
+  uint32_t burst;             //桶容量（允许的突发数量）
+  limit_action_t action;
+  limit_rule_struct() : rate{0}, burst{0}, action{kLimitActionDrop} {};
+  limit_rule_struct(uint32_t _rate, uint32_t _burst, limit_action_t _action) :
+    rate{_rate}, burst{_burst}, action{_action} {};
+};
+
+using limit_rule_t = limit_rule_struct;
+
+//Written by the net thread and read by the metrics thread.
+struct limit_counters_struct {
+  std::atomic<uint64_t> passed;
+  std::atomic<uint64_t> dropped;
+  std::atomic<uint64_t> delayed;
+  std::atomic<uint64_t> disconnected;
+  limit_counters_struct() :
+    passed{0}, dropped{0}, delayed{0}, disconnected{0} {};
+  void clear() {
+    passed.store(0, std::memory_order_relaxed);
+    dropped.store(0, std::memory_order_relaxed);
+    delayed.store(0, std::memory_order_relaxed);
+    disconnected.store(0, std::memory_order_relaxed);
+  };
+};
+
+using limit_counters_t = limit_counters_struct;
+
+struct limit_rules_struct {
+  limit_rule_t connection;                   //整个连接
+  std::map<uint16_t, limit_rule_t> packets;  //单个消息
+  limit_counters_t counters;                 //所有连接的统计
+};
+
+using limit_rules_t = limit_rules_struct;
+
+struct token_bucket_struct {
+  uint32_t tokens; //NET_CONNECTION_LIMIT_TOKEN_SCALE is one token.
+  uint64_t last;   //The last refill tick(ms).
+  token_bucket_struct() : tokens{0}, last{0} {};
+  void refill(const limit_rule_t &rule, uint64_t now) {
+    uint64_t max =
+      static_cast<uint64_t>(rule.burst > 0 ? rule.burst : 1) *
+      NET_CONNECTION_LIMIT_TOKEN_SCALE;
+    uint64_t refill = static_cast<uint64_t>(now - last) * rule.rate;
+    uint64_t value = tokens + refill;
+    tokens = static_cast<uint32_t>(value > max ? max : value);
+    last = now;
+  }
+  bool ready() const { return tokens >= NET_CONNECTION_LIMIT_TOKEN_SCALE; }
+  void consume() { tokens -= NET_CONNECTION_LIMIT_TOKEN_SCALE; }
+  bool take(const limit_rule_t &rule, uint64_t now) {
+    refill(rule, now);
+    if (!ready()) return false;
+    consume();
+    return true;
+  }
+};
+
+using token_bucket_t = token_bucket_struct;
+
+class PF_API Limiter {
+
+ public:
+   Limiter();
+   ~Limiter() {};
+
+ public:
+   void set_rules(limit_rules_t *rules, uint64_t now);
+   limit_rules_t *rules() { return rules_; };
+   const limit_counters_t &counters() const { return counters_; };
+   void clear();
+   limit_action_t check(uint16_t packetid, uint64_t now) {
+     if (is_null(rules_)) return kLimitActionNone;
+     return check_rules(packetid, now);
+   };
+
+ private:
+   limit_action_t check_rules(uint16_t packetid, uint64_t now);
+   limit_action_t count(limit_action_t action);
+
+ private:
+   limit_rules_t *rules_;
+   token_bucket_t bucket_;
+   std::map<uint16_t, token_bucket_t> packet_buckets_;
+   limit_counters_t counters_;
+   bool delaying_; //The delayed packet retry not count again.
+
+};
+
+} //namespace connection
+
+} //namespace pf_net
+
+#endif //PF_NET_CONNECTION_LIMITER_H_
@@ -33,9 +33,12 @@ class PF_API Basic : public Select {
    virtual ~Basic() {};
 
  public:
-   virtual bool heartbeat(uint32_t time = 0);
+   virtual bool heartbeat(uint64_t time = 0);
    virtual void tick();
 
+ protected:
+   void update_metrics();
+
 };
 
 } //namespace manager
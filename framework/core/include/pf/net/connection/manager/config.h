@@ -12,7 +12,9 @@
 #define PF_NET_CONNECTION_MANAGER_CONFIG_H_
 
 #include "pf/net/connection/config.h"
+#include "pf/net/connection/limiter.h"
 #include "pf/net/packet/config.h"
+#include "pf/basic/histogram.h"
 
 namespace pf_net {
 
@@ -20,6 +22,7 @@ namespace connection {
 
 namespace manager {
 
+class Interface;
 class Basic;
 class Listener;
 class ListenerFactory;
@@ -51,9 +54,32 @@ struct listener_config_struct {
   uint16_t port;
   uint16_t conn_max;
   std::string encrypt_str;
+  bool compact;
+  bool nodelay;
+  int8_t send_policy;
+  bool capture;
+  limit_rule_t limit;
+  listener_config_struct() : 
+    port{0}, 
+    conn_max{0}, 
+    compact{false}, 
+    nodelay{false}, 
+    send_policy{kSendPolicyTick},
+    capture{false} {};
 };
 using eid_t = int16_t; //Environment.
 
+//The manager metrics, write by the net thread and read by any thread.
+struct metrics_struct {
+  pf_basic::Histogram tick;             //The tick time(ns).
+  std::atomic<uint32_t> connections;
+  std::atomic<uint64_t> input_pending;  //All connections input bytes.
+  std::atomic<uint64_t> output_pending; //All connections output bytes.
+  metrics_struct() : connections{0}, input_pending{0}, output_pending{0} {};
+};
+
+using metrics_t = metrics_struct;
+
 using listener_config_t = listener_config_struct;
 
 } //namespace manager
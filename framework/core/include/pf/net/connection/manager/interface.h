@@ -15,8 +15,10 @@
 
 #include "pf/net/connection/manager/config.h"
 #include "pf/sys/thread.h"
+#include "pf/sys/awaitable.h"
 #include "pf/net/packet/interface.h"
 #include "pf/net/protocol/basic.h"
+#include "pf/net/protocol/compact.h"
 #include "pf/net/connection/basic.h"
 #include "pf/net/connection/pool.h"
 
@@ -37,9 +39,12 @@ class PF_API Interface {
    bool pool_init(uint16_t connectionmax = NET_CONNECTION_MAX);
    void pool_set(connection::Pool *pool);
    bool add(connection::Basic *connection);
+   //Add to the poll and the manager without the connect callbacks(the
+   //connection is serving before, like the handoff failed).
+   bool attach(connection::Basic *connection);
 
  public:
-   virtual bool heartbeat(uint32_t time = 0);
+   virtual bool heartbeat(uint64_t time = 0);
    //从管理器中移除连接
    virtual bool remove(int16_t id);
    //删除连接包括管理器、socket
@@ -85,6 +90,16 @@ class PF_API Interface {
    bool cache_resize();
    void broadcast(packet::Interface *packet);
 
+ public: //The continuation resume in tick, multi thread safe.
+   void post(const std::function<void()> &function);
+   bool process_post();
+   pf_sys::resumer_t resumer() {
+     return [this](const std::function<void()> &function) { post(function); };
+   }
+   //Send the packet(create by factory, remove after sent) in tick, the value
+   //is false if the connection is gone or send failed.
+   pf_sys::Awaitable<bool> send_async(packet::Interface *packet, uint16_t id);
+
  public:
    void callback_disconnect(
        std::function<void (connection::Basic *)> callback) {
@@ -106,6 +121,7 @@ class PF_API Interface {
 
  public:
    std::thread::id thread_id() const { return thread_id_; }
+   const metrics_t &get_metrics() const { return metrics_; }
 
  public:
    protocol::Interface *protocol() { return protocol_default(); };
@@ -113,6 +129,11 @@ class PF_API Interface {
      static protocol::Basic proto;
      return &proto;
    };
+   //The varint header protocol, switch to it after handshake.
+   static protocol::Interface *protocol_compact() {
+     static protocol::Compact proto;
+     return &proto;
+   };
 
  public:
    virtual bool select() = 0;             /* 网络侦测 */
@@ -147,6 +168,9 @@ class PF_API Interface {
    cache_t cache_;
    std::map<std::string, uint16_t> connection_names_; //The connection name to id.
    std::mutex mutex_;
+   metrics_t metrics_;
+   std::vector< std::function<void()> > posts_;
+   std::mutex post_mutex_;
 
  private:
    std::thread::id thread_id_;
@@ -14,6 +14,7 @@
 #include "pf/net/connection/manager/config.h"
 #include "pf/net/connection/manager/basic.h"
 #include "pf/net/socket/listener.h"
+#include "pf/net/handoff.h"
 
 namespace pf_net {
 
@@ -40,6 +41,17 @@ class PF_API Listener : public Basic {
    }
    virtual connection::Basic *accept(); //新连接接受处理
 
+ public: //Handoff(zero downtime restart).
+   //Stop accept and collect the listener socket(and connections) to hand off
+   //in the tick, the connections can't hand off(encrypted or the output not
+   //flushed) will be kept. The collected connections not serve until finish.
+   void handoff(std::vector<pf_net::handoff::item_t> &items, bool connections);
+   //Drop the collected connections after the new process received, or serve
+   //them and accept again if the handoff failed.
+   void handoff_finish(bool result);
+   //Adopt the connections received from the old process, return the count.
+   uint16_t adopt();
+
  public:
 
    virtual void on_connect(connection::Basic * connection);
@@ -56,6 +68,26 @@ class PF_API Listener : public Basic {
    const std::string get_safe_encrypt_str() {
      return safe_encrypt_str_;
    }
+   //Allow the connection use compact protocol after handshake.
+   void set_compact(bool flag) { compact_ = flag; }
+   bool compact() const { return compact_; }
+   //The socket options for the accepted connection.
+   void set_nodelay(bool flag) { nodelay_ = flag; }
+   bool nodelay() const { return nodelay_; }
+   void set_send_policy(send_policy_t policy) { send_policy_ = policy; }
+   send_policy_t send_policy() const { return send_policy_; }
+   void set_capture(bool flag) { capture_ = flag; }
+   bool capture() const { return capture_; }
+   //The ingress rate limit, the counters is all connections.
+   void set_limit(const limit_rule_t &rule) { limit_rules_.connection = rule; }
+   void set_packet_limit(uint16_t packetid, const limit_rule_t &rule) {
+     limit_rules_.packets[packetid] = rule;
+   }
+   const limit_counters_t &limit_counters() const {
+     return limit_rules_.counters;
+   }
+   //The accepted connection protocol(not the default, like http).
+   void set_protocol(protocol::Interface *_protocol) { protocol_ = _protocol; }
    void set_name(const std::string &_name) {
      name_ = _name;
    }
@@ -67,7 +99,15 @@ class PF_API Listener : public Basic {
    std::unique_ptr<socket::Listener> listener_socket_;
    std::string safe_encrypt_str_;
    std::string name_;
+   bool compact_;
+   bool nodelay_;
+   send_policy_t send_policy_;
+   bool capture_;
+   limit_rules_t limit_rules_;
+   protocol::Interface *protocol_;
    bool ready_;
+   int32_t handoff_accept_; //The onestep accept before handoff, -2 is none.
+   std::vector<int16_t> handoff_connections_;
 
 };
 
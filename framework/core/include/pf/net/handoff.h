@@ -0,0 +1,88 @@
+/**
+ * PLAIN FRAMEWORK ( https://github.com/viticm/plainframework )
+ * $Id handoff.h
+ * @link https://github.com/viticm/plainframework for the canonical source repository
+ * @copyright Copyright (c) 2014- viticm( viticm.ti@gmail.com )
+ * @license
+ * @user viticm<viticm.ti@gmail.com>
+ * @date 2019/04/16 15:02
+ * @uses The sockets handoff for zero downtime restart, the old process pass
+ *       the listener sockets(and the connections with the unread input) to
+ *       the new process over the unix socket(SCM_RIGHTS).
+ *       新进程以--upgrade启动时连接旧进程的unix socket接收，旧进程发送完成后
+ *       退出，监听socket不会关闭，所以不会丢失新连接。
+ *       Message: magic(4) count(2) reserved(2) size(4) with count fds, then
+ *       the items(size), each item is type(1) flags(1) port(2)
+ *       remote_port(2) host(2 + n) name(2 + n) input(4 + n), host byte
+ *       order, the count 0 is end and the receiver reply one byte.
+ */
+#ifndef PF_NET_HANDOFF_H_
+#define PF_NET_HANDOFF_H_
+
+#include "pf/net/socket/config.h"
+
+#define NET_HANDOFF_MAGIC (0x4f484650) //"PFHO"
+#define NET_HANDOFF_HEADER_SIZE (12)
+#define NET_HANDOFF_FDS_MAX (200) //Less than the SCM_MAX_FD(253).
+#define NET_HANDOFF_TIMEOUT (10)  //Seconds.
+
+namespace pf_net {
+
+namespace handoff {
+
+typedef enum {
+  kTypeListener = 1,
+  kTypeConnection = 2,
+} type_t;
+
+typedef enum {
+  kFlagNone = 0,
+  kFlagCompact = 1, //The compact protocol(after handshake).
+} flag_t;
+
+struct item_struct {
+  uint8_t type;
+  uint8_t flags;
+  int32_t fd;
+  uint16_t port;        //The listener port(the connection is its listener).
+  uint16_t remote_port; //The connection peer.
+  std::string host;
+  std::string name;     //The connection name.
+  std::string input;    //The connection unread input.
+  item_struct() :
+    type{kTypeListener},
+    flags{kFlagNone},
+    fd{SOCKET_INVALID},
+    port{0},
+    remote_port{0} {};
+};
+
+using item_t = item_struct;
+
+//The old process, listen the unix socket(the owner only) and accept(not
+//block) the new one of the same user.
+PF_API bool listen(const std::string &path);
+PF_API int32_t accept();
+PF_API void close();
+
+//Send the items to the new process and wait it received, the fds close
+//after sent.
+PF_API bool send(int32_t peer, std::vector<item_t> &items);
+
+//The new process, receive the items from the old process.
+PF_API bool receive(const std::string &path);
+
+//The received listener socket of the port, SOCKET_INVALID is none.
+PF_API int32_t take_listener(uint16_t port);
+
+//The received connections of the listener port.
+PF_API void take_connections(uint16_t port, std::vector<item_t> &items);
+
+//Close the received sockets not taken.
+PF_API void clear();
+
+} //namespace handoff
+
+} //namespace pf_net
+
+#endif //PF_NET_HANDOFF_H_
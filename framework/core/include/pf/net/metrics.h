@@ -0,0 +1,77 @@
+/**
+ * PLAIN FRAMEWORK ( https://github.com/viticm/plainframework )
+ * $Id metrics.h
+ * @link https://github.com/viticm/plainframework for the canonical source repository
+ * @copyright Copyright (c) 2014- viticm( viticm.ti@gmail.com )
+ * @license
+ * @user viticm<viticm.ti@gmail.com>
+ * @date 2019/03/23 11:30
+ * @uses The net metrics, per packet id count, bytes, decode and execute
+ *       time(ns) histograms, and the flush stall counter.
+ *       每个线程记录自己的数据（只在第一次遇到某个消息时加锁注册），读取时
+ *       合并所有线程的数据，记录路径上没有锁和原子加。
+ */
+#ifndef PF_NET_METRICS_H_
+#define PF_NET_METRICS_H_
+
+#include "pf/net/config.h"
+#include "pf/basic/histogram.h"
+#include "pf/basic/time_manager.h"
+
+namespace pf_net {
+
+namespace metrics {
+
+struct packet_stat_struct {
+  uint16_t id;
+  std::atomic<uint64_t> count;
+  std::atomic<uint64_t> bytes;
+  pf_basic::Histogram decode;   //packet read(ns).
+  pf_basic::Histogram execute;  //packet execute(ns).
+  packet_stat_struct(uint16_t _id) : id{_id}, count{0}, bytes{0} {};
+  //Only the owner thread call this.
+  void on_read(uint32_t size, uint64_t time) {
+    count.store(count.load(std::memory_order_relaxed) + 1, 
+                std::memory_order_relaxed);
+    bytes.store(bytes.load(std::memory_order_relaxed) + size, 
+                std::memory_order_relaxed);
+    decode.record(time);
+  };
+};
+
+using packet_stat_t = packet_stat_struct;
+
+//The merged result of all threads.
+struct packet_snapshot_struct {
+  uint16_t id;
+  uint64_t count;
+  uint64_t bytes;
+  std::shared_ptr<pf_basic::Histogram> decode;
+  std::shared_ptr<pf_basic::Histogram> execute;
+};
+
+using packet_snapshot_t = packet_snapshot_struct;
+
+PF_API bool enable();
+PF_API void set_enable(bool flag);
+
+//The current thread stat of the packet, never release.
+PF_API packet_stat_t *packet_stat(uint16_t id);
+
+//The snapshots order by packet id.
+PF_API void packet_snapshot(std::vector<packet_snapshot_t> &snapshots);
+
+//The output stream can't send all data(socket buffer is full).
+PF_API void flush_stall();
+PF_API uint64_t flush_stalls();
+
+//The monotonic time(ns) for the duration.
+inline uint64_t now() {
+  return pf_basic::TimeManager::get_nanotime();
+}
+
+} //namespace metrics
+
+} //namespace pf_net
+
+#endif //PF_NET_METRICS_H_
@@ -77,6 +77,16 @@ class PF_API Dynamic : public packet::Interface {
    double read_double();
    uint32_t read_bytes(unsigned char *value, size_t size);
 
+ public: //varint(LEB128)，有符号数使用zigzag
+   void write_varuint32(uint32_t value);
+   void write_varint32(int32_t value);
+   void write_varuint64(uint64_t value);
+   void write_varint64(int64_t value);
+   uint32_t read_varuint32();
+   int32_t read_varint32();
+   uint64_t read_varuint64();
+   int64_t read_varint64();
+
  public:
    //some useful.
    Dynamic &operator >> (bool &var) {
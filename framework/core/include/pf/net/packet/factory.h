@@ -24,6 +24,8 @@ class PF_API Factory {
    virtual Interface *packet_create() = 0;
    virtual uint16_t packet_id() const = 0;
    virtual uint32_t packet_max_size() const = 0;
+   //发送通道，0为最高优先级直接写入输出流，大数据量的消息可以放到低优先级通道
+   virtual uint8_t packet_lane() const { return 0; }
 
 };
 
@@ -52,6 +52,11 @@ class PF_API FactoryManager : public pf_basic::Singleton<FactoryManager> {
    };
    //根据消息类型取得对应消息的最大尺寸（允许多线程同时调用）
    uint32_t packet_max_size(uint16_t packetid);
+   //根据消息类型取得发送通道（初始化后只读，不加锁）
+   uint8_t packet_lane(uint16_t packetid) const {
+     auto it = packet_lanes_.find(packetid);
+     return it == packet_lanes_.end() ? 0 : it->second;
+   };
    //删除消息实体（允许多线程同时调用，必须和createpacket成对出现）
    void packet_remove(Interface *packet);
    bool is_valid_packet_id(uint16_t id); //packetid is valid
@@ -89,6 +94,7 @@ class PF_API FactoryManager : public pf_basic::Singleton<FactoryManager> {
    Factory **factories_;
    pf_basic::hashmap::Template<uint16_t, uint16_t> id_indexs_;
    pf_basic::hashmap::Template<int64_t, Interface *> alloc_packets_;
+   std::map<uint16_t, uint8_t> packet_lanes_; //Only the not default lanes.
    uint16_t size_;
    uint16_t factory_size_;
    std::mutex mutex_;
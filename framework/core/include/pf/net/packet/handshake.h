@@ -23,24 +23,38 @@ namespace packet {
 class Handshake : public pf_net::packet::Interface {
 
  public:
-   Handshake() : key_{0} {}
+   Handshake() : key_{0}, flags_{0}, size_{0} {}
    virtual ~Handshake() {}
 
+ public:
+   //The options after key, only write when not 0(old peers not read it).
+   enum { kFlagCompact = 0x01, };
+
  public:
    virtual bool read(pf_net::stream::Input &);
    virtual bool write(pf_net::stream::Output &);
    virtual uint32_t execute(pf_net::connection::Basic *connection);
    uint16_t get_id() const { return NET_PACKET_HANDSHAKE; };
    virtual uint32_t size() const;
+   virtual void set_size(uint32_t _size) { size_ = _size; }
+   void set_flags(uint8_t flags) { flags_ = flags; }
+   uint8_t get_flags() const { return flags_; }
    void set_key(const std::string &str) {
      pf_basic::string::safecopy(key_, str.c_str(), sizeof(key_) - 1);
    }
    const char *get_key() {
      return key_;
    }
+   //Build the key from the listener encrypt string and the current time.
+   void set_encrypt_key(const std::string &encrypt_str);
+
+ private:
+   uint32_t options(pf_net::connection::Basic *connection);
 
  private:
    char key_[NET_PACKET_HANDSHAKE_KEY_SIZE];
+   uint8_t flags_;
+   uint32_t size_;
 
 };
 
@@ -58,7 +72,7 @@ class HandshakeFactory : public pf_net::packet::Factory {
      return NET_PACKET_HANDSHAKE;
    }
    virtual uint32_t packet_max_size() const {
-     return NET_PACKET_HANDSHAKE_KEY_SIZE;
+     return NET_PACKET_HANDSHAKE_KEY_SIZE + sizeof(uint32_t) + sizeof(uint8_t);
    };
 
 };
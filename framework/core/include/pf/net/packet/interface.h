@@ -34,6 +34,8 @@ class PF_API Interface {
    virtual uint32_t execute(connection::Basic *connection);
    virtual uint16_t get_id() const = 0;
    virtual uint32_t size() const = 0;
+   //The size write to the compact(varint) stream.
+   virtual uint32_t compact_size() const { return size(); };
    virtual void set_id(uint16_t) {};
    virtual void set_size(uint32_t) {};
    int8_t get_index() const { return index_; };
@@ -35,6 +35,13 @@ class PF_API Basic : public Interface {
    virtual size_t header_size() const { return NET_PACKET_HEADERSIZE; };
    virtual packet::Interface *read_packet(connection::Basic *); 
 
+ protected:
+   //取得消息头，返回消息头长度，0表示数据不足，小于0表示消息头错误
+   virtual int32_t peek_header(stream::Input &istream, header_t &header);
+   //写入消息头，返回写入的长度，0表示失败
+   virtual uint32_t write_header(stream::Output &ostream, 
+                                 const header_t &header);
+
 };
 
 } //namespace protocol
@@ -0,0 +1,52 @@
+/**
+ * PLAIN FRAMEWORK ( https://github.com/viticm/plainframework )
+ * $Id compact.h
+ * @link https://github.com/viticm/plainframework for the canonical source repository
+ * @copyright Copyright (c) 2014- viticm( viticm.ti@gmail.com )
+ * @license
+ * @user viticm<viticm.ti@gmail.com>
+ * @date 2019/03/09 17:20
+ * @uses The compact protocol, the packet header is varint id, varint length
+ *       and one byte index(3 bytes for most packets, basic is 6).
+ *       Enable by handshake(see packet::Handshake::kFlagCompact), not work
+ *       with the compress mode.
+*/
+#ifndef PF_NET_PROTOCOL_COMPACT_H_
+#define PF_NET_PROTOCOL_COMPACT_H_
+
+#include "pf/net/protocol/config.h"
+#include "pf/net/protocol/basic.h"
+
+//id(3) + length(4, max 0xffffff) + index(1)
+#define NET_PACKET_COMPACT_HEADERSIZE_MAX (8)
+
+namespace pf_net {
+
+namespace protocol {
+
+class PF_API Compact : public Basic {
+
+ public:
+   Compact() {};
+   virtual ~Compact() {};
+
+ public:
+   virtual bool compress(connection::Basic *connection, 
+                         char *uncompress_buffer, 
+                         char *compress_buffer);
+   virtual size_t header_size() const { 
+     return NET_PACKET_COMPACT_HEADERSIZE_MAX; 
+   };
+
+ protected:
+   virtual int32_t peek_header(stream::Input &istream, header_t &header);
+   virtual uint32_t write_header(stream::Output &ostream, 
+                                 const header_t &header);
+
+};
+
+} //namespace protocol
+
+} //namespace pf_net
+
+#endif //PF_NET_PROTOCOL_COMPACT_H_
@@ -19,6 +19,18 @@ namespace protocol {
 
 class Interface;
 class Basic;
+class Compact;
+class Http;
+
+//The packet header fields, the wire layout decided by protocol.
+struct header_struct {
+  uint16_t id;
+  uint32_t size;
+  uint32_t index;
+  header_struct() : id{0}, size{0}, index{0} {};
+};
+
+using header_t = header_struct;
 
 } //namespace protocol
 
@@ -0,0 +1,63 @@
+/**
+ * PLAIN FRAMEWORK ( https://github.com/viticm/plainframework )
+ * $Id http.h
+ * @link https://github.com/viticm/plainframework for the canonical source repository
+ * @copyright Copyright (c) 2014- viticm( viticm.ti@gmail.com )
+ * @license
+ * @user viticm<viticm.ti@gmail.com>
+ * @date 2019/03/30 14:20
+ * @uses The minimal HTTP/1.0 protocol for the admin listener(like metrics),
+ *       only GET, one request each connection and close after response.
+*/
+#ifndef PF_NET_PROTOCOL_HTTP_H_
+#define PF_NET_PROTOCOL_HTTP_H_
+
+#include "pf/net/protocol/interface.h"
+
+#define NET_PROTOCOL_HTTP_REQUEST_MAX (8 * 1024)
+
+namespace pf_net {
+
+namespace protocol {
+
+class PF_API Http : public Interface {
+
+ public:
+   //Return false then response 404, the content type default is text/plain.
+   using handler_t = std::function<
+     bool (const std::string &path, std::string &content)>;
+
+ public:
+   Http() : content_type_{"text/plain; charset=utf-8"} {};
+   virtual ~Http() {};
+
+ public:
+   virtual bool command(connection::Basic *connection, uint16_t count);
+   virtual bool compress(connection::Basic *, char *, char *) {
+     return false;
+   };
+   virtual bool send(connection::Basic *, packet::Interface *) {
+     return false;
+   };
+   virtual size_t header_size() const { return 0; };
+
+ public:
+   void set_handler(handler_t handler) { handler_ = handler; };
+   void set_content_type(const std::string &type) { content_type_ = type; };
+
+ private:
+   bool response(connection::Basic *connection,
+                 const std::string &status,
+                 const std::string &content);
+
+ private:
+   handler_t handler_;
+   std::string content_type_;
+
+};
+
+} //namespace protocol
+
+} //namespace pf_net
+
+#endif //PF_NET_PROTOCOL_HTTP_H_
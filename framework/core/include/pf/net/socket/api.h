@@ -15,6 +15,7 @@
 
 #if OS_UNIX
 #include <netinet/in.h>
+#include <netinet/tcp.h>
 #include <arpa/inet.h>
 #include <sys/types.h>
 #include <sys/socket.h>
@@ -58,6 +58,9 @@ class PF_API Basic {
    bool set_receive_buffer_size(uint32_t size);
    uint32_t get_send_buffer_size() const;
    bool set_send_buffer_size(uint32_t size);
+   bool is_nodelay() const;
+   bool set_nodelay(bool on = true);
+   bool set_cork(bool on = true); //Linux only, others return false.
    uint16_t port() const { return port_; };
    uint64_t uint64host() const;
    const char *host() { return host_; };
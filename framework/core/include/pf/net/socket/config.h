@@ -36,6 +36,7 @@
 #define SOCKET_WOULD_BLOCK EWOULDBLOCK //api use SOCKET_ERROR_WOULD_BLOCK
 #define SOCKET_CONNECT_ERROR EINPROGRESS
 #define SOCKET_CONNECT_TIMEOUT 10
+#define SOCKET_LISTEN_BACKLOG 128 //The kernel drop the SYN when queue full.
 
 namespace pf_net {
 
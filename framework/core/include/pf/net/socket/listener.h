@@ -24,7 +24,9 @@ class PF_API Listener {
    ~Listener();
 
  public:
-   bool init(uint16_t port, const std::string &ip = "", uint32_t backlog = 5);
+   bool init(uint16_t port, const std::string &ip = "", uint32_t backlog = SOCKET_LISTEN_BACKLOG);
+   //Use the listening socket(from the old process).
+   bool attach(int32_t id, uint16_t port, const std::string &ip = "");
    void close();
    bool accept(pf_net::socket::Basic *socket);
    uint32_t get_linger() const;
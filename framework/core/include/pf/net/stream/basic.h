@@ -64,6 +64,9 @@ class PF_API Basic {
    };
    bool isinit() const { return isinit_; };
    void set_isinit(bool _isinit) {  isinit_ = _isinit; };
+   //The packets use varint when compact(same as the connection protocol).
+   bool compact() const { return compact_; };
+   void set_compact(bool _compact) { compact_ = _compact; };
 
  protected:
    socket::Basic *socket_;
@@ -74,6 +77,7 @@ class PF_API Basic {
    uint64_t send_bytes_;
    uint64_t receive_bytes_;
    bool isinit_;
+   bool compact_;
 
 };
 
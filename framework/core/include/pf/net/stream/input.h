@@ -11,6 +11,7 @@
 #ifndef PF_NET_STREAM_INPUTSTREAM_H_
 #define PF_NET_STREAM_INPUTSTREAM_H_
 
+#include <type_traits>
 #include "pf/net/packet/interface.h"
 #include "pf/net/stream/basic.h"
 
@@ -44,10 +45,40 @@ class PF_API Input : public Basic {
    uint32_t read_uint32();
    int64_t read_int64();
    uint64_t read_uint64();
-   void read_string(char *buffer, size_t size);
+   //False if the length more than size(skip it) or not enough data.
+   bool read_string(char *buffer, size_t size);
    float read_float();
    double read_double();
    uint32_t read_bytes(unsigned char *buffer, size_t size);
+   bool read_bytes(unsigned char *buffer, size_t size, uint32_t &length);
+
+ public: //varint(LEB128)，与Output::write_var*对应
+   //False if malformed or not enough data(not skip), the packet read fail.
+   bool read_varuint32(uint32_t &value);
+   bool read_varint32(int32_t &value);
+   bool read_varuint64(uint64_t &value);
+   bool read_varint64(int64_t &value);
+   //The 0 if failed.
+   uint32_t read_varuint32();
+   int32_t read_varint32();
+   uint64_t read_varuint64();
+   int64_t read_varint64();
+   bool read_varuint32_array(uint32_t *values, uint32_t count);
+
+ public: //POD块读取，与Output::write_pod对应
+   template <typename T>
+   bool read_pod(T &value) {
+     static_assert(std::is_pod<T>::value, "read_pod need a POD type");
+     uint32_t length = static_cast<uint32_t>(sizeof(T));
+     return read(reinterpret_cast<char *>(&value), length) == length;
+   };
+   template <typename T>
+   bool read_pod_array(T *values, uint32_t count) {
+     static_assert(std::is_pod<T>::value, "read_pod_array need a POD type");
+     if (0 == count) return true;
+     uint32_t length = static_cast<uint32_t>(sizeof(T) * count);
+     return read(reinterpret_cast<char *>(values), length) == length;
+   };
 
  public:
    //some useful.
@@ -11,6 +11,7 @@
 #ifndef PF_NET_STREAM_OUTPUTSTREAM_H_
 #define PF_NET_STREAM_OUTPUTSTREAM_H_
 
+#include <type_traits>
 #include "pf/net/packet/interface.h"
 #include "pf/net/stream/basic.h"
 
@@ -35,6 +36,10 @@ class PF_API Output : public Basic {
    uint32_t write(const char *buffer, uint32_t length);
    //bool writepacket(packet::Base *packet); change this to protocol.
    int32_t flush();
+   //把头部length字节转移到目标流（按目标流的加密设置写入）
+   uint32_t transfer(Output &target, uint32_t length);
+   //Drop the last length bytes(not flushed), false if encrypted or compressed.
+   bool rollback(uint32_t length);
 
  public: //write_*常用方法
    bool write_int8(int8_t value);
@@ -50,6 +55,28 @@ class PF_API Output : public Basic {
    bool write_dobule(double value);
    bool write_bytes(const unsigned char *value, size_t size);
 
+ public: //varint(LEB128)，有符号数使用zigzag，紧凑模式使用
+   bool write_varuint32(uint32_t value);
+   bool write_varint32(int32_t value);
+   bool write_varuint64(uint64_t value);
+   bool write_varint64(int64_t value);
+   bool write_varuint32_array(const uint32_t *values, uint32_t count);
+
+ public: //POD块写入，一次边界检查和一次拷贝（替代逐字段写入）
+   template <typename T>
+   bool write_pod(const T &value) {
+     static_assert(std::is_pod<T>::value, "write_pod need a POD type");
+     uint32_t length = static_cast<uint32_t>(sizeof(T));
+     return write(reinterpret_cast<const char *>(&value), length) == length;
+   };
+   template <typename T>
+   bool write_pod_array(const T *values, uint32_t count) {
+     static_assert(std::is_pod<T>::value, "write_pod_array need a POD type");
+     if (0 == count) return true;
+     uint32_t length = static_cast<uint32_t>(sizeof(T) * count);
+     return write(reinterpret_cast<const char *>(values), length) == length;
+   };
+
  public:
    Output &operator << (bool var) {
      write_int8(var ? 1 : 0);
@@ -0,0 +1,154 @@
+/**
+ * PLAIN FRAMEWORK ( https://github.com/viticm/plainframework )
+ * $Id varint.h
+ * @link https://github.com/viticm/plainframework for the canonical source repository
+ * @copyright Copyright (c) 2014- viticm( viticm.ti@gmail.com )
+ * @license
+ * @user viticm<viticm.ti@gmail.com>
+ * @date 2019/03/09 16:42
+ * @uses The LEB128 varint and zigzag encoding for the compact wire mode.
+ *       无符号整数每字节7位，最高位为继续标志；有符号整数先做zigzag变换，
+ *       使小的负数也只占很少的字节。
+ */
+#ifndef PF_NET_STREAM_VARINT_H_
+#define PF_NET_STREAM_VARINT_H_
+
+#include "pf/net/stream/config.h"
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#define NET_STREAM_VARINT32_SIZEMAX (5)
+#define NET_STREAM_VARINT64_SIZEMAX (10)
+
+namespace pf_net {
+
+namespace stream {
+
+namespace varint {
+
+inline uint32_t zigzag_encode32(int32_t value) {
+  return (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31);
+}
+
+inline int32_t zigzag_decode32(uint32_t value) {
+  return static_cast<int32_t>((value >> 1) ^ (~(value & 1) + 1));
+}
+
+inline uint64_t zigzag_encode64(int64_t value) {
+  return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+inline int64_t zigzag_decode64(uint64_t value) {
+  return static_cast<int64_t>((value >> 1) ^ (~(value & 1) + 1));
+}
+
+//Encode the value to buffer(need NET_STREAM_VARINT64_SIZEMAX bytes at most),
+//return the encoded bytes.
+inline uint32_t encode64(uint64_t value, char *buffer) {
+  uint32_t length = 0;
+  while (value >= 0x80) {
+    buffer[length++] = static_cast<char>((value & 0x7f) | 0x80);
+    value >>= 7;
+  }
+  buffer[length++] = static_cast<char>(value);
+  return length;
+}
+
+inline uint32_t encode32(uint32_t value, char *buffer) {
+  return encode64(value, buffer);
+}
+
+inline uint32_t size64(uint64_t value) {
+  uint32_t length = 1;
+  while (value >= 0x80) {
+    value >>= 7;
+    ++length;
+  }
+  return length;
+}
+
+inline uint32_t size32(uint32_t value) { return size64(value); }
+
+//Decode one value from buffer, return the used bytes.
+//0: not enough bytes, -1: the value is overlong(malformed).
+inline int32_t decode64(const char *buffer,
+                        uint32_t size,
+                        uint64_t &value,
+                        uint32_t sizemax = NET_STREAM_VARINT64_SIZEMAX) {
+  uint64_t result = 0;
+  uint32_t i = 0;
+  for (; i < size && i < sizemax; ++i) {
+    uint8_t byte = static_cast<uint8_t>(buffer[i]);
+    if (9 == i && byte > 1) return -1; //The 10th byte only has 1 bit.
+    result |= static_cast<uint64_t>(byte & 0x7f) << (7 * i);
+    if (byte < 0x80) {
+      value = result;
+      return static_cast<int32_t>(i + 1);
+    }
+  }
+  return i >= sizemax ? -1 : 0;
+}
+
+inline int32_t decode32(const char *buffer, uint32_t size, uint32_t &value) {
+  uint64_t result = 0;
+  auto length = decode64(buffer, size, result, NET_STREAM_VARINT32_SIZEMAX);
+  if (length > 0) {
+    if (result > 0xffffffff) return -1;
+    value = static_cast<uint32_t>(result);
+  }
+  return length;
+}
+
+//Decode values as many as possible, stop at the incomplete value.
+//The used bytes saved in consumed, return the decoded count(-1 malformed).
+inline int32_t decode32_array(const char *buffer,
+                              uint32_t size,
+                              uint32_t *values,
+                              uint32_t count,
+                              uint32_t &consumed) {
+  uint32_t position = 0;
+  uint32_t decoded = 0;
+  while (decoded < count && position < size) {
+#if defined(__SSE2__)
+    //Mostly small values, 16 single byte values can expand at once.
+    if (count - decoded >= 16 && size - position >= 16) {
+      __m128i bytes = _mm_loadu_si128(
+          reinterpret_cast<const __m128i *>(buffer + position));
+      uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(bytes));
+      if (0 == mask) {
+        __m128i zero = _mm_setzero_si128();
+        __m128i low = _mm_unpacklo_epi8(bytes, zero);
+        __m128i high = _mm_unpackhi_epi8(bytes, zero);
+        __m128i *out = reinterpret_cast<__m128i *>(values + decoded);
+        _mm_storeu_si128(out, _mm_unpacklo_epi16(low, zero));
+        _mm_storeu_si128(out + 1, _mm_unpackhi_epi16(low, zero));
+        _mm_storeu_si128(out + 2, _mm_unpacklo_epi16(high, zero));
+        _mm_storeu_si128(out + 3, _mm_unpackhi_epi16(high, zero));
+        decoded += 16;
+        position += 16;
+        continue;
+      }
+      uint32_t singles = static_cast<uint32_t>(__builtin_ctz(mask));
+      for (uint32_t i = 0; i < singles; ++i)
+        values[decoded++] = static_cast<uint8_t>(buffer[position++]);
+    }
+#endif
+    auto length =
+      decode32(buffer + position, size - position, values[decoded]);
+    if (length < 0) return -1;
+    if (0 == length) break;
+    position += static_cast<uint32_t>(length);
+    ++decoded;
+  }
+  consumed = position;
+  return static_cast<int32_t>(decoded);
+}
+
+} //namespace varint
+
+} //namespace stream
+
+} //namespace pf_net
+
+#endif //PF_NET_STREAM_VARINT_H_
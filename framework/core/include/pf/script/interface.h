@@ -51,10 +51,13 @@ class PF_API Interface {
 
  public:
    pf_basic::TaskQueue *task_queue() { return &task_queue_; }
+   //The env run in one thread at once(the tick and the tasks wakeup).
+   std::mutex &mutex() { return mutex_; }
 
  private:
    //Task queue can safe call in diffrent thead for script.
    pf_basic::TaskQueue task_queue_;
+   std::mutex mutex_;
 
 };
 
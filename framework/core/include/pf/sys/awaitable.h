@@ -0,0 +1,134 @@
+/**
+ * PLAIN FRAMEWORK ( https://github.com/viticm/plainframework )
+ * $Id awaitable.h
+ * @link https://github.com/viticm/plainframework for the canonical source repository
+ * @copyright Copyright (c) 2014- viticm( viticm.ti@gmail.com )
+ * @license
+ * @user viticm<viticm.ti@gmail.com>
+ * @date 2019/04/15 10:21
+ * @uses The awaitable result of async job(db query, cache load, send, timer),
+ *       the continuation resume by the resumer of the thread which created it
+ *       (net manager tick, executor worker), so the handler not block the loop.
+ *       c++11没有协程，使用then链式调用代替co_await：
+ *       ENGINE_POINTER->query(sql).then([](db_result_t &result) {
+ *         ...
+ *         return ENGINE_POINTER->delay(100);
+ *       }).then([](bool) { ... }).on_error([](const std::string &error) {
+ *         ...
+ *       });
+ *       失败（set_error）时跳过后续的then，错误传递到链尾的on_error。
+ */
+#ifndef PF_SYS_AWAITABLE_H_
+#define PF_SYS_AWAITABLE_H_
+
+#include "pf/sys/config.h"
+
+namespace pf_sys {
+
+//Resume the function in somewhere(as post it to a loop).
+using resumer_t = std::function<void(const std::function<void()> &)>;
+
+//The resumer of current thread, empty is resume inline(in the thread which
+//set the value).
+PF_API resumer_t &current_resumer();
+
+//Set the current resumer in the scope, the loop set it before run handlers.
+class PF_API ResumerGuard {
+
+ public:
+   explicit ResumerGuard(const resumer_t &resumer);
+   ~ResumerGuard();
+
+ private:
+   resumer_t last_;
+
+};
+
+template<class T> class Awaitable;
+template<class T> class Promise;
+
+template<class T>
+struct await_state_struct {
+  std::mutex mutex;
+  bool ready;
+  T value;
+  bool failed;
+  std::string error;
+  bool resume;
+  resumer_t resumer;
+  std::function<void(T &)> continuation;
+  await_state_struct() : ready{false}, value{}, failed{false}, resume{true} {}
+};
+
+template<class R> struct await_deliver;
+
+//The then result type: void is bool and the awaitable is unwrapped.
+template<class T>
+struct await_unwrap { using type = T; };
+
+template<class T>
+struct await_unwrap< Awaitable<T> > { using type = T; };
+
+template<>
+struct await_unwrap<void> { using type = bool; };
+
+template<class T>
+class Awaitable {
+
+ public:
+   using state_t = await_state_struct<T>;
+
+ public:
+   Awaitable() {}
+   explicit Awaitable(const std::shared_ptr<state_t> &state) : state_{state} {}
+
+ public:
+   bool valid() const { return static_cast<bool>(state_); }
+   bool ready() const;
+   //Ready with the error(not the value).
+   bool failed() const;
+   std::string error() const;
+   //Resume in the resumer instead of the creator's.
+   Awaitable &via(const resumer_t &resumer);
+   //Resume the function with the value when it ready, the result is the
+   //awaitable of the function result, so the steps can chain without nested.
+   template<class F>
+   auto then(F &&f)
+   -> Awaitable<
+     typename await_unwrap<typename std::result_of<F(T &)>::type>::type>;
+   //Run the function when ready, not resume is run in the thread set value.
+   void on_ready(const std::function<void(T &)> &function, bool resume = true);
+   //Resume the function with the error if failed, use it in the chain end.
+   void on_error(const std::function<void(const std::string &)> &function);
+
+ private:
+   template<class R> friend struct await_deliver;
+   std::shared_ptr<state_t> state_;
+
+};
+
+template<class T>
+class Promise {
+
+ public:
+   //Resume in the current resumer.
+   Promise();
+   explicit Promise(const resumer_t &resumer);
+
+ public:
+   Awaitable<T> awaitable() const { return Awaitable<T>(state_); }
+   //Only set once(value or error), not resume is run the continuation
+   //directly.
+   void set_value(const T &value, bool resume = true);
+   void set_error(const std::string &error, bool resume = true);
+
+ private:
+   std::shared_ptr< await_state_struct<T> > state_;
+
+};
+
+} //namespace pf_sys
+
+#include "pf/sys/awaitable.tcc"
+
+#endif //PF_SYS_AWAITABLE_H_
@@ -0,0 +1,194 @@
+/**
+ * PLAIN FRAMEWORK ( https://github.com/viticm/plainframework )
+ * $Id awaitable.tcc
+ * @link https://github.com/viticm/plainframework for the canonical source repository
+ * @copyright Copyright (c) 2014- viticm( viticm.ti@gmail.com )
+ * @license
+ * @user viticm<viticm.ti@gmail.com>
+ * @date 2019/04/15 10:21
+ * @uses The awaitable template implement.
+ */
+#ifndef PF_SYS_AWAITABLE_TCC_
+#define PF_SYS_AWAITABLE_TCC_
+
+#include "pf/sys/awaitable.h"
+
+namespace pf_sys {
+
+template<class T>
+void await_dispatch(const std::shared_ptr< await_state_struct<T> > &state,
+                    const std::function<void(T &)> &function,
+                    bool resume) {
+  if (resume && state->resumer) {
+    auto pointer = state;
+    state->resumer([pointer, function]() { function(pointer->value); });
+  } else {
+    function(state->value);
+  }
+}
+
+//Set the next promise from the then function result.
+template<class R>
+struct await_deliver {
+  template<class F, class T>
+  static void run(F &f, T &value, Promise<R> &next) {
+    next.set_value(f(value), false); //Already resumed.
+  }
+};
+
+template<>
+struct await_deliver<void> {
+  template<class F, class T>
+  static void run(F &f, T &value, Promise<bool> &next) {
+    f(value);
+    next.set_value(true, false);
+  }
+};
+
+template<class U>
+struct await_deliver< Awaitable<U> > {
+  template<class F, class T>
+  static void run(F &f, T &value, Promise<U> &next) {
+    auto awaitable = f(value);
+    if (!awaitable.valid()) {
+      next.set_error("then function return an invalid awaitable", false);
+      return;
+    }
+    auto promise = next;
+    auto state = awaitable.state_.get(); //Alive when the continuation run.
+    awaitable.on_ready([promise, state](U &result) mutable {
+      if (state->failed) {
+        promise.set_error(state->error);
+      } else {
+        promise.set_value(result);
+      }
+    }, false);
+  }
+};
+
+template<class T>
+bool Awaitable<T>::ready() const {
+  if (!state_) return false;
+  std::unique_lock<std::mutex> autolock(state_->mutex);
+  return state_->ready;
+}
+
+template<class T>
+bool Awaitable<T>::failed() const {
+  if (!state_) return false;
+  std::unique_lock<std::mutex> autolock(state_->mutex);
+  return state_->ready && state_->failed;
+}
+
+template<class T>
+std::string Awaitable<T>::error() const {
+  if (!state_) return "";
+  std::unique_lock<std::mutex> autolock(state_->mutex);
+  return state_->error;
+}
+
+template<class T>
+Awaitable<T> &Awaitable<T>::via(const resumer_t &resumer) {
+  if (state_) {
+    std::unique_lock<std::mutex> autolock(state_->mutex);
+    state_->resumer = resumer;
+  }
+  return *this;
+}
+
+template<class T>
+template<class F>
+auto Awaitable<T>::then(F &&f)
+-> Awaitable<
+  typename await_unwrap<typename std::result_of<F(T &)>::type>::type> {
+  using result_t = typename std::result_of<F(T &)>::type;
+  using next_t = typename await_unwrap<result_t>::type;
+  if (!state_) return Awaitable<next_t>();
+  resumer_t resumer;
+  {
+    std::unique_lock<std::mutex> autolock(state_->mutex);
+    resumer = state_->resumer;
+  }
+  Promise<next_t> next(resumer); //The chain resume in the same place.
+  typename std::decay<F>::type function(std::forward<F>(f));
+  auto state = state_.get(); //Alive when the continuation run.
+  on_ready([function, next, state](T &value) mutable {
+    if (state->failed) {
+      next.set_error(state->error, false); //Skip the function.
+      return;
+    }
+    await_deliver<result_t>::run(function, value, next);
+  });
+  return next.awaitable();
+}
+
+template<class T>
+void Awaitable<T>::on_ready(const std::function<void(T &)> &function,
+                            bool resume) {
+  if (!state_) return;
+  {
+    std::unique_lock<std::mutex> autolock(state_->mutex);
+    if (!state_->ready) {
+      state_->continuation = function;
+      state_->resume = resume;
+      return;
+    }
+  }
+  await_dispatch(state_, function, resume);
+}
+
+template<class T>
+void Awaitable<T>::on_error(
+    const std::function<void(const std::string &)> &function) {
+  if (!state_) return;
+  auto state = state_.get();
+  on_ready([state, function](T &) {
+    if (state->failed) function(state->error);
+  });
+}
+
+template<class T>
+Promise<T>::Promise() : state_{std::make_shared< await_state_struct<T> >()} {
+  state_->resumer = current_resumer();
+}
+
+template<class T>
+Promise<T>::Promise(const resumer_t &resumer) :
+  state_{std::make_shared< await_state_struct<T> >()} {
+  state_->resumer = resumer;
+}
+
+template<class T>
+void Promise<T>::set_value(const T &value, bool resume) {
+  std::function<void(T &)> continuation;
+  {
+    std::unique_lock<std::mutex> autolock(state_->mutex);
+    if (state_->ready) return;
+    state_->value = value;
+    state_->ready = true;
+    continuation = std::move(state_->continuation);
+    state_->continuation = nullptr;
+    resume = resume && state_->resume;
+  }
+  if (continuation) await_dispatch(state_, continuation, resume);
+}
+
+template<class T>
+void Promise<T>::set_error(const std::string &error, bool resume) {
+  std::function<void(T &)> continuation;
+  {
+    std::unique_lock<std::mutex> autolock(state_->mutex);
+    if (state_->ready) return;
+    state_->failed = true;
+    state_->error = error;
+    state_->ready = true;
+    continuation = std::move(state_->continuation);
+    state_->continuation = nullptr;
+    resume = resume && state_->resume;
+  }
+  if (continuation) await_dispatch(state_, continuation, resume);
+}
+
+} //namespace pf_sys
+
+#endif //PF_SYS_AWAITABLE_TCC_
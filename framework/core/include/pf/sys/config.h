@@ -13,10 +13,13 @@
 
 #include "pf/basic/config.h"
 
+#define SYS_MODULENAME "sys"
+
 namespace pf_sys {
 
 class ThreadCollect;
 class ThreadPool;
+class Executor;
 
 enum {
   kThreadStatusStop = 0,
@@ -0,0 +1,88 @@
+/**
+ * PLAIN FRAMEWORK ( https://github.com/viticm/plainframework )
+ * $Id executor.h
+ * @link https://github.com/viticm/plainframework for the canonical source repository
+ * @copyright Copyright (c) 2014- viticm( viticm.ti@gmail.com )
+ * @license
+ * @user viticm<viticm.ti@gmail.com>
+ * @date 2019/04/11 09:47
+ * @uses The work stealing executor, each worker has a task deque(the owner
+ *       pop from back and the others steal from front), the idle workers
+ *       park until new task or the next timer.
+ *       周期任务（如子系统的tick）完成后才重新计时，同一个周期任务不会并行执行。
+ */
+#ifndef PF_SYS_EXECUTOR_H_
+#define PF_SYS_EXECUTOR_H_
+
+#include "pf/sys/config.h"
+
+namespace pf_sys {
+
+class PF_API Executor {
+
+ public:
+   explicit Executor(size_t count);
+   ~Executor();
+
+ public:
+   //The hint is the prefer worker index(modulo the count), -1 is the current
+   //worker(submit in worker) or round robin.
+   void submit(const std::function<void()> &task, int32_t hint = -1);
+   template<class F, class... Args>
+   auto async(F&& f, Args&&... args)
+   -> std::future<typename std::result_of<F(Args...)>::type>;
+   //Run the function every interval(ms) until it return false or stop.
+   void every(uint32_t interval,
+              const std::function<bool()> &function,
+              int32_t hint = -1);
+   //Not accept new task, the workers exit after the queued tasks finished.
+   void stop();
+   size_t size() const { return workers_.size(); }
+   //The worker index of current thread in this executor, -1 is not.
+   int32_t current() const;
+
+ private:
+   struct worker_struct {
+     std::mutex mutex;
+     std::deque< std::function<void()> > tasks;
+   };
+   using worker_t = worker_struct;
+   struct tick_struct {
+     uint64_t deadline; //ns, steady clock.
+     uint64_t interval; //ns.
+     int32_t hint;
+     std::function<bool()> function;
+     bool operator > (const tick_struct &object) const {
+       return deadline > object.deadline;
+     };
+   };
+   using tick_t = tick_struct;
+
+ private:
+   void work(size_t index);
+   bool pop(size_t index, std::function<void()> &task);
+   void push(size_t index, std::function<void()> &&task);
+   void fire(uint64_t now);
+   void arm(tick_t &&tick);
+   static uint64_t now();
+
+ private:
+   std::vector< std::unique_ptr<worker_t> > workers_;
+   std::vector< std::thread > threads_;
+   std::mutex mutex_; //For park and ticks.
+   std::condition_variable condition_;
+   std::priority_queue<
+     tick_t, std::vector<tick_t>, std::greater<tick_t> > ticks_;
+   std::atomic<uint64_t> next_deadline_;
+   std::atomic<uint32_t> pending_;
+   std::atomic<uint32_t> sleepers_;
+   std::atomic<uint32_t> next_;
+   std::atomic<bool> stop_;
+
+};
+
+} //namespace pf_sys
+
+#include "pf/sys/executor.tcc"
+
+#endif //PF_SYS_EXECUTOR_H_
@@ -0,0 +1,33 @@
+/**
+ * PLAIN FRAMEWORK ( https://github.com/viticm/plainframework )
+ * $Id executor.tcc
+ * @link https://github.com/viticm/plainframework for the canonical source repository
+ * @copyright Copyright (c) 2014- viticm( viticm.ti@gmail.com )
+ * @license
+ * @user viticm<viticm.ti@gmail.com>
+ * @date 2019/04/11 09:47
+ * @uses The work stealing executor template implement.
+ */
+#ifndef PF_SYS_EXECUTOR_TCC_
+#define PF_SYS_EXECUTOR_TCC_
+
+#include "pf/sys/executor.h"
+
+namespace pf_sys {
+
+template<class F, class... Args>
+auto Executor::async(F&& f, Args&&... args)
+-> std::future<typename std::result_of<F(Args...)>::type> {
+  using return_type = typename std::result_of<F(Args...)>::type;
+  auto task = std::make_shared< std::packaged_task<return_type()> >(
+      std::bind(std::forward<F>(f), std::forward<Args>(args)...)
+    );
+  std::future<return_type> res = task->get_future();
+  if (stop_) throw std::runtime_error("async on stopped Executor");
+  submit([task](){ (*task)(); });
+  return res;
+}
+
+} //namespace pf_sys
+
+#endif //PF_SYS_EXECUTOR_TCC_
@@ -34,6 +34,7 @@ PF_API void get_filename(char *filename, size_t size);
 PF_API float get_cpu_usage(int32_t id);
 PF_API uint64_t get_virtualmemory_usage(int32_t id);
 PF_API uint64_t get_physicalmemory_usage(int32_t id);
+PF_API uint64_t get_cpu_time(int32_t id); //The user and system time(ms).
 PF_API bool daemon();
 
 inline void print_curinfo() {
@@ -17,9 +17,27 @@
 
 namespace pf_sys {
 
+namespace thread {
+
+//Pin the current thread to the cpus("2,3" or "4-7") of the committed config
+//default.engine.affinity.<name>(without index as "executor" for "executor0"),
+//and use the local numa memory if default.engine.numa.policy is "local".
+PF_API bool bind(const std::string &name);
+PF_API bool set_affinity(const std::string &cpus);
+PF_API bool set_numa_local();
+
+//Write the stack of the thread to the fd(signal it with SIGUSR2 and wait
+//the handler write, not more than timeout ms), linux only.
+PF_API bool dump_stack(std::thread::native_handle_type handle, 
+                       int32_t fd, 
+                       uint32_t timeout = 100);
+
+} //namespace thread
+
 class PF_API ThreadPool {
  public:
-   ThreadPool(size_t);
+   //The workers bind with the name if not empty.
+   explicit ThreadPool(size_t, const std::string &name = "");
    template<class F, class... Args>
    auto enqueue(F&& f, Args&&... args) 
    -> std::future<typename std::result_of<F(Args...)>::type>;
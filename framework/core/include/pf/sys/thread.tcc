@@ -18,11 +18,12 @@
 namespace pf_sys {
 
 // the constructor just launches some amount of workers
-inline ThreadPool::ThreadPool(size_t threads)
+inline ThreadPool::ThreadPool(size_t threads, const std::string &name)
   : stop_(false) {
   for(size_t i = 0; i < threads; ++i)
     workers_.emplace_back(
-      [this] {
+      [this, name] {
+        thread::bind(name);
         for(;;) {
           std::function<void()> task;
           {
@@ -119,6 +120,12 @@ inline void start() {
   GLOBALS[_status_key] = kThreadStatusRun;
 }
 
+//Start in the thread with the affinity and numa policy.
+inline void start(const std::string &name) {
+  start();
+  bind(name);
+}
+
 inline void stop() {
   const std::string _status_key = status_key();
   GLOBALS[_status_key] = kThreadStatusStop;
@@ -14,22 +14,51 @@
  * GLOBALS["app.forceexit"] = bool;               //default false.
  * GLOBALS["app.console"] = bool;				          //default true.
  * GLOBALS["app.pidfile"] = string;               //default "".
+ * GLOBALS["app.upgrade"] = bool;                 //default false(--upgrade).
  * GLOBALS["log.active"] = bool;                  //default true.
  * GLOBALS["log.directory"] = number;             //default the exe file path with "/log".
  * GLOBALS["log.singlefile"] = bool;              //default false.
  * GLOBALS["log.fast"] = bool;                    //default true.
  * GLOBALS["log.print"] = bool;                   //default true.
  * GLOBALS["log.clear"] = bool;                   //default false.
+ * GLOBALS["log.binary"] = bool;                  //default false(BINARY_LOG to .blog).
+ * GLOBALS["log.mapsize"] = number;               //default 4(MB, the mapped region of the file).
+ * GLOBALS["log.rotatesize"] = number;            //default 256(MB, 0 only the hour).
+ * GLOBALS["log.compress"] = bool;                //default true(the rotated files to .gz).
+ * GLOBALS["log.keepfiles"] = number;             //default 8(the size rotated, 0 all).
+ * GLOBALS["log.keepdays"] = number;              //default 0(the day directories, 0 all).
+ * GLOBALS["log.ringsize"] = number;              //default 1024(KB, each thread buffer, min 64).
  * GLOBALS["cache.gsinit"] = bool;                //default false.
  * GLOBALS["thread.collects"] = number;           //default 0.
  * GLOBALS["default.engine.frame"] = number;      //default 100.
  * GLOBALS["default.engine.fps"] = bool;          //default false.
+ * GLOBALS["default.engine.taskbudget"] = number; //default 1024(0 no limit).
+ * GLOBALS["default.engine.workers"] = number;    //default 0(thread each).
+ * GLOBALS["default.engine.affinity.<name>"] = string; //cpus "2,3" or "4-7".
+ * GLOBALS["default.engine.numa.policy"] = string; //default ""(or "local").
+ * GLOBALS["default.engine.initparallel"] = bool; //default false.
+ * GLOBALS["default.engine.trace"] = bool;        //default false.
+ * GLOBALS["default.engine.watchdog"] = number;   //default 0(closed), frames.
  * GLOBALS["default.net.open"] = bool;            //default false.
  * GLOBALS["default.net.service"] = bool;         //default false.
  * GLOBALS["default.net.ip"] = string;            //default "".
  * GLOBALS["default.net.port"] = number;          //default 0.
  * GLOBALS["default.net.connmax"] = number;       //default NET_CONNECTION_MAX.
  * GLOBALS["default.net.reconnect_time"] = number;//default 3.
+ * GLOBALS["default.net.compact"] = bool;         //default false.
+ * GLOBALS["default.net.nodelay"] = bool;         //default false.
+ * GLOBALS["default.net.sendpolicy"] = number;    //default 0(per tick).
+ * GLOBALS["default.net.limitrate"] = number;     //default 0(no limit).
+ * GLOBALS["default.net.limitburst"] = number;    //default 0.
+ * GLOBALS["default.net.limitaction"] = number;   //default 1(drop).
+ * GLOBALS["default.net.metrics"] = bool;         //default false.
+ * GLOBALS["default.net.metricsip"] = string;     //default "".
+ * GLOBALS["default.net.metricsport"] = number;   //default 0(closed).
+ * GLOBALS["default.net.capture"] = string;       //default ""(closed).
+ * GLOBALS["default.net.replay"] = string;        //default ""(replay, stop).
+ * GLOBALS["default.net.replayspeed"] = number;   //default 1(0 fastest).
+ * GLOBALS["default.net.handoff"] = string;       //default ""(closed).
+ * GLOBALS["default.net.handoffconn"] = bool;     //default false.
  * GLOBALS["default.script.open"] = bool;         //default false.
  * GLOBALS["default.script.rootpath"] = string;   //default SCRIPT_ROOT_PATH.
  * GLOBALS["default.script.workpath"] = string;   //default SCRIPT_WORK_PATH.
@@ -37,6 +66,7 @@
  * GLOBALS["default.script.reload"] = string;     //default "preload.lua".
  * GLOBALS["default.script.type"] = number;       //default -1.
  * GLOBALS["default.script.heartbeat"] = string;  //default "".
+ * GLOBALS["default.script.taskbudget"] = number; //default 1024(0 no limit).
  * GLOBALS["default.script.enter"] = string;      //default "main".
  * GLOBALS["default.script.netlost"] = string;    //default "plain_netlost".
  * GLOBALS["default.script.nethandler"] = string; //default "plain_nethandler".
@@ -85,6 +115,7 @@ void set_default_globals(type::variable_set_t &g) {
   g["app.forceexit"] = false;
   g["app.console"] = true;
   g["app.pidfile"] = "";
+  g["app.upgrade"] = false;
 
   g["log.active"] = true;
   g["log.directory"] = g["app.basepath"];
@@ -93,6 +124,13 @@ void set_default_globals(type::variable_set_t &g) {
   g["log.fast"] = true;
   g["log.print"] = true;
   g["log.clear"] = false;
+  g["log.binary"] = false;
+  g["log.mapsize"] = 4;
+  g["log.rotatesize"] = 256;
+  g["log.compress"] = true;
+  g["log.keepfiles"] = 8;
+  g["log.keepdays"] = 0;
+  g["log.ringsize"] = 1024;
 
   g["cache.gsinit"] = false;
 
@@ -100,12 +138,32 @@ void set_default_globals(type::variable_set_t &g) {
 
   g["default.engine.frame"] = 100;
   g["default.engine.fps"] = false;
+  g["default.engine.taskbudget"] = 1024;
+  g["default.engine.workers"] = 0;
+  g["default.engine.numa.policy"] = "";
+  g["default.engine.initparallel"] = false;
+  g["default.engine.trace"] = false;
+  g["default.engine.watchdog"] = 0;
   g["default.net.open"] = false;
   g["default.net.service"] = false;
   g["default.net.ip"] = "";
   g["default.net.port"] = 0;
   g["default.net.connmax"] = NET_CONNECTION_MAX;
   g["default.net.reconnect_time"] = 3;
+  g["default.net.compact"] = false;
+  g["default.net.nodelay"] = false;
+  g["default.net.sendpolicy"] = 0;
+  g["default.net.limitrate"] = 0;
+  g["default.net.limitburst"] = 0;
+  g["default.net.limitaction"] = 1;
+  g["default.net.metrics"] = false;
+  g["default.net.metricsip"] = "";
+  g["default.net.metricsport"] = 0;
+  g["default.net.capture"] = "";
+  g["default.net.replay"] = "";
+  g["default.net.replayspeed"] = 1;
+  g["default.net.handoff"] = "";
+  g["default.net.handoffconn"] = false;
   g["default.script.open"] = false;
   g["default.script.rootpath"] = SCRIPT_ROOT_PATH;
   g["default.script.workpath"] = SCRIPT_WORK_PATH;
@@ -116,6 +174,7 @@ void set_default_globals(type::variable_set_t &g) {
   g["default.script.nethandler"] = "plain_nethandler";
   g["default.script.netrouting"] = "plain_netrouting";
   g["default.script.enter"] = "main";
+  g["default.script.taskbudget"] = 1024;
   g["default.cache.open"] = false;
   g["default.cache.service"] = false;
   g["default.cache.conf"] = "";
@@ -137,8 +196,100 @@ void set_default_globals(type::variable_set_t &g) {
 
 type::variable_set_t &get_globals() {
   static type::variable_set_t vars;
-  set_default_globals(vars);
+  //Once(thread safe), the get not change the map.
+  static const bool inited = (set_default_globals(vars), true);
+  UNUSED(inited);
   return vars;
 }
 
+namespace config {
+
+namespace {
+
+std::mutex g_mutex; //The names and commit.
+std::vector<std::string> g_names;
+std::map<std::string, size_t> g_indexes;
+std::atomic<const snapshot_t *> g_snapshot{nullptr};
+//The old snapshots may still be read, commit is rare so keep them.
+std::vector< std::unique_ptr<snapshot_t> > g_snapshots;
+
+//The name absent is the default value, not insert it(the threads intern
+//the handles while the main thread may write the GLOBALS).
+void set_value(value_t &value, const std::string &name) {
+  auto &g = get_globals();
+  auto it = g.find(name);
+  if (it == g.end()) return;
+  auto &variable = it->second;
+  value.data = variable.data;
+  value.integer = variable._get<int64_t>();
+  value.number = variable._get<double>();
+  value.boolean = variable._get<bool>();
+}
+
+void publish_unlocked(std::unique_ptr<snapshot_t> &&pointer) {
+  g_snapshot.store(pointer.get(), std::memory_order_release);
+  g_snapshots.emplace_back(std::move(pointer));
+}
+
+void commit_unlocked() {
+  //All the names, the threads find them in the snapshot not the GLOBALS.
+  for (auto &it : get_globals()) {
+    if (g_indexes.find(it.first) != g_indexes.end()) continue;
+    g_indexes[it.first] = g_names.size();
+    g_names.push_back(it.first);
+  }
+  std::unique_ptr<snapshot_t> pointer(new snapshot_t);
+  pointer->values.resize(g_names.size());
+  for (size_t i = 0; i < g_names.size(); ++i)
+    set_value(pointer->values[i], g_names[i]);
+  publish_unlocked(std::move(pointer));
+}
+
+} //namespace
+
+size_t intern(const std::string &name) {
+  std::unique_lock<std::mutex> autolock(g_mutex);
+  auto it = g_indexes.find(name);
+  if (it != g_indexes.end()) return it->second;
+  auto index = g_names.size();
+  g_names.push_back(name);
+  g_indexes[name] = index;
+  //Only read the new name, the others not committed keep the last values.
+  std::unique_ptr<snapshot_t> pointer(new snapshot_t);
+  auto current = g_snapshot.load(std::memory_order_acquire);
+  if (current) *pointer = *current;
+  pointer->values.resize(g_names.size());
+  set_value(pointer->values[index], name);
+  publish_unlocked(std::move(pointer));
+  return index;
+}
+
+void commit() {
+  std::unique_lock<std::mutex> autolock(g_mutex);
+  commit_unlocked();
+}
+
+bool find(const std::string &name, value_t &value) {
+  size_t index{0};
+  {
+    std::unique_lock<std::mutex> autolock(g_mutex);
+    auto it = g_indexes.find(name);
+    if (it == g_indexes.end()) return false;
+    index = it->second;
+  }
+  auto pointer = snapshot();
+  if (index >= pointer->values.size()) return false;
+  value = pointer->values[index];
+  return true;
+}
+
+const snapshot_t *snapshot() {
+  auto result = g_snapshot.load(std::memory_order_acquire);
+  if (result != nullptr) return result;
+  commit();
+  return g_snapshot.load(std::memory_order_acquire);
+}
+
+} //namespace config
+
 }; //namespace pf_basic
@@ -1,7 +1,17 @@
 #include "pf/basic/util.h"
 #include "pf/basic/time_manager.h"
 #include "pf/sys/thread.h"
+#include "pf/basic/trace.h"
 #include "pf/basic/logger.h"
+#include <set>
+#if OS_UNIX
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <dirent.h>
+#endif
+#ifdef PF_OPEN_ZLIB
+#include <zlib.h>
+#endif
 
 std::unique_ptr< pf_basic::Logger > g_logger{nullptr};
 
@@ -20,84 +30,199 @@ Logger &Logger::getsingleton() {
   return *singleton_;
 }
 
-Logger::Logger() {
-  logids_.init(LOGTYPE_MAX);
-  log_position_.init(LOGTYPE_MAX);
-  logcache_.init(LOGTYPE_MAX);
-  loglock_.init(LOGTYPE_MAX);
-  cache_size_ = 0;
-}
+namespace {
 
-Logger::~Logger() {
-  cache_size_ = 0;
-  for (auto it = logcache_.begin(); it != logcache_.end(); ++it)
-    safe_delete_array(it->second);
-  for (auto it = loglock_.begin(); it != loglock_.end(); ++it)
-    safe_delete(it->second);
-}   
-   
-bool Logger::register_fastlog(const char *logname) {
-  uint8_t count = static_cast<uint8_t>(logids_.getcount());
-  if (count > logids_.get_maxcount()) return false;
-  if (logids_.isfind(logname)) return false;
-  uint8_t logid = count + 1;
-  logids_.add(logname, logid);
-  log_position_.add(logid, 0);
-  auto cache = new char[kDefaultLogCacheSize];
-  memset(cache, 0, kDefaultLogCacheSize);
-  logcache_.add(logid, cache);
-  auto mutex = new std::mutex;
-  loglock_.add(logid, mutex);
-  if (is_null(logcache_.get(logid))) return false;
-  return true;
-}
+std::atomic<uint64_t> g_buffer_serial{0};
 
-void Logger::get_log_timestr(char *time_str, int32_t length) {
-  if (TIME_MANAGER_POINTER) {
-      TIME_MANAGER_POINTER->reset_time();
-      auto runtime = TIME_MANAGER_POINTER->get_run_time();
-      snprintf(
-          time_str, 
-          length, 
-          "%.2d:%.2d:%.2d (%s %.4f)",
-          TIME_MANAGER_POINTER->get_hour(),
-          TIME_MANAGER_POINTER->get_minute(),
-          TIME_MANAGER_POINTER->get_second(),
-          pf_sys::thread::get_id().c_str(),
-          static_cast< float >(runtime) / 1000);
-  } else {
-    snprintf(time_str,
-             length, 
-             "00:00:00 (%s 0.0000)",
-             pf_sys::thread::get_id().c_str());
-  }
-}
+} //namespace
 
-bool Logger::init(int32_t cache_size) {
-  if (GLOBALS["log.clear"] == 1) {
-    char command[128] = {0};
+struct log_buffer_struct {
+  std::unique_ptr<uint64_t[]> data; //8 bytes aligned.
+  uint64_t capacity;
+  std::atomic<uint64_t> head;   //Only the owner thread write.
+  std::atomic<uint64_t> tail;   //Only the logger thread write.
+  std::atomic<bool> closed;     //The owner thread exited.
+  std::string thread_id;
+  uint64_t serial;              //The thread key of the .blog file.
+  log_buffer_struct(uint64_t _capacity) :
+    data{new uint64_t[_capacity / sizeof(uint64_t)]},
+    capacity{_capacity},
+    head{0},
+    tail{0},
+    closed{false},
+    thread_id{pf_sys::thread::get_id()},
+    serial{++g_buffer_serial} {}
+};
+
+//The log file sink, write to the pre-sized mapped region(unix), no write 
+//syscall and the pages in the page cache survive the process crash.
+struct log_file_struct {
+  std::string filename;
+  uint64_t hour;      //The filename changed with the hour.
+  bool binary;        //The .blog file.
+  uint64_t size;      //The written bytes.
+  uint32_t rolls;     //The last size rotated index.
+  std::set<uint64_t> formats; //Written to the .blog file.
+  std::set<uint64_t> threads;
 #if OS_UNIX
-    snprintf(command, 
-             sizeof(command) - 1, 
-             "rm -rf %s/*.log", 
-             GLOBALS["log.directory"].c_str());
-#elif OS_WIN
-    snprintf(command, 
-             sizeof(command) - 1, 
-             "del %s/*.log", 
-             GLOBALS["log.directory"].c_str());
-    util::path_towindows(command, static_cast<uint16_t>(strlen(command)));
+  int32_t fd;
+  char *map;
+  uint64_t map_offset;
+  uint64_t map_size;
+  uint64_t mapsize;   //The region size once mapped.
+#else
+  FILE *fp;
+  bool dirty;
 #endif
-    system(command);
-    return true;
+  log_file_struct();
+  ~log_file_struct() { close(); }
+  bool is_open() const;
+  bool open(const char *filename, bool binary, uint64_t mapsize);
+  bool write(const void *data, size_t length);
+  void flush();
+  //Truncate the not used region and close.
+  void close();
+  //Only close(the fork child, the parent still writing).
+  void release();
+#if OS_UNIX
+ private:
+  bool remap(size_t length);
+#endif
+};
+
+struct log_archive_job_struct {
+  std::string path;   //The file to compress or the log directory.
+  int32_t keepdays;   //Clean the log directory when not 0.
+};
+
+//Compress the rotated files and remove the old days, not in the logger
+//thread(may be slow).
+struct log_archiver_struct {
+  std::mutex mutex;
+  std::condition_variable condition;
+  std::list<log_archive_job_struct> jobs;
+  std::unique_ptr<std::thread> thread;
+  bool stop;
+  log_archiver_struct() : stop{false} {}
+  ~log_archiver_struct();
+  void push(const std::string &path, int32_t keepdays = 0);
+  void run();
+};
+
+namespace {
+
+struct log_record_struct {
+  uint32_t size;      //The record(8 bytes aligned).
+  uint32_t length;    //The text.
+  uint16_t logid;     //0 is the slow log(the name before the text).
+  uint8_t type;
+  uint8_t flags;
+  uint32_t name_size;
+  uint64_t time;      //ns.
+};
+
+using log_record_t = log_record_struct;
+
+enum {
+  kLogRecordPadding = 1, //Skip to the buffer end.
+};
+
+//The .blog file: the magic and the entries, the format and the thread 
+//entries before the records use them.
+const char kLogBlogMagic[] = "PFBLOG01";
+
+enum {
+  kLogBlogFormat = 1,
+  kLogBlogThread,
+  kLogBlogRecord, //The format, the thread, the runtime(ms) and the args.
+};
+
+struct log_blog_entry_struct {
+  uint8_t kind;
+  uint8_t type;
+  uint16_t reserved;
+  uint32_t size;      //The payload.
+  uint64_t id;        //The format pointer, the thread serial or the time(ns).
+};
+
+using log_blog_entry_t = log_blog_entry_struct;
+
+struct log_arg_struct {
+  uint8_t tag;
+  uint64_t value;     //The number bits.
+  const char *string;
+  uint16_t length;
+};
+
+using log_arg_t = log_arg_struct;
+
+//Changed when the logger destroyed, the thread caches check it.
+std::atomic<uint32_t> g_generation{1};
+
+struct log_holder_struct {
+  Logger *logger;
+  uint32_t generation;
+  log_buffer_struct *buffer;
+  ~log_holder_struct() {
+    if (is_null(buffer)) return;
+    if (logger == Logger::getsingleton_pointer() && 
+        generation == g_generation.load(std::memory_order_relaxed))
+      buffer->closed.store(true, std::memory_order_release);
   }
-  cache_size_ = cache_size;
-  return true;
+};
+
+struct logid_cache_struct {
+  const char *name;
+  int32_t logid;
+  uint32_t generation;
+};
+
+thread_local log_holder_struct t_holder{nullptr, 0, nullptr};
+thread_local logid_cache_struct t_logids[16];
+
+//The logger thread not read the GLOBALS(the map may be changing).
+struct log_path_struct {
+  config::handle<std::string> directory{"log.directory"};
+  config::handle<std::string> appname{"app.name"};
+  config::handle<int32_t> mapsize{"log.mapsize"};       //MB.
+  config::handle<int32_t> rotatesize{"log.rotatesize"}; //MB.
+  config::handle<bool> compress{"log.compress"};
+  config::handle<int32_t> keepfiles{"log.keepfiles"};
+  config::handle<int32_t> keepdays{"log.keepdays"};
+  config::handle<int32_t> ringsize{"log.ringsize"};     //KB.
+};
+
+const log_path_struct &log_path() {
+  static const log_path_struct path;
+  return path;
 }
 
-void Logger::get_log_filename(const char *filename_prefix, 
-                           char *save, 
-                           uint8_t type) { 
+//The thread buffer size(power of 2).
+uint64_t log_ringsize() {
+  auto size = static_cast<uint64_t>(log_path().ringsize.get()) * 1024;
+  if (0 == size) return kLogThreadBufferSize;
+  if (size < kLogThreadBufferMin) size = kLogThreadBufferMin;
+  uint64_t result{kLogThreadBufferMin};
+  while (result < size) result <<= 1;
+  return result;
+}
+
+//Only the logger thread.
+uint64_t g_second{0};
+tm g_tm;
+int32_t g_cleanday{-1};
+
+uint64_t now() {
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+}
+
+void log_filename(const char *filename_prefix, 
+                  char *save, 
+                  uint8_t type, 
+                  const tm *time,
+                  const char *extension = "log") {
   const char *typestr{nullptr};
   switch (type) {
     case 1:
@@ -120,62 +245,1153 @@ void Logger::get_log_filename(const char *filename_prefix,
            filename_prefix,
            strlen(typestr) > 0 ? "_" : "",
            typestr);
-  if (TIME_MANAGER_POINTER) {
+  if (time) {
     char savedir[128] = {0};
     snprintf(savedir, 
              sizeof(savedir) - 1, 
              "%s/%.2d_%.2d_%.2d/%s", 
-             GLOBALS["log.directory"].c_str(),
-             TIME_MANAGER_POINTER->get_year(), 
-             TIME_MANAGER_POINTER->get_month(),
-             TIME_MANAGER_POINTER->get_day(),
-             GLOBALS["app.name"].c_str());
+             log_path().directory.get().c_str(),
+             time->tm_year + 1900, 
+             time->tm_mon + 1,
+             time->tm_mday,
+             log_path().appname.get().c_str());
     if (!pf_basic::util::makedir(savedir, 0755))
       io_cerr("save dir: %s make failed", savedir);
     snprintf(save,
              FILENAME_MAX - 1,
-             "%s/%s_%.2d.log",
+             "%s/%s_%.2d.%s",
              savedir,
              prefixfinal,
-             TIME_MANAGER_POINTER->get_hour());
+             time->tm_hour,
+             extension);
   } else {
     snprintf(save,
              FILENAME_MAX - 1,
-             "%s/%s%s%s.log",
-             GLOBALS["log.directory"].c_str(),
+             "%s/%s%s%s.%s",
+             log_path().directory.get().c_str(),
              filename_prefix,
              strlen(typestr) > 0 ? "_" : "",
-             typestr);
-  }
-}
-
-void Logger::flush_log(const char *logname) {
-    uint8_t logid = static_cast<uint8_t>(logids_.get(logname));
-    char *buffer = logcache_.get(logid);
-    uint32_t position = log_position_.get(logid);
-    if (!loglock_.isfind(logid) || is_null(buffer)) return;
-    char log_filename[FILENAME_MAX];
-    memset(log_filename, '\0', sizeof(log_filename));
-    get_log_filename(logname, log_filename);
-    auto mutex = loglock_.get(logid);
-    std::unique_lock<std::mutex> autolock(*mutex);
-    try {
-      FILE* fp;
-      fp = fopen(log_filename, "ab");
-      if (fp) {
-        fwrite(buffer, 1, position, fp);
-        fclose(fp);
+             typestr,
+             extension);
+  }
+}
+
+void print(uint8_t type, const char *str) {
+  switch (type) {
+    case 1:
+      io_cwarn("%s", str);
+      break;
+    case 2:
+      io_cerr("%s", str);
+      break;
+    case 3:
+      io_cdebug("%s", str);
+      break;
+    case 9:
+      break;
+    default:
+      printf("%s" LF "", str);
+      break;
+  }
+}
+
+bool read_arg(const char *&args, const char *end, log_arg_t &arg) {
+  if (args >= end) return false;
+  arg.tag = static_cast<uint8_t>(*args++);
+  if (log_binary::kArgString == arg.tag) {
+    if (end - args < 2) return false;
+    memcpy(&arg.length, args, sizeof(arg.length));
+    args += sizeof(arg.length);
+    if (end - args < arg.length) return false;
+    arg.string = args;
+    args += arg.length;
+    return true;
+  }
+  if (arg.tag < log_binary::kArgInt || arg.tag > log_binary::kArgPointer || 
+      end - args < 8) return false;
+  memcpy(&arg.value, args, sizeof(arg.value));
+  args += sizeof(arg.value);
+  return true;
+}
+
+template <typename T>
+void append_format(std::string &result, const std::string &spec, T value) {
+  char buffer[512]{0};
+  auto length = snprintf(buffer, sizeof(buffer), spec.c_str(), value);
+  if (length < 0) return;
+  if (static_cast<size_t>(length) < sizeof(buffer)) {
+    result.append(buffer, length);
+    return;
+  }
+  std::unique_ptr<char[]> large(new char[length + 1]);
+  snprintf(large.get(), length + 1, spec.c_str(), value);
+  result.append(large.get(), length);
+}
+
+//The conversion not match the argument use the argument type, so never 
+//read a wrong type like the printf.
+void append_arg(std::string &result, 
+                std::string &spec, 
+                char conversion, 
+                const log_arg_t &arg) {
+  switch (arg.tag) {
+    case log_binary::kArgInt:
+    case log_binary::kArgUint:
+    case log_binary::kArgChar:
+      if ('c' == conversion || 
+          (log_binary::kArgChar == arg.tag && !strchr("diouxX", conversion))) {
+        spec += 'c';
+        append_format(result, spec, static_cast<int>(arg.value));
+        break;
       }
-    } catch(...) {
-      //do nothing
+      if (!strchr("diouxX", conversion))
+        conversion = log_binary::kArgUint == arg.tag ? 'u' : 'd';
+      spec += "ll";
+      spec += conversion;
+      append_format(result, spec, static_cast<long long>(arg.value));
+      break;
+    case log_binary::kArgDouble: {
+      double number{0};
+      memcpy(&number, &arg.value, sizeof(number));
+      if (!strchr("eEfFgGaA", conversion)) conversion = 'f';
+      spec += conversion;
+      append_format(result, spec, number);
+      break;
+    }
+    case log_binary::kArgString: {
+      std::string value(arg.string, arg.length);
+      spec += 's';
+      append_format(result, spec, value.c_str());
+      break;
     }
+    default:
+      spec += 'p';
+      append_format(
+          result, spec, reinterpret_cast<void *>(
+            static_cast<uintptr_t>(arg.value)));
+      break;
+  }
 }
 
-void Logger::flush_alllog() {
-    logids_t::iterator_t iterator;
-    for (iterator = logids_.begin(); iterator != logids_.end(); ++iterator) {
-      flush_log(iterator->first.c_str());
+bool blog_entry(log_file_struct *file, 
+                uint8_t kind, 
+                uint8_t type, 
+                uint64_t id, 
+                const char *payload, 
+                size_t size) {
+  log_blog_entry_t entry;
+  memset(&entry, 0, sizeof(entry));
+  entry.kind = kind;
+  entry.type = type;
+  entry.size = static_cast<uint32_t>(size);
+  entry.id = id;
+  return file->write(&entry, sizeof(entry)) && 
+         (0 == size || file->write(payload, size));
+}
+
+//The written size of the file not closed(crashed), the region after is 
+//zero filled.
+uint64_t log_used_size(int32_t fd, uint64_t size, bool binary) {
+#if OS_UNIX
+  if (binary) {
+    char magic[sizeof(kLogBlogMagic) - 1]{0};
+    uint64_t offset{sizeof(magic)};
+    if (pread(fd, magic, sizeof(magic), 0) != sizeof(magic) ||
+        0 != memcmp(magic, kLogBlogMagic, sizeof(magic))) return 0;
+    log_blog_entry_t entry;
+    while (offset + sizeof(entry) <= size) {
+      if (pread(fd, &entry, sizeof(entry), offset) != sizeof(entry) ||
+          0 == entry.kind || 
+          offset + sizeof(entry) + entry.size > size) break;
+      offset += sizeof(entry) + entry.size;
+    }
+    return offset;
+  }
+  char block[4096];
+  auto end = size;
+  while (end > 0) {
+    auto length = end > sizeof(block) ? sizeof(block) : end;
+    if (pread(fd, block, length, end - length) != 
+        static_cast<ssize_t>(length)) return end;
+    for (auto i = length; i > 0; --i) {
+      if (block[i - 1] != '\0') return end - length + i;
     }
+    end -= length;
+  }
+  return 0;
+#else
+  return size;
+#endif
+}
+
+bool log_file_exists(const std::string &filename) {
+#if OS_UNIX
+  return 0 == access(filename.c_str(), F_OK);
+#else
+  return 0 == _access(filename.c_str(), 0);
+#endif
+}
+
+bool log_compress(const std::string &filename) {
+#ifdef PF_OPEN_ZLIB
+  auto in = fopen(filename.c_str(), "rb");
+  if (is_null(in)) return false;
+  auto target = filename + ".gz";
+  auto out = gzopen(target.c_str(), "wb");
+  if (is_null(out)) {
+    fclose(in);
+    return false;
+  }
+  bool result{true};
+  char block[64 * 1024];
+  size_t length{0};
+  while (result && (length = fread(block, 1, sizeof(block), in)) > 0) {
+    result = gzwrite(out, block, static_cast<unsigned>(length)) == 
+             static_cast<int>(length);
+  }
+  fclose(in);
+  if (Z_OK != gzclose(out)) result = false;
+  remove(result ? filename.c_str() : target.c_str());
+  return result;
+#else
+  UNUSED(filename);
+  return false;
+#endif
+}
+
+#if OS_UNIX
+void log_remove_directory(const std::string &path) {
+  auto dir = opendir(path.c_str());
+  if (is_null(dir)) return;
+  struct dirent *entry{nullptr};
+  while ((entry = readdir(dir)) != nullptr) {
+    if (0 == strcmp(entry->d_name, ".") || 0 == strcmp(entry->d_name, ".."))
+      continue;
+    auto child = path + "/" + entry->d_name;
+    struct stat info;
+    if (0 != lstat(child.c_str(), &info)) continue;
+    if (S_ISDIR(info.st_mode)) {
+      log_remove_directory(child);
+    } else {
+      unlink(child.c_str());
+    }
+  }
+  closedir(dir);
+  rmdir(path.c_str());
+}
+#endif
+
+//Remove the day directories(YYYY_MM_DD) older than the keep days.
+void log_clean_days(const std::string &directory, int32_t keepdays) {
+#if OS_UNIX
+  auto dir = opendir(directory.c_str());
+  if (is_null(dir)) return;
+  auto now = time(nullptr);
+  std::vector<std::string> removes;
+  struct dirent *entry{nullptr};
+  while ((entry = readdir(dir)) != nullptr) {
+    int32_t year{0}, month{0}, day{0};
+    char tail{0};
+    if (sscanf(entry->d_name, "%4d_%2d_%2d%c", &year, &month, &day, &tail) != 3)
+      continue;
+    tm date;
+    memset(&date, 0, sizeof(date));
+    date.tm_year = year - 1900;
+    date.tm_mon = month - 1;
+    date.tm_mday = day + 1; //The day end.
+    date.tm_isdst = -1;
+    auto end = mktime(&date);
+    if (end != -1 && now - end > static_cast<time_t>(keepdays) * 86400)
+      removes.emplace_back(directory + "/" + entry->d_name);
+  }
+  closedir(dir);
+  for (auto &path : removes) log_remove_directory(path);
+#else
+  UNUSED(directory);
+  UNUSED(keepdays);
+#endif
+}
+
+} //namespace
+
+log_file_struct::log_file_struct() :
+  filename{""},
+  hour{0},
+  binary{false},
+  size{0},
+  rolls{0},
+#if OS_UNIX
+  fd{-1},
+  map{nullptr},
+  map_offset{0},
+  map_size{0},
+  mapsize{0} {}
+#else
+  fp{nullptr},
+  dirty{false} {}
+#endif
+
+bool log_file_struct::is_open() const {
+#if OS_UNIX
+  return fd >= 0;
+#else
+  return !is_null(fp);
+#endif
+}
+
+bool log_file_struct::open(const char *_filename, 
+                           bool _binary, 
+                           uint64_t _mapsize) {
+  close();
+  if (filename != _filename) rolls = 0;
+  filename = _filename;
+  binary = _binary;
+  size = 0;
+  formats.clear();
+  threads.clear();
+#if OS_UNIX
+  fd = ::open(_filename, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+  if (fd < 0) return false;
+  static const uint64_t page = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+  mapsize = (_mapsize + page - 1) / page * page;
+  if (0 == mapsize) mapsize = page;
+  struct stat info;
+  if (0 == fstat(fd, &info) && info.st_size > 0)
+    size = log_used_size(fd, static_cast<uint64_t>(info.st_size), binary);
+#else
+  UNUSED(_mapsize);
+  fp = fopen(_filename, "ab");
+  if (is_null(fp)) return false;
+  fseek(fp, 0, SEEK_END);
+  size = static_cast<uint64_t>(ftell(fp));
+#endif
+  if (binary && 0 == size) 
+    return write(kLogBlogMagic, sizeof(kLogBlogMagic) - 1);
+  return true;
+}
+
+#if OS_UNIX
+bool log_file_struct::remap(size_t length) {
+  if (map) munmap(map, map_size);
+  map = nullptr;
+  static const uint64_t page = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+  map_offset = size / page * page;
+  map_size = mapsize;
+  auto need = size - map_offset + length;
+  if (map_size < need) map_size = (need + page - 1) / page * page;
+  //The blocks allocated, so no SIGBUS on the disk full.
+  if (0 != posix_fallocate(fd, 
+                           static_cast<off_t>(map_offset), 
+                           static_cast<off_t>(map_size))) return false;
+  auto pointer = mmap(nullptr, 
+                      map_size, 
+                      PROT_READ | PROT_WRITE, 
+                      MAP_SHARED, 
+                      fd, 
+                      static_cast<off_t>(map_offset));
+  if (MAP_FAILED == pointer) return false;
+  map = static_cast<char *>(pointer);
+  return true;
+}
+#endif
+
+bool log_file_struct::write(const void *data, size_t length) {
+  if (!is_open()) return false;
+#if OS_UNIX
+  if (is_null(map) || size + length > map_offset + map_size) {
+    if (!remap(length)) return false;
+  }
+  memcpy(map + (size - map_offset), data, length);
+#else
+  if (fwrite(data, 1, length, fp) != length) return false;
+  dirty = true;
+#endif
+  size += length;
+  return true;
+}
+
+void log_file_struct::flush() {
+#if OS_WIN
+  if (!dirty || is_null(fp)) return;
+  fflush(fp);
+  dirty = false;
+#endif
+}
+
+void log_file_struct::close() {
+#if OS_UNIX
+  if (map) munmap(map, map_size);
+  map = nullptr;
+  if (fd >= 0) {
+    if (ftruncate(fd, static_cast<off_t>(size)) != 0) {}
+    ::close(fd);
+  }
+  fd = -1;
+#else
+  if (fp) fclose(fp);
+  fp = nullptr;
+#endif
+}
+
+void log_file_struct::release() {
+#if OS_UNIX
+  if (map) munmap(map, map_size);
+  map = nullptr;
+  if (fd >= 0) ::close(fd);
+  fd = -1;
+#else
+  if (fp) fclose(fp);
+  fp = nullptr;
+#endif
+}
+
+log_archiver_struct::~log_archiver_struct() {
+  {
+    std::unique_lock<std::mutex> autolock(mutex);
+    stop = true;
+  }
+  condition.notify_all();
+  if (thread && thread->joinable()) thread->join();
+}
+
+void log_archiver_struct::push(const std::string &path, int32_t keepdays) {
+  std::unique_lock<std::mutex> autolock(mutex);
+  if (stop) return;
+  jobs.push_back({path, keepdays});
+  if (!thread) thread.reset(new std::thread([this]() { run(); }));
+  condition.notify_one();
+}
+
+void log_archiver_struct::run() {
+#if OS_UNIX
+  sigset_t set;
+  sigfillset(&set);
+  pthread_sigmask(SIG_BLOCK, &set, nullptr);
+#endif
+  trace::set_thread_name("logarchive");
+  std::unique_lock<std::mutex> autolock(mutex);
+  for (;;) {
+    condition.wait(autolock, [this]() { return stop || !jobs.empty(); });
+    if (jobs.empty()) break; //Stop after the jobs.
+    auto job = jobs.front();
+    jobs.pop_front();
+    autolock.unlock();
+    if (job.keepdays > 0) {
+      log_clean_days(job.path, job.keepdays);
+    } else {
+      log_compress(job.path);
+    }
+    autolock.lock();
+  }
+}
+
+Logger::Logger() {
+  logids_.init(LOGTYPE_MAX);
+  lognames_.reserve(LOGTYPE_MAX + 1); //Never reallocate(read without lock).
+  lognames_.push_back("");
+  stop_ = false;
+  drained_ = 0;
+  running_ = false;
+  wakeup_ = false;
+  dropped_ = 0;
+  start_ = 0;
+  cache_size_ = 0;
+  //The config handles interned in this thread.
+  log_config();
+  log_path();
+  archiver_.reset(new log_archiver_struct);
+#if OS_UNIX
+  static std::once_flag flag;
+  std::call_once(flag, []() {
+    pthread_atfork(atfork_prepare, atfork_parent, atfork_child);
+  });
+#endif
+}
+
+Logger::~Logger() {
+  {
+    std::unique_lock<std::mutex> autolock(thread_mutex_);
+    stop_ = true;
+  }
+  condition_.notify_all();
+  if (thread_ && thread_->joinable()) thread_->join();
+  ++g_generation;
+  files_.clear();
+  archiver_.reset(); //Finish the archives.
+  cache_size_ = 0;
+}
+
+bool Logger::register_fastlog(const char *logname) {
+  std::unique_lock<std::mutex> autolock(logid_mutex_);
+  uint32_t count = logids_.getcount();
+  if (count >= logids_.get_maxcount()) return false;
+  if (logids_.isfind(logname)) return false;
+  int32_t logid = static_cast<int32_t>(count + 1);
+  lognames_.push_back(logname);
+  return logids_.add(logname, logid);
+}
+
+int32_t Logger::get_fastlog_id(const char *logname) {
+  if (is_null(logname)) return 0;
+  auto &cache = 
+    t_logids[(reinterpret_cast<uintptr_t>(logname) >> 3) & 15];
+  auto generation = g_generation.load(std::memory_order_relaxed);
+  //The name may be a buffer, check the string too.
+  if (cache.name == logname && 
+      cache.generation == generation && 
+      lognames_[cache.logid] == logname) return cache.logid;
+  int32_t logid{0};
+  for (int32_t i = 0; i < 2 && 0 == logid; ++i) {
+    if (i > 0) register_fastlog(logname);
+    std::unique_lock<std::mutex> autolock(logid_mutex_);
+    if (logids_.isfind(logname)) logid = logids_.get(logname);
+  }
+  if (0 == logid) return 0;
+  cache.name = logname;
+  cache.logid = logid;
+  cache.generation = generation;
+  return logid;
+}
+
+log_buffer_struct *Logger::buffer() {
+  auto generation = g_generation.load(std::memory_order_relaxed);
+  if (t_holder.logger == this && t_holder.generation == generation)
+    return t_holder.buffer;
+  std::unique_ptr<log_buffer_struct> 
+    pointer(new log_buffer_struct(log_ringsize()));
+  auto result = pointer.get();
+  {
+    std::unique_lock<std::mutex> autolock(mutex_);
+    buffers_.emplace_back(std::move(pointer));
+  }
+  t_holder.logger = this;
+  t_holder.generation = generation;
+  t_holder.buffer = result;
+  return result;
+}
+
+void Logger::push(int32_t logid, 
+                  uint8_t type, 
+                  const char *name, 
+                  const char *text, 
+                  size_t length,
+                  uint8_t flags) {
+  if (!running_.load(std::memory_order_acquire)) start();
+  auto buffer = this->buffer();
+  size_t name_size = is_null(name) ? 0 : strlen(name);
+  if (name_size >= kLogNameTemp) name_size = kLogNameTemp - 1;
+  auto size = (sizeof(log_record_t) + name_size + length + 7) & ~7ULL;
+  auto capacity = buffer->capacity;
+  auto head = buffer->head.load(std::memory_order_relaxed);
+  auto tail = buffer->tail.load(std::memory_order_acquire);
+  auto offset = head & (capacity - 1);
+  auto contiguous = capacity - offset;
+  auto padding = contiguous < size ? contiguous : 0;
+  //The warning, error and slow logs not drop, wait the drain.
+  auto wait = (0 == logid || 1 == type || 2 == type) && size <= capacity / 2;
+  while (head + padding + size - tail > capacity) {
+    if (!wait || !wait_drain(1)) {
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+      if (!wakeup_.exchange(true)) condition_.notify_one();
+      return;
+    }
+    tail = buffer->tail.load(std::memory_order_acquire);
+  }
+  auto data = reinterpret_cast<char *>(buffer->data.get());
+  if (padding >= sizeof(log_record_t)) {
+    log_record_t record;
+    memset(&record, 0, sizeof(record));
+    record.size = static_cast<uint32_t>(padding);
+    record.flags = kLogRecordPadding;
+    memcpy(data + offset, &record, sizeof(record));
+  }
+  if (padding > 0) offset = 0;
+  log_record_t record;
+  record.size = static_cast<uint32_t>(size);
+  record.length = static_cast<uint32_t>(length);
+  record.logid = static_cast<uint16_t>(logid);
+  record.type = type;
+  record.flags = flags;
+  record.name_size = static_cast<uint32_t>(name_size);
+  record.time = now();
+  memcpy(data + offset, &record, sizeof(record));
+  if (name_size > 0) memcpy(data + offset + sizeof(record), name, name_size);
+  memcpy(data + offset + sizeof(record) + name_size, text, length);
+  head += padding + size;
+  buffer->head.store(head, std::memory_order_release);
+  if (head - tail > capacity / 2 && !wakeup_.exchange(true))
+    condition_.notify_one();
+}
+
+void Logger::start() {
+  std::unique_lock<std::mutex> autolock(thread_mutex_);
+  if (running_ || stop_) return;
+  thread_.reset(new std::thread([this]() { run(); }));
+  running_.store(true, std::memory_order_release);
+}
+
+void Logger::run() {
+#if OS_UNIX
+  //The app signals not to this thread.
+  sigset_t set;
+  sigfillset(&set);
+  pthread_sigmask(SIG_BLOCK, &set, nullptr);
+#endif
+  trace::set_thread_name("logger");
+  std::unique_lock<std::mutex> autolock(thread_mutex_);
+  for (;;) {
+    auto stop = stop_;
+    autolock.unlock();
+    drain();
+    autolock.lock();
+    ++drained_;
+    flushed_.notify_all();
+    if (stop) break;
+    condition_.wait_for(autolock, 
+                        std::chrono::milliseconds(kLogFlushInterval), 
+                        [this]() { 
+      return stop_ || wakeup_.load(std::memory_order_relaxed); 
+    });
+    wakeup_ = false;
+  }
+}
+
+void Logger::drain() {
+  std::unique_lock<std::mutex> drainlock(drain_mutex_);
+  //Only the drain erase the buffers, write them without the list lock.
+  std::vector<log_buffer_struct *> buffers;
+  {
+    std::unique_lock<std::mutex> autolock(mutex_);
+    buffers.reserve(buffers_.size());
+    for (auto &buffer : buffers_) buffers.push_back(buffer.get());
+  }
+  std::set<log_buffer_struct *> closeds;
+  for (auto buffer : buffers) {
+    //Read the closed first, the head is last after it.
+    auto closed = buffer->closed.load(std::memory_order_acquire);
+    auto head = buffer->head.load(std::memory_order_acquire);
+    auto tail = buffer->tail.load(std::memory_order_relaxed);
+    auto data = reinterpret_cast<const char *>(buffer->data.get());
+    while (tail < head) {
+      auto offset = tail & (buffer->capacity - 1);
+      auto contiguous = buffer->capacity - offset;
+      if (contiguous < sizeof(log_record_t)) {
+        tail += contiguous;
+        continue;
+      }
+      auto record = reinterpret_cast<const log_record_t *>(data + offset);
+      if (!(record->flags & kLogRecordPadding)) write(buffer, data + offset);
+      tail += record->size;
+    }
+    buffer->tail.store(tail, std::memory_order_release);
+    if (closed) closeds.insert(buffer);
+  }
+  if (!closeds.empty()) {
+    std::unique_lock<std::mutex> autolock(mutex_);
+    buffers_.remove_if([&closeds](
+          const std::unique_ptr<log_buffer_struct> &buffer) {
+      return closeds.count(buffer.get()) > 0;
+    });
+  }
+  flush_files();
+}
+
+void Logger::write(log_buffer_struct *buffer, const char *data) {
+  auto record = reinterpret_cast<const log_record_t *>(data);
+  auto name = data + sizeof(log_record_t);
+  auto text = name + record->name_size;
+  auto binary = 0 != (record->flags & kLogRecordBinary);
+  auto active = log_config().active.get();
+  auto printing = log_config().print.get();
+  //The binary log to the .blog file not format(pf_logdecode).
+  auto blog = binary && active && log_config().binary.get();
+  auto seconds = record->time / 1000000000;
+  int64_t runtime{0};
+  auto timemanager = TIME_MANAGER_POINTER;
+  if (timemanager) {
+    if (seconds != g_second) {
+      auto time = static_cast<time_t>(seconds);
+#if OS_WIN
+      localtime_s(&g_tm, &time);
+#else
+      localtime_r(&time, &g_tm);
+#endif
+      g_second = seconds;
+    }
+    auto millisecond = record->time / 1000000;
+    if (0 == start_) start_ = now() / 1000000 - timemanager->get_run_time();
+    runtime = static_cast<int64_t>(millisecond - start_);
+  }
+  std::string line;
+  if (!blog || printing) {
+    char time_str[256]{0};
+    if (timemanager) {
+      snprintf(time_str, 
+               sizeof(time_str) - 1,
+               "%.2d:%.2d:%.2d (%s %.4f)",
+               g_tm.tm_hour,
+               g_tm.tm_min,
+               g_tm.tm_sec,
+               buffer->thread_id.c_str(),
+               static_cast<float>(runtime) / 1000);
+    } else {
+      snprintf(time_str, 
+               sizeof(time_str) - 1, 
+               "00:00:00 (%s 0.0000)", 
+               buffer->thread_id.c_str());
+    }
+    line = time_str;
+    line += " ";
+    if (binary) {
+      const char *format{nullptr};
+      memcpy(&format, text, sizeof(format));
+      format_binary(format, 
+                    text + sizeof(format), 
+                    record->length - sizeof(format), 
+                    line);
+    } else {
+      line.append(text, record->length);
+    }
+    if (printing) print(record->type, line.c_str());
+  }
+  if (!active) return;
+  std::string key;
+  uint8_t type{0};
+  if (0 == record->logid) {
+    key.assign(name, record->name_size);
+    type = record->type; //The slow log file with the type.
+  } else {
+    key = lognames_[record->logid];
+  }
+  std::string filename_prefix{key};
+  key += "#" + std::to_string(type);
+  if (blog) key += "#binary";
+  auto &file = files_[key];
+  if (!file) file.reset(new log_file_struct);
+  auto hour = seconds / 3600;
+  if (!file->is_open() || file->hour != hour) {
+    char filename[FILENAME_MAX]{0};
+    log_filename(filename_prefix.c_str(), 
+                 filename, 
+                 type, 
+                 timemanager ? &g_tm : nullptr,
+                 blog ? "blog" : "log");
+    file->hour = hour;
+    if (file->filename != filename || !file->is_open()) {
+      if (file->is_open()) { //The last hour.
+        file->close();
+        archive(file->filename);
+      }
+      uint64_t mapsize = log_path().mapsize.get() > 0 ? 
+        static_cast<uint64_t>(log_path().mapsize.get()) * 1024 * 1024 : 
+        1024 * 1024;
+      //The definitions again in the new file(or appended to the old).
+      if (!file->open(filename, blog, mapsize)) {
+        file->close();
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+      }
+      auto keepdays = log_path().keepdays.get();
+      if (keepdays > 0 && timemanager && g_tm.tm_yday != g_cleanday) {
+        g_cleanday = g_tm.tm_yday;
+        archiver_->push(log_path().directory.get(), keepdays);
+      }
+    }
+  }
+  bool result{false};
+  if (blog) {
+    result = write_binary(file.get(), buffer, data, runtime);
+  } else {
+    line += LF;
+    result = file->write(line.data(), line.size());
+  }
+  if (!result) dropped_.fetch_add(1, std::memory_order_relaxed);
+  auto rotatesize = static_cast<uint64_t>(log_path().rotatesize.get());
+  if (rotatesize > 0 && file->size >= rotatesize * 1024 * 1024) 
+    rotate(file.get());
+}
+
+void Logger::rotate(log_file_struct *file) {
+  file->close();
+  //The next free index(the archives of the last process), X.log.N.
+  auto index = file->rolls + 1;
+  auto name = [file](uint32_t i) {
+    return file->filename + "." + std::to_string(i);
+  };
+  while (log_file_exists(name(index)) || log_file_exists(name(index) + ".gz"))
+    ++index;
+  file->rolls = index;
+  if (0 != rename(file->filename.c_str(), name(index).c_str())) return;
+  archive(name(index));
+  auto keepfiles = log_path().keepfiles.get();
+  if (keepfiles <= 0) return;
+  for (int64_t i = static_cast<int64_t>(index) - keepfiles; i > 0; --i) {
+    auto filename = name(static_cast<uint32_t>(i));
+    auto removed = 0 == remove(filename.c_str());
+    if (0 == remove((filename + ".gz").c_str())) removed = true;
+    if (!removed) break;
+  }
+}
+
+void Logger::archive(const std::string &filename) {
+  if (!log_path().compress.get()) return;
+#ifdef PF_OPEN_ZLIB
+  archiver_->push(filename);
+#else
+  UNUSED(filename);
+#endif
+}
+
+bool Logger::write_binary(log_file_struct *file, 
+                          log_buffer_struct *buffer, 
+                          const char *data, 
+                          int64_t runtime) {
+  auto record = reinterpret_cast<const log_record_t *>(data);
+  auto text = data + sizeof(log_record_t) + record->name_size;
+  const char *format{nullptr};
+  memcpy(&format, text, sizeof(format));
+  if (is_null(format)) return true;
+  uint64_t formatid = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(format));
+  bool result{true};
+  if (file->formats.insert(formatid).second) {
+    result = blog_entry(
+        file, kLogBlogFormat, 0, formatid, format, strlen(format));
+  }
+  if (result && file->threads.insert(buffer->serial).second) {
+    result = blog_entry(file, 
+                        kLogBlogThread, 
+                        0, 
+                        buffer->serial, 
+                        buffer->thread_id.data(), 
+                        buffer->thread_id.size());
+  }
+  if (!result) return false;
+  char head[sizeof(uint64_t) * 3]{0};
+  memcpy(head, &formatid, sizeof(formatid));
+  memcpy(head + 8, &buffer->serial, sizeof(buffer->serial));
+  memcpy(head + 16, &runtime, sizeof(runtime));
+  auto size = record->length - sizeof(format);
+  log_blog_entry_t entry;
+  memset(&entry, 0, sizeof(entry));
+  entry.kind = kLogBlogRecord;
+  entry.type = record->type;
+  entry.size = static_cast<uint32_t>(sizeof(head) + size);
+  entry.id = record->time;
+  return file->write(&entry, sizeof(entry)) && 
+         file->write(head, sizeof(head)) && 
+         (0 == size || file->write(text + sizeof(format), size));
+}
+
+void Logger::format_binary(const char *format, 
+                           const char *args, 
+                           size_t size, 
+                           std::string &result) {
+  if (is_null(format)) return;
+  auto end = args + size;
+  auto pointer = format;
+  while (*pointer) {
+    if ('%' != *pointer) {
+      auto next = strchr(pointer, '%');
+      if (is_null(next)) {
+        result += pointer;
+        break;
+      }
+      result.append(pointer, next - pointer);
+      pointer = next;
+      continue;
+    }
+    auto begin = pointer++;
+    if ('%' == *pointer) {
+      result += '%';
+      ++pointer;
+      continue;
+    }
+    std::string spec{"%"};
+    while (*pointer && strchr("-+ #0", *pointer)) spec += *pointer++;
+    //The width and the precision, * from the arguments.
+    for (int32_t i = 0; i < 2; ++i) {
+      if (1 == i) {
+        if ('.' != *pointer) break;
+        spec += *pointer++;
+      }
+      if ('*' == *pointer) {
+        ++pointer;
+        log_arg_t arg;
+        if (read_arg(args, end, arg) && log_binary::kArgString != arg.tag)
+          spec += std::to_string(static_cast<int32_t>(arg.value));
+      } else {
+        while (*pointer >= '0' && *pointer <= '9') spec += *pointer++;
+      }
+    }
+    //The length from the argument type.
+    while (*pointer && strchr("hlLqjzt", *pointer)) ++pointer;
+    auto conversion = *pointer;
+    if ('\0' == conversion) {
+      result += begin;
+      break;
+    }
+    ++pointer;
+    if ('n' == conversion) continue;
+    log_arg_t arg;
+    if (!read_arg(args, end, arg)) { //Missing(truncated) the argument.
+      result.append(begin, pointer - begin);
+      continue;
+    }
+    append_arg(result, spec, conversion, arg);
+  }
+}
+
+bool Logger::decode_binary(const char *filename, FILE *out) {
+  //The archives(.blog.gz) read with the zlib.
+#ifdef PF_OPEN_ZLIB
+  auto fp = gzopen(filename, "rb");
+  auto read = [&fp](void *data, size_t size) {
+    return gzread(fp, data, static_cast<unsigned>(size)) == 
+           static_cast<int>(size);
+  };
+#else
+  auto fp = fopen(filename, "rb");
+  auto read = [&fp](void *data, size_t size) {
+    return 1 == fread(data, size, 1, fp);
+  };
+#endif
+  if (is_null(fp)) return false;
+  char magic[sizeof(kLogBlogMagic) - 1]{0};
+  bool result = read(magic, sizeof(magic)) &&
+                0 == memcmp(magic, kLogBlogMagic, sizeof(magic));
+  std::map<uint64_t, std::string> formats;
+  std::map<uint64_t, std::string> threads;
+  std::vector<char> payload;
+  log_blog_entry_t entry;
+  //The last entry may be half written or the zero region(crashed), stop.
+  while (result && read(&entry, sizeof(entry))) {
+    if (0 == entry.kind) break;
+    payload.resize(entry.size + 1);
+    if (entry.size > 0 && !read(payload.data(), entry.size)) break;
+    if (kLogBlogFormat == entry.kind) {
+      formats[entry.id].assign(payload.data(), entry.size);
+    } else if (kLogBlogThread == entry.kind) {
+      threads[entry.id].assign(payload.data(), entry.size);
+    } else if (kLogBlogRecord == entry.kind && entry.size >= 24) {
+      uint64_t formatid{0};
+      uint64_t thread{0};
+      int64_t runtime{0};
+      memcpy(&formatid, payload.data(), sizeof(formatid));
+      memcpy(&thread, payload.data() + 8, sizeof(thread));
+      memcpy(&runtime, payload.data() + 16, sizeof(runtime));
+      auto time = static_cast<time_t>(entry.id / 1000000000);
+      tm _tm;
+#if OS_WIN
+      localtime_s(&_tm, &time);
+#else
+      localtime_r(&time, &_tm);
+#endif
+      char time_str[256]{0};
+      snprintf(time_str, 
+               sizeof(time_str) - 1,
+               "%.2d:%.2d:%.2d (%s %.4f) ",
+               _tm.tm_hour,
+               _tm.tm_min,
+               _tm.tm_sec,
+               threads[thread].c_str(),
+               static_cast<float>(runtime) / 1000);
+      std::string line{time_str};
+      auto it = formats.find(formatid);
+      if (it != formats.end()) {
+        format_binary(
+            it->second.c_str(), payload.data() + 24, entry.size - 24, line);
+      } else {
+        line += "(unknown format)";
+      }
+      line += LF;
+      fwrite(line.data(), 1, line.size(), out);
+    } else {
+      result = false;
+    }
+  }
+#ifdef PF_OPEN_ZLIB
+  gzclose(fp);
+#else
+  fclose(fp);
+#endif
+  return result;
+}
+
+void Logger::flush_files() {
+  //The mapped files need not(the page cache).
+  for (auto &it : files_) it.second->flush();
+}
+
+uint64_t Logger::backlog() {
+  uint64_t result{0};
+  std::unique_lock<std::mutex> autolock(mutex_);
+  for (auto &buffer : buffers_) {
+    result += buffer->head.load(std::memory_order_relaxed) - 
+              buffer->tail.load(std::memory_order_relaxed);
+  }
+  return result;
+}
+
+void Logger::atfork_prepare() {
+  auto logger = getsingleton_pointer();
+  if (is_null(logger)) return;
+  //The logger thread not in drain, the files are flushed.
+  logger->thread_mutex_.lock();
+  logger->drain_mutex_.lock();
+  logger->mutex_.lock();
+  logger->logid_mutex_.lock();
+  logger->archiver_->mutex.lock();
+}
+
+void Logger::atfork_parent() {
+  auto logger = getsingleton_pointer();
+  if (is_null(logger)) return;
+  logger->archiver_->mutex.unlock();
+  logger->logid_mutex_.unlock();
+  logger->mutex_.unlock();
+  logger->drain_mutex_.unlock();
+  logger->thread_mutex_.unlock();
+}
+
+void Logger::atfork_child() {
+  auto logger = getsingleton_pointer();
+  if (is_null(logger)) return;
+  //Only the fork thread in the child, the parent write the old logs.
+  if (logger->thread_) logger->thread_.release();
+  logger->running_ = false;
+  for (auto &buffer : logger->buffers_) {
+    buffer->tail.store(buffer->head.load());
+    buffer->closed = true;
+  }
+  //Not truncate the files, the parent mapped.
+  for (auto &it : logger->files_) it.second->release();
+  auto archiver = logger->archiver_.get();
+  if (archiver->thread) archiver->thread.release();
+  archiver->jobs.clear();
+  archiver->mutex.unlock();
+  ++g_generation;
+  logger->logid_mutex_.unlock();
+  logger->mutex_.unlock();
+  logger->drain_mutex_.unlock();
+  logger->thread_mutex_.unlock();
+}
+
+void Logger::get_log_timestr(char *time_str, int32_t length) {
+  thread_local const std::string thread_id{pf_sys::thread::get_id()};
+  if (TIME_MANAGER_POINTER) {
+      auto runtime = TIME_MANAGER_POINTER->get_run_time();
+      //The "HH:MM:SS" of the wall clock string(cached per second).
+      snprintf(
+          time_str, 
+          length, 
+          "%s (%s %.4f)",
+          TimeManager::get_wallclock_str() + 11,
+          thread_id.c_str(),
+          static_cast< float >(runtime) / 1000);
+  } else {
+    snprintf(time_str,
+             length, 
+             "00:00:00 (%s 0.0000)",
+             thread_id.c_str());
+  }
+}
+
+bool Logger::init(int32_t cache_size) {
+  if (GLOBALS["log.clear"] == 1) clear_logs(GLOBALS["log.directory"].c_str());
+  cache_size_ = cache_size;
+  return true;
+}
+
+void Logger::clear_logs(const char *directory) {
+  //The *.log and *.blog files of the directory(not the day directories).
+  auto match = [](const char *name) {
+    auto length = strlen(name);
+    return (length > 4 && 0 == strcmp(name + length - 4, ".log")) ||
+           (length > 5 && 0 == strcmp(name + length - 5, ".blog"));
+  };
+#if OS_UNIX
+  auto dir = opendir(directory);
+  if (is_null(dir)) return;
+  struct dirent *entry{nullptr};
+  while ((entry = readdir(dir)) != nullptr) {
+    if (!match(entry->d_name)) continue;
+    auto filename = std::string(directory) + "/" + entry->d_name;
+    struct stat info;
+    if (0 == lstat(filename.c_str(), &info) && S_ISREG(info.st_mode))
+      unlink(filename.c_str());
+  }
+  closedir(dir);
+#elif OS_WIN
+  struct _finddata_t data;
+  auto pattern = std::string(directory) + "/*";
+  auto handle = _findfirst(pattern.c_str(), &data);
+  if (-1 == handle) return;
+  do {
+    if (!(data.attrib & _A_SUBDIR) && match(data.name))
+      remove((std::string(directory) + "/" + data.name).c_str());
+  } while (0 == _findnext(handle, &data));
+  _findclose(handle);
+#endif
+}
+
+void Logger::get_log_filename(const char *filename_prefix, 
+                           char *save, 
+                           uint8_t type) { 
+  auto timemanager = TIME_MANAGER_POINTER;
+  if (is_null(timemanager)) {
+    log_filename(filename_prefix, save, type, nullptr);
+    return;
+  }
+  tm time;
+  memset(&time, 0, sizeof(time));
+  time.tm_year = timemanager->get_year() - 1900;
+  time.tm_mon = timemanager->get_month() - 1;
+  time.tm_mday = timemanager->get_day();
+  time.tm_hour = timemanager->get_hour();
+  log_filename(filename_prefix, save, type, &time);
+}
+
+void Logger::flush_log(const char *) {
+  flush_alllog();
+}
+
+void Logger::flush_alllog() {
+  //The drain running may not see the last logs, wait the next.
+  wait_drain(2);
+}
+
+bool Logger::wait_drain(uint64_t count) {
+  if (!running_.load(std::memory_order_acquire)) return false;
+  std::unique_lock<std::mutex> autolock(thread_mutex_);
+  if (stop_ || std::this_thread::get_id() == thread_->get_id()) return false;
+  auto target = drained_ + count;
+  wakeup_ = true;
+  condition_.notify_one();
+  flushed_.wait(autolock, [this, target]() { 
+    return drained_ >= target || stop_; 
+  });
+  return !stop_;
+}
+
+void Logger::savelog(const char *filename_prefix, 
+                     uint8_t type, 
+                     const char *text) {
+  std::unique_lock<std::mutex> autolock(g_log_mutex);
+  char time_str[256]{0};
+  get_log_timestr(time_str, sizeof(time_str) - 1);
+  std::string line{time_str};
+  line += " ";
+  line += text;
+  if (log_config().print.get()) print(type, line.c_str());
+  if (!log_config().active.get()) return;
+  line += LF;
+  char log_filename[FILENAME_MAX]{0};
+  get_log_filename(filename_prefix, log_filename, type);
+  auto fp = fopen(log_filename, "ab");
+  if (fp) {
+    fwrite(line.data(), 1, line.size(), fp);
+    fclose(fp);
+  }
 }
 
 void Logger::remove_log(const char *file_name) {
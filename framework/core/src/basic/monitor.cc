@@ -15,5 +15,7 @@ monitor::monitor(const std::string &name) : name_{name} {
 monitor::~monitor() {
   auto end_time = gettime();
   io_cdebug(
-      "[monitor] (%s) run time: %d", name_.c_str(), end_time - start_time_);
+      "[monitor] (%s) run time: %d", 
+      name_.c_str(), 
+      static_cast<int32_t>(end_time - start_time_));
 }
@@ -596,7 +596,8 @@ static bool pg_encrypt_password(
 }
 
 bool encrypt(const std::string &in, std::string &out) {
-  auto tickcount = TIME_MANAGER_POINTER->get_tickcount();
+  //Only the seed of the encrypt.
+  auto tickcount = static_cast<uint32_t>(TIME_MANAGER_POINTER->get_tickcount());
   char temp[PG_RESULTLENSTD + 1]{0};
   int level = 0;
   bool result{false};
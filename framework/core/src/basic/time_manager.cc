@@ -4,10 +4,30 @@
 std::unique_ptr< pf_basic::TimeManager > g_time_manager{nullptr};
 
 int32_t g_file_name_fix = 0;
-uint32_t g_file_name_fix_last = 0;
+uint64_t g_file_name_fix_last = 0;
 
 namespace pf_basic {
 
+namespace {
+
+//The coarse clock is the jiffy(a few ms) and cheap(vdso, no syscall).
+uint64_t monotonic_time() {
+#if OS_WIN
+  return static_cast<uint64_t>(GetTickCount64());
+#else
+  timespec value;
+#ifdef CLOCK_MONOTONIC_COARSE
+  clock_gettime(CLOCK_MONOTONIC_COARSE, &value);
+#else
+  clock_gettime(CLOCK_MONOTONIC, &value);
+#endif
+  return static_cast<uint64_t>(value.tv_sec) * 1000 + 
+         static_cast<uint64_t>(value.tv_nsec) / 1000000;
+#endif
+}
+
+} //namespace
+
 template<> TimeManager *Singleton<TimeManager>::singleton_ = nullptr;
 TimeManager *TimeManager::getsingleton_pointer() {
   return singleton_;
@@ -20,7 +40,9 @@ TimeManager &TimeManager::getsingleton() {
 
 TimeManager::TimeManager() :
   start_time_{0},
-  current_time_{0} {
+  current_time_{0},
+  set_time_{0} {
+  memset(&tm_, 0, sizeof(tm_));
 }
 
 TimeManager::~TimeManager() {
@@ -28,32 +50,52 @@ TimeManager::~TimeManager() {
 }
 
 bool TimeManager::init() {
-#if OS_WIN
-  start_time_ = GetTickCount();
-  current_time_ = GetTickCount();
-#elif OS_UNIX
-  start_time_ = 0;
+  start_time_ = monotonic_time();
   current_time_ = 0;
-  gettimeofday(&start_, &time_zone_);
-#endif
   reset_time();
   g_file_name_fix = get_day_time();
   g_file_name_fix_last = get_tickcount();
   return true;
 }
 
-uint32_t TimeManager::get_tickcount() {
+uint64_t TimeManager::get_tickcount() {
+  auto result = monotonic_time() - start_time_;
+  current_time_.store(result, std::memory_order_relaxed);
+  return result;
+}
+
+uint64_t TimeManager::get_nanotime() {
+#if OS_UNIX
+  timespec value;
+  clock_gettime(CLOCK_MONOTONIC, &value);
+  return static_cast<uint64_t>(value.tv_sec) * 1000000000 + 
+         static_cast<uint64_t>(value.tv_nsec);
+#else
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+void TimeManager::tick() {
+  get_tickcount();
+  reset_time();
+}
+
+const char *TimeManager::get_wallclock_str() {
+  thread_local time_t second{-1};
+  thread_local char buffer[32]{0};
+  auto now = time(nullptr);
+  if (now == second) return buffer;
+  tm value;
 #if OS_WIN
-  current_time_ = GetTickCount();
-#elif OS_UNIX
-  gettimeofday(&end_, &time_zone_);
-  double time1 = static_cast<double>(start_.tv_sec * 1000) +
-           static_cast<double>(start_.tv_usec / 1000);
-  double time2 = static_cast<double>(end_.tv_sec * 1000) +
-           static_cast<double>(end_.tv_usec / 1000);
-  current_time_ = static_cast<uint32_t>(time2 - time1);
+  localtime_s(&value, &now);
+#else
+  localtime_r(&now, &value);
 #endif
-  return current_time_;
+  strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &value);
+  second = now;
+  return buffer;
 }
 
 uint32_t TimeManager::get_current_time() {
@@ -63,17 +105,18 @@ uint32_t TimeManager::get_current_time() {
   return time;
 }
 
-uint32_t TimeManager::get_start_time() const {
+uint64_t TimeManager::get_start_time() const {
   return start_time_;
 }
 
-uint32_t TimeManager::get_saved_time() const {
-  return current_time_;
+uint64_t TimeManager::get_saved_time() const {
+  return current_time_.load(std::memory_order_relaxed);
 }
 
 void TimeManager::reset_time() {
   time_t newtime;
   if (time(&newtime) != static_cast<time_t>(-1)) {
+    if (newtime == set_time_) return; //The tm once a second.
     set_time_ = newtime;
   }
 #if OS_WIN
@@ -101,7 +144,8 @@ uint32_t TimeManager::get_ctime() {
 
 void TimeManager::get_full_format_time(char *format_time, uint32_t length) {
   reset_time();
-  strftime(format_time, length, "%Y-%m-%d %H:%M:%S", &tm_);
+  if (0 == length) return;
+  snprintf(format_time, length, "%s", get_wallclock_str());
 }
 
 uint16_t TimeManager::get_year() {
@@ -187,10 +231,8 @@ uint32_t TimeManager::get_day_time() {
   return result;
 }
 
-uint32_t TimeManager::get_run_time() {
-  get_tickcount();
-  uint32_t result = current_time_ - start_time_;
-  return result;
+uint64_t TimeManager::get_run_time() {
+  return get_tickcount();
 }
 
 void TimeManager::time_totm(uint32_t time, tm* _tm) {
@@ -0,0 +1,195 @@
+#include "pf/basic/trace.h"
+
+namespace pf_basic {
+
+namespace trace {
+
+namespace {
+
+struct buffer_struct {
+  uint32_t tid;
+  std::string name;               //Changed with the g_mutex.
+  std::atomic<uint64_t> head;     //The next write index.
+  std::atomic<uint64_t> cleared;  //The events before it are dropped.
+  std::atomic<const char *> category; //The open span.
+  std::atomic<const char *> span;
+  event_t events[BASIC_TRACE_BUFFER_SIZE];
+  buffer_struct(uint32_t _tid, const std::string &_name) :
+    tid{_tid}, 
+    name{_name}, 
+    head{0}, 
+    cleared{0}, 
+    category{nullptr}, 
+    span{nullptr} {}
+};
+
+using buffer_t = buffer_struct;
+
+std::atomic<bool> g_enable{false};
+std::mutex g_mutex;
+std::list< std::unique_ptr<buffer_t> > g_buffers; //All threads, never release.
+thread_local buffer_t *t_buffer{nullptr};
+thread_local std::string t_name{""};
+
+buffer_t *current() {
+  if (t_buffer != nullptr) return t_buffer;
+  std::unique_lock<std::mutex> autolock(g_mutex);
+  auto tid = static_cast<uint32_t>(g_buffers.size() + 1);
+  std::unique_ptr<buffer_t> pointer(new buffer_t(tid, t_name));
+  t_buffer = pointer.get();
+  g_buffers.push_back(std::move(pointer));
+  return t_buffer;
+}
+
+void append_escape(std::string &content, const std::string &value) {
+  for (auto c : value) {
+    if ('"' == c || '\\' == c) content += '\\';
+    if (static_cast<unsigned char>(c) >= 0x20) content += c;
+  }
+}
+
+void append_event(std::string &content, uint32_t tid, const event_t &event) {
+  char temp[512]{0};
+  snprintf(temp,
+           sizeof(temp) - 1,
+           "{\"ph\":\"X\",\"cat\":\"%s\",\"name\":\"%s\",\"pid\":1,"
+           "\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f",
+           event.category,
+           event.name,
+           tid,
+           event.begin / 1000.0,
+           event.duration / 1000.0);
+  content += temp;
+  if (event.arg != BASIC_TRACE_ARG_NONE) {
+    snprintf(temp,
+             sizeof(temp) - 1,
+             ",\"args\":{\"arg\":%" PRId64 "}",
+             event.arg);
+    content += temp;
+  }
+  content += "},\n";
+}
+
+} //namespace
+
+bool enable() {
+  return g_enable.load(std::memory_order_relaxed);
+}
+
+void set_enable(bool flag) {
+  g_enable = flag;
+}
+
+void set_thread_name(const std::string &name) {
+  t_name = name;
+  if (is_null(t_buffer)) return;
+  std::unique_lock<std::mutex> autolock(g_mutex);
+  t_buffer->name = name;
+}
+
+void record(const char *category,
+            const char *name,
+            int64_t arg,
+            uint64_t begin,
+            uint64_t duration) {
+  auto buffer = current();
+  auto head = buffer->head.load(std::memory_order_relaxed);
+  auto &event = buffer->events[head & (BASIC_TRACE_BUFFER_SIZE - 1)];
+  event.category = category;
+  event.name = name;
+  event.arg = arg;
+  event.begin = begin;
+  event.duration = duration;
+  buffer->head.store(head + 1, std::memory_order_release);
+}
+
+uint32_t thread_id() {
+  return enable() ? current()->tid : 0;
+}
+
+std::string current_span(uint32_t tid) {
+  if (0 == tid) return "";
+  std::unique_lock<std::mutex> autolock(g_mutex);
+  for (auto &buffer : g_buffers) {
+    if (buffer->tid != tid) continue;
+    //Read without the owner, the pair may be mismatched in a moment.
+    auto category = buffer->category.load(std::memory_order_relaxed);
+    auto span = buffer->span.load(std::memory_order_relaxed);
+    if (is_null(span)) return "";
+    return std::string{is_null(category) ? "" : category} + "/" + span;
+  }
+  return "";
+}
+
+std::pair<const char *, const char *> open(const char *category,
+                                           const char *name) {
+  auto buffer = current();
+  std::pair<const char *, const char *> last{
+    buffer->category.load(std::memory_order_relaxed),
+    buffer->span.load(std::memory_order_relaxed)};
+  buffer->category.store(category, std::memory_order_relaxed);
+  buffer->span.store(name, std::memory_order_relaxed);
+  return last;
+}
+
+void close(const std::pair<const char *, const char *> &last) {
+  auto buffer = current();
+  buffer->category.store(last.first, std::memory_order_relaxed);
+  buffer->span.store(last.second, std::memory_order_relaxed);
+}
+
+void dump(std::string &content) {
+  content = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+  std::vector<event_t> events;
+  std::unique_lock<std::mutex> autolock(g_mutex);
+  for (auto &buffer : g_buffers) {
+    if (buffer->name != "") {
+      content += "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":";
+      content += std::to_string(buffer->tid);
+      content += ",\"args\":{\"name\":\"";
+      append_escape(content, buffer->name);
+      content += "\"}},\n";
+    }
+    auto head = buffer->head.load(std::memory_order_acquire);
+    auto start = head > BASIC_TRACE_BUFFER_SIZE ?
+      head - BASIC_TRACE_BUFFER_SIZE : 0;
+    auto cleared = buffer->cleared.load(std::memory_order_relaxed);
+    if (start < cleared) start = cleared;
+    events.clear();
+    for (auto i = start; i < head; ++i)
+      events.push_back(buffer->events[i & (BASIC_TRACE_BUFFER_SIZE - 1)]);
+    //The owner may overwrite the oldest while copying, skip them(the slot
+    //of last - BASIC_TRACE_BUFFER_SIZE may be writing now).
+    auto last = buffer->head.load(std::memory_order_acquire);
+    auto wrapped = last >= BASIC_TRACE_BUFFER_SIZE;
+    auto valid = wrapped ? last - BASIC_TRACE_BUFFER_SIZE : 0;
+    for (size_t i = 0; i < events.size(); ++i) {
+      if (wrapped && start + i <= valid) continue;
+      append_event(content, buffer->tid, events[i]);
+    }
+  }
+  if (',' == content[content.size() - 2]) content.erase(content.size() - 2, 1);
+  content += "]}\n";
+}
+
+bool save(const std::string &filename) {
+  std::string content;
+  dump(content);
+  auto fp = fopen(filename.c_str(), "wb");
+  if (is_null(fp)) return false;
+  auto size = fwrite(content.data(), 1, content.size(), fp);
+  fclose(fp);
+  return size == content.size();
+}
+
+void clear() {
+  std::unique_lock<std::mutex> autolock(g_mutex);
+  for (auto &buffer : g_buffers) {
+    buffer->cleared.store(buffer->head.load(std::memory_order_acquire),
+                          std::memory_order_relaxed);
+  }
+}
+
+} //namespace trace
+
+} //namespace pf_basic
@@ -3,18 +3,21 @@
 #include "pf/basic/string.h"
 #include "pf/basic/stringstream.h"
 #include "pf/basic/monitor.h"
+#include "pf/basic/trace.h"
 #include "pf/basic/io.tcc"
 #include "pf/db/interface.h"
 #include "pf/db/query.h"
 #include "pf/net/connection/basic.h"
 #include "pf/cache/packet/db_query.h"
 #include "pf/sys/thread.h"
+#include "pf/sys/executor.h"
 #include "pf/sys/memory/share.h"
 #include "pf/engine/kernel.h"
 #include "pf/cache/db_store.h"
 
 #define cache_clear(k) {using namespace pf_sys::memory::share; \
-  if (GLOBALS["default.cache.clear"] == true) clear(k); \
+  if (pf_basic::config::get<bool>("default.cache.clear") && \
+      !pf_basic::config::get<bool>("app.upgrade")) clear(k); \
 }
 
 #define CACHE_SHARE_FLAG (pf_sys::memory::share::kFlagMax + 1)
@@ -32,6 +35,7 @@ DBStore::DBStore() :
   net_manager_{nullptr},
   get_db_connection_func_{nullptr},
   workers_{nullptr},
+  executor_{nullptr},
   cache_last_check_time_{0},
   dbenv_{kDBEnvMysql} {
   keys_.key_map = ID_INVALID;
@@ -192,10 +196,13 @@ bool DBStore::init() {
                   hash_recycle_count);
     return false;
   }
-  auto workers_count = GLOBALS["default.cache.workers"].get<int32_t>();
-  auto workers = new pf_sys::ThreadPool(workers_count);
-  if (is_null(workers)) return false;
-  unique_move(pf_sys::ThreadPool, workers, workers_);
+  if (is_null(executor_)) {
+    auto workers_count = 
+      pf_basic::config::get<int32_t>("default.cache.workers");
+    auto workers = new pf_sys::ThreadPool(workers_count, "dbstore");
+    if (is_null(workers)) return false;
+    unique_move(pf_sys::ThreadPool, workers, workers_);
+  }
   ready_ = true;
   return true;
 }
@@ -594,6 +601,7 @@ bool DBStore::recycle_find(int32_t key, int32_t index) {
 //and need protected with multi threads.
 //The update query can record the change status to update to sql.
 bool DBStore::query(const std::string &key) {
+  TRACE_SCOPE("cache", "query");
   hash_common(key, false, cache_error);
   cache_lock(cache, cachelock);
   std::string sql{""};
@@ -636,6 +644,23 @@ bool DBStore::query(const std::string &key) {
   return kQuerySuccess == cache->status ? true : false;
 }
 
+pf_sys::Awaitable<bool> DBStore::load(const std::string &key) {
+  pf_sys::Promise<bool> promise;
+  if (!ready_ || (!executor_ && !workers_)) {
+    promise.set_value(false);
+    return promise.awaitable();
+  }
+  auto task = [this, key, promise]() mutable {
+    promise.set_value(this->query(key));
+  };
+  if (executor_) {
+    executor_->submit(task);
+  } else {
+    workers_->enqueue(task);
+  }
+  return promise.awaitable();
+}
+
 bool DBStore::waitquery(const char *key) {
   if (query_map_.full()) return false;
   query_map_.set(key, "1");
@@ -896,7 +921,11 @@ void DBStore::tick() {
     if (query_map_.size() > 0) {
       std::string key{""}; std::string value{""};
       query_map_.pop_front(key, value);
-      workers_->enqueue([this, key](){ this->query(key); });
+      if (executor_) {
+        executor_->submit([this, key](){ this->query(key); });
+      } else {
+        workers_->enqueue([this, key](){ this->query(key); });
+      }
     }
   }
 
@@ -905,14 +934,21 @@ void DBStore::tick() {
     if (!forgetlist_.empty()) {
       std::string key = forgetlist_.back();
       forgetlist_.pop_back();
-      workers_->enqueue([this, key](){ 
-          this->query(key); this->forget(key.c_str()); });
+      auto task = [this, key](){ 
+        this->query(key); this->forget(key.c_str()); };
+      if (executor_) {
+        executor_->submit(task);
+      } else {
+        workers_->enqueue(task);
+      }
     }
   }
 
   //Check live time.
   static uint32_t check_time = CACHE_SHARE_DEFAULT_MINUTES * 60;
-  auto current_time = TIME_MANAGER_POINTER->get_current_time();
+  //The seconds(the monotonic tick cached), not the packed current time.
+  auto current_time = 
+    static_cast<uint32_t>(TIME_MANAGER_POINTER->get_saved_time() / 1000);
   if (forgetlist_.empty() && 
       current_time - cache_last_check_time_ > check_time) {
     cache_last_check_time_ = current_time;
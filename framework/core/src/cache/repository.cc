@@ -3,7 +3,7 @@
 
 namespace pf_cache {
 
-Repository::Repository(StoreInterface *_store) {
+Repository::Repository(StoreInterface *_store) : hits_{0}, misses_{0} {
   store_ = _store;
   minutes_ = 0;
 }
@@ -21,7 +21,12 @@ void *Repository::get(const char *key, void *_default) {
   void *result = _default;
   if (is_null(store_)) return result;
   result = store_->get(key);
-  if (is_null(result)) result = _default;
+  if (is_null(result)) {
+    misses_.fetch_add(1, std::memory_order_relaxed);
+    result = _default;
+  } else {
+    hits_.fetch_add(1, std::memory_order_relaxed);
+  }
   return result;
 }
 
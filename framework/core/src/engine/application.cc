@@ -29,7 +29,7 @@ static bool pidfile_isexists(bool perr) {
 
 /* all default functions { */
 void daemon() {
-  if (pidfile_isexists(true)) return;
+  if (GLOBALS["app.upgrade"] != true && pidfile_isexists(true)) return;
   pf_sys::process::daemon();
   Application::getsingleton().without_command_run();
 }
@@ -60,8 +60,8 @@ void signal_handler(int32_t signal) {
   using namespace pf_basic;
   if (GLOBALS["app.status"] == kAppStatusStop) return;
   //处理前台模式信号
-  static uint32_t last_signaltime = 0;
-  uint32_t currenttime = TIME_MANAGER_POINTER->get_tickcount();
+  static uint64_t last_signaltime = 0;
+  uint64_t currenttime = TIME_MANAGER_POINTER->get_tickcount();
   if (signal == SIGINT) {
     if (currenttime - last_signaltime > 10 * 1000) {
       io_cdebug(
@@ -91,8 +91,8 @@ void signal_handler(int32_t signal) {
 BOOL WINAPI signal_handler(DWORD event) {
   if (GLOBALS["app.status"] == kAppStatusStop) return;
   using namespace pf_basic;
-  static uint32_t last_signaltime = 0;
-  uint32_t currenttime = TIME_MANAGER_POINTER->get_tickcount();
+  static uint64_t last_signaltime = 0;
+  uint64_t currenttime = TIME_MANAGER_POINTER->get_tickcount();
   switch (event) {
     case CTRL_C_EVENT: {
       if (currenttime - last_signaltime > 10 * 1000) {
@@ -237,6 +237,7 @@ bool Application::set_env_globals(bool perr) {
       GLOBALS[name] = value;
     }
   }
+  pf_basic::config::commit();
   return true;
 }
 
@@ -270,6 +271,8 @@ void Application::set_pidfile() {
 }
 
 void Application::run() {
+  //The old process is running, take its sockets(default.net.handoff).
+  if ("1" == args_["upgrade"]) GLOBALS["app.upgrade"] = true;
   if (args_flag_ & has_error) {
     pf_basic::io_cerr("The application args error!");
   } else if ("1" == args_["stop"]) {
@@ -285,7 +288,7 @@ void Application::run() {
   } else {
     if (!set_env_globals(true)) return; 
     set_pidfile();
-    if (pidfile_isexists(true)) return;
+    if (GLOBALS["app.upgrade"] != true && pidfile_isexists(true)) return;
     without_command_run();
   }
 }
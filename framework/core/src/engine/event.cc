@@ -0,0 +1,90 @@
+#include "pf/basic/logger.h"
+#include "pf/engine/event.h"
+#if OS_UNIX && defined(__linux__)
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <poll.h>
+#define ENGINE_EVENT_FD 1
+#else
+#define ENGINE_EVENT_FD 0
+#endif
+
+using namespace pf_engine;
+
+Event::Event() : eventfd_{-1}, timerfd_{-1}, notified_{false} {
+}
+
+Event::~Event() {
+#if ENGINE_EVENT_FD
+  if (eventfd_ >= 0) close(eventfd_);
+  if (timerfd_ >= 0) close(timerfd_);
+#endif
+}
+
+bool Event::init() {
+#if ENGINE_EVENT_FD
+  if (eventfd_ >= 0) return true;
+  eventfd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  timerfd_ = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+  if (eventfd_ < 0 || timerfd_ < 0) {
+    SLOW_ERRORLOG(ENGINE_MODULENAME,
+                  "[engine] Event::init failed, errno: %d",
+                  errno);
+    if (eventfd_ >= 0) close(eventfd_);
+    if (timerfd_ >= 0) close(timerfd_);
+    eventfd_ = timerfd_ = -1;
+    return false;
+  }
+#endif
+  return true;
+}
+
+void Event::notify() {
+#if ENGINE_EVENT_FD
+  if (eventfd_ >= 0) {
+    uint64_t value{1};
+    auto result = write(eventfd_, &value, sizeof(value));
+    (void)result; //The counter overflow(EAGAIN) is still readable.
+    return;
+  }
+#endif
+  std::unique_lock<std::mutex> autolock(mutex_);
+  notified_ = true;
+  condition_.notify_one();
+}
+
+void Event::wait(uint64_t deadline) {
+#if ENGINE_EVENT_FD
+  if (eventfd_ >= 0) {
+    //The steady clock is CLOCK_MONOTONIC, so use it as absolute time, zero
+    //value will disarm the timer.
+    struct itimerspec spec;
+    memset(&spec, 0, sizeof(spec));
+    spec.it_value.tv_sec = static_cast<time_t>(deadline / 1000000000);
+    spec.it_value.tv_nsec = static_cast<long>(deadline % 1000000000);
+    timerfd_settime(timerfd_, TFD_TIMER_ABSTIME, &spec, nullptr);
+    struct pollfd fds[2];
+    fds[0].fd = eventfd_;
+    fds[0].events = POLLIN;
+    fds[1].fd = timerfd_;
+    fds[1].events = POLLIN;
+    if (poll(fds, 2, -1) <= 0) return; //EINTR.
+    uint64_t value{0};
+    ssize_t result{0};
+    if (fds[0].revents & POLLIN) result = read(eventfd_, &value, sizeof(value));
+    if (fds[1].revents & POLLIN) result = read(timerfd_, &value, sizeof(value));
+    (void)result;
+    return;
+  }
+#endif
+  std::unique_lock<std::mutex> autolock(mutex_);
+  if (0 == deadline) {
+    condition_.wait(autolock, [this]() { return notified_; });
+  } else {
+    std::chrono::steady_clock::time_point time{
+      std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+          std::chrono::nanoseconds(deadline))};
+    condition_.wait_until(autolock, time, [this]() { return notified_; });
+  }
+  notified_ = false;
+}
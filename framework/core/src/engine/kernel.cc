@@ -5,20 +5,28 @@
 #include "pf/basic/base64.h"
 #include "pf/basic/string.h"
 #include "pf/basic/logger.h"
+#include "pf/basic/trace.h"
 #include "pf/net/connection/manager/listener.h"
 #include "pf/net/connection/manager/listener_factory.h"
 #include "pf/net/connection/manager/connector.h"
 #include "pf/net/packet/handshake.h"
 #include "pf/net/packet/register_connection_name.h"
+#include "pf/net/metrics.h"
+#include "pf/net/capture.h"
+#include "pf/net/protocol/http.h"
+#include "pf/net/socket/api.h"
+#include "pf/net/handoff.h"
 #include "pf/db/interface.h"
 #include "pf/db/null.h"
 #include "pf/db/factory.h"
+#include "pf/db/query.h"
 #include "pf/script/factory.h"
 #include "pf/script/interface.h"
 #include "pf/cache/repository.h"
 #include "pf/cache/db_store.h"
 #include "pf/cache/manager.h"
 #include "pf/sys/thread.h"
+#include "pf/sys/process.h"
 #include "pf/engine/thread.h"
 #include "pf/file/library.h"
 #include "pf/engine/kernel.h"
@@ -31,6 +39,13 @@ pf_db::Interface *db_null_env_creator() {
   return new pf_db::Null();
 }
 
+//The committed config, the init phases(may run parallel) not read the 
+//GLOBALS(the operator[] insert the missing name).
+template <typename T>
+static T setting(const std::string &name) {
+  return pf_basic::config::get<T>(name);
+}
+
 Kernel *Kernel::getsingleton_pointer() {
   return singleton_;
 }
@@ -48,13 +63,19 @@ Kernel::Kernel() :
   script_factory_{nullptr},
   script_eid_{SCRIPT_EID_INVALID},
   isinit_{false},
-  stop_{false} {
+  metrics_http_{nullptr},
+  executor_{nullptr},
+  stop_{false},
+  shutdown_{false} {
 }
 
 Kernel::~Kernel() {
+  shutdown();
+  executor_.reset();
   for (std::thread &worker : thread_workers_) {
     worker.join();
   }
+  pf_net::capture::close();
 }
 
 pf_db::Interface *Kernel::get_db() {
@@ -110,84 +131,291 @@ pf_db::Interface *Kernel::get_db(const std::string &name) {
 
 bool Kernel::init() {
   if (isinit_) return true;
-  if (!init_base()) return false;
-  if (!init_net()) return false;
-  if (!init_db()) return false;
-  if (!init_cache()) return false;
-  if (!init_script()) return false;
-  SLOW_DEBUGLOG(ENGINE_MODULENAME, "[%s] Kernel::init ok!", ENGINE_MODULENAME);
+  pf_basic::config::commit(); //The GLOBALS set before init.
+  pf_basic::trace::set_enable(GLOBALS["default.engine.trace"] == true);
+  auto start = std::chrono::steady_clock::now();
+  if (!init_phase(init_phase_t("base", [this]() { return init_base(); })))
+    return false;
+  //Bind before init, the pools and share memory alloc in the main node.
+  pf_sys::thread::bind("main");
+  if (!event_.init()) return false;
+  auto workers = GLOBALS["default.engine.workers"].get<int32_t>();
+  if (workers < 0)
+    workers = static_cast<int32_t>(std::thread::hardware_concurrency());
+  if (workers > 0) {
+    std::unique_ptr<pf_sys::Executor> executor(new pf_sys::Executor(workers));
+    executor_ = std::move(executor);
+  }
+  //The net, db connects and cache share memory are independent.
+  std::vector<init_phase_t> phases = {
+    init_phase_t("net", [this]() { return init_net(); }),
+    init_phase_t("db", [this]() { return init_db(); }),
+    init_phase_t("cache", [this]() { return init_cache(); }),
+  };
+  auto parallel = GLOBALS["default.engine.initparallel"] == true;
+  pf_basic::config::commit(); //The phases read the snapshot.
+  if (!init_phases(phases, parallel)) return false;
+  for (auto it = listen_pending_.begin(); it != listen_pending_.end(); ++it)
+    listen_list_[it->first] = it->second;
+  listen_pending_.clear();
+  //The handoff adopt to the listeners, the script bootstrap may use all.
+  init_phase_t handoff("handoff", [this]() { return init_handoff(); });
+  init_phase_t script("script", [this]() { return init_script(); });
+  if (!init_phase(handoff) || !init_phase(script)) return false;
+  auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - start).count();
+  SLOW_LOG(ENGINE_MODULENAME, 
+           "[%s] Kernel::init ok in %dms!", 
+           ENGINE_MODULENAME,
+           static_cast<int32_t>(ms));
   return true;
 }
 
+bool Kernel::init_phase(const init_phase_t &phase) {
+  auto start = std::chrono::steady_clock::now();
+  auto result = phase.function();
+  auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - start).count();
+  if (result) {
+    SLOW_LOG(ENGINE_MODULENAME,
+             "[%s] Kernel::init %s ok in %dms",
+             ENGINE_MODULENAME,
+             phase.name.c_str(),
+             static_cast<int32_t>(ms));
+  } else {
+    SLOW_ERRORLOG(ENGINE_MODULENAME,
+                  "[%s] Kernel::init %s failed in %dms",
+                  ENGINE_MODULENAME,
+                  phase.name.c_str(),
+                  static_cast<int32_t>(ms));
+  }
+  return result;
+}
+
+bool Kernel::init_phases(const std::vector<init_phase_t> &phases, 
+                         bool parallel) {
+  if (!parallel) {
+    for (auto &phase : phases) {
+      if (!init_phase(phase)) return false;
+    }
+    return true;
+  }
+  std::map< std::string, std::shared_future<bool> > futures;
+  for (auto &phase : phases) {
+    std::vector< std::shared_future<bool> > depends;
+    for (auto &name : phase.depends) {
+      auto it = futures.find(name);
+      if (it != futures.end()) depends.push_back(it->second);
+    }
+    futures[phase.name] = std::async(std::launch::async, 
+                                     [this, &phase, depends]() {
+      for (auto &depend : depends) {
+        if (!depend.get()) return false; //Not run if the depend failed.
+      }
+      return init_phase(phase);
+    }).share();
+  }
+  //Wait all, the phases use this object.
+  bool result = true;
+  for (auto &phase : phases) result = futures[phase.name].get() && result;
+  return result;
+}
+
 void Kernel::run() {
+  int32_t hint{0}; //Spread the ticks to the workers.
   if (!is_null(net_)) {
     auto net = net_.get();
-    this->newthread([&net]() { return thread::for_net(net); });
+    tick("net0", [net]() { return thread::for_net(net); }, hint++);
   }
   if (!is_null(db_factory_) && db_eid_ != DB_EID_INVALID) {
     auto env = db_factory_->getenv(db_eid_);
-    this->newthread([&env]() { return thread::for_db(env); });
+    tick("db", [env]() { return thread::for_db(env); }, hint++);
   }
   if (!is_null(script_factory_) && script_eid_ != SCRIPT_EID_INVALID) { 
     auto env = script_factory_->getenv(script_eid_);
     env->call(GLOBALS["default.script.enter"].data);
-    this->newthread([&env]() { return thread::for_script(env); });
+    //The executor drain the tasks when enqueue, not wait the tick.
+    if (executor_) {
+      auto executor = executor_.get();
+      auto script_hint = hint;
+      env->task_queue()->set_wakeup([executor, env, script_hint]() {
+        executor->submit([env]() { thread::for_script_tasks(env); }, 
+                         script_hint);
+      });
+    }
+    tick("script", [env]() { return thread::for_script(env); }, hint++);
   }
   if (!is_null(cache_)) {
     auto cache = cache_.get();
-    this->newthread([&cache]() { return thread::for_cache(cache); });
+    tick("cache", [cache]() { return thread::for_cache(cache); }, hint++);
   }
   if (!is_null(net_listener_factory_)) {
+    int32_t index{1};
     for (auto it = listen_list_.begin(); it != listen_list_.end(); ++it) {
       auto net = net_listener_factory_->getenv(it->second);
-      if (!is_null(net))
-        this->newthread([&net]() { return thread::for_net(net); });
+      if (is_null(net)) continue;
+      tick("net" + std::to_string(index++), 
+           [net]() { return thread::for_net(net); }, 
+           hint++);
     }
   }
-  if (!is_null(net_connector_))
-    this->newthread(
-        [this]() { return thread::for_net(net_connector_.get()); });
+  if (!is_null(net_connector_)) {
+    auto net = net_connector_.get();
+    tick("connector", [net]() { return thread::for_net(net); }, hint++);
+  }
   GLOBALS["app.status"] = kAppStatusRunning;
+  pf_basic::config::commit();
+  auto frame = GLOBALS["default.engine.frame"].get<uint32_t>();
+  watchdog_.start(GLOBALS["default.engine.watchdog"].get<uint32_t>(),
+                  frame > 0 ? 1000000000 / frame : 0);
+  if (GLOBALS["default.net.replay"].data != "") replay();
   loop();
 }
 
+//Only mark and wakeup(safe in the signal handler), the loop do the shutdown.
 void Kernel::stop() {
+  stop_ = true;
+  event_.notify();
+}
+
+void Kernel::shutdown() {
+  if (shutdown_) return;
+  shutdown_ = true;
+  watchdog_.stop();
+  if (!is_null(script_factory_) && script_eid_ != SCRIPT_EID_INVALID) {
+    auto env = script_factory_->getenv(script_eid_);
+    if (env) env->task_queue()->set_wakeup(nullptr);
+  }
   for (std::thread &worker : thread_workers_) {
     pf_sys::thread::stop(worker);
   }
-  stop_ = true;
-  GLOBALS["app.status"] = kAppStatusStop;
+  if (executor_) executor_->stop();
+}
+
+void Kernel::tick(const std::string &name, 
+                  const std::function<bool()> &function, 
+                  int32_t hint) {
+  auto frame = GLOBALS["default.engine.frame"].get<uint32_t>();
+  uint64_t budget = frame > 0 ? 1000000000 / frame : 0;
+  auto stat = watchdog_.add(name);
+  auto _function = [stat, function, budget]() {
+    TIME_MANAGER_POINTER->get_tickcount(); //Refresh the saved time.
+    stat->on_begin();
+    auto result = function();
+    stat->on_end(budget);
+    return result;
+  };
+  if (executor_) {
+    //The workers bind self(executor0...).
+    executor_->every(frame > 0 ? 1000 / frame : 0, _function, hint);
+  } else {
+    auto bound = std::make_shared<bool>(false);
+    newthread([name, _function, bound]() {
+      if (!*bound) {
+        pf_sys::thread::bind(name);
+        *bound = true;
+      }
+      return _function();
+    });
+  }
+}
+
+void Kernel::schedule(const std::function<void()> &function,
+                      uint32_t delay,
+                      uint32_t interval) {
+  schedule_t item;
+  item.deadline =
+    pf_net::metrics::now() + static_cast<uint64_t>(delay) * 1000000;
+  item.interval = static_cast<uint64_t>(interval) * 1000000;
+  item.function = function;
+  {
+    std::unique_lock<std::mutex> autolock(queue_mutex_);
+    schedules_.push(std::move(item));
+  }
+  event_.notify();
+}
+
+pf_sys::Awaitable<db_result_t> Kernel::query(const std::string &sql, 
+                                             const std::string &dbname) {
+  pf_sys::Promise<db_result_t> promise;
+  auto db = "" == dbname ? get_db() : get_db(dbname);
+  if (is_null(db)) {
+    promise.set_error("the db not found: " + dbname);
+    return promise.awaitable();
+  }
+  async([db, sql, promise]() mutable {
+    db_result_t result;
+    {
+      db_lock(db, db_auto_lock);
+      pf_db::Query _query;
+      _query.set_sql(sql);
+      result.success = _query.init(db) && _query.query();
+      if (result.success) _query.fetcharray(result.fetch);
+    }
+    if (result.success) {
+      promise.set_value(result);
+    } else {
+      promise.set_error("the query failed: " + sql);
+    }
+  });
+  return promise.awaitable();
+}
+
+pf_sys::Awaitable<bool> Kernel::delay(uint32_t time) {
+  pf_sys::Promise<bool> promise;
+  schedule([promise]() mutable { promise.set_value(true); }, time);
+  return promise.awaitable();
 }
 
 pf_net::connection::Basic *Kernel::default_connect(
     const std::string &name, 
     const std::string &ip, 
     uint16_t port, 
-    const std::string &_encrypt_str) {
+    const std::string &_encrypt_str,
+    bool compact) {
   using namespace pf_net::connection::manager;
   if (is_null(net_) || net_->is_service()) return nullptr;
   auto encrypt_str = 
-    "" == _encrypt_str ?  GLOBALS["default.net.encrypt"].data : _encrypt_str;
-  return connect(net_.get(), name, ip, port, encrypt_str);
+    "" == _encrypt_str ? setting<std::string>("default.net.encrypt") :
+    _encrypt_str;
+  compact = compact || setting<bool>("default.net.compact");
+  auto connection = connect(net_.get(), name, ip, port, encrypt_str, compact);
+  if (!is_null(connection)) {
+    if (setting<bool>("default.net.nodelay"))
+      connection->socket()->set_nodelay(true);
+    connection->set_send_policy(static_cast<pf_net::connection::send_policy_t>(
+          setting<int8_t>("default.net.sendpolicy")));
+  }
+  return connection;
 }
 
 pf_net::connection::Basic *Kernel::connect(const std::string &name) {
   if (connect_env_.find(name) == connect_env_.end()) return nullptr;
   auto id = connect_env_[name];
-  auto ip = GLOBALS["client.ip" + std::to_string(id)].data;
-  auto port = GLOBALS["client.port" + std::to_string(id)].get<uint16_t>();
-  auto encrypt_str = GLOBALS["client.encrypt" + std::to_string(id)].data;
-  auto connection = connect(name, ip, port, encrypt_str);
-  if (!is_null(connection))
+  auto ip = setting<std::string>("client.ip" + std::to_string(id));
+  auto port = setting<uint16_t>("client.port" + std::to_string(id));
+  auto encrypt_str = 
+    setting<std::string>("client.encrypt" + std::to_string(id));
+  auto compact = setting<bool>("client.compact" + std::to_string(id));
+  auto connection = connect(name, ip, port, encrypt_str, compact);
+  if (!is_null(connection)) {
     connect_list_[name] = connection->get_id();
+    if (setting<bool>("client.nodelay" + std::to_string(id)))
+      connection->socket()->set_nodelay(true);
+    auto send_policy = 
+      setting<int8_t>("client.sendpolicy" + std::to_string(id));
+    connection->set_send_policy(
+        static_cast<pf_net::connection::send_policy_t>(send_policy));
+  }
   return connection;
 }
 
 pf_net::connection::Basic *Kernel::connect(const std::string &name, 
                                            const std::string &ip, 
                                            uint16_t port, 
-                                           const std::string &encrypt_str) {
-  return connect(net_connector_.get(), name, ip, port, encrypt_str);
+                                           const std::string &encrypt_str,
+                                           bool compact) {
+  return connect(net_connector_.get(), name, ip, port, encrypt_str, compact);
 }
 
 pf_net::connection::Basic *Kernel::connect(
@@ -195,7 +423,8 @@ pf_net::connection::Basic *Kernel::connect(
     const std::string &name, 
     const std::string &ip, 
     uint16_t port, 
-    const std::string &encrypt_str) {
+    const std::string &encrypt_str,
+    bool compact) {
   using namespace pf_net::connection::manager;
   using namespace pf_basic;
   if (is_null(client)) return nullptr;
@@ -213,17 +442,12 @@ pf_net::connection::Basic *Kernel::connect(
 
   //Handshake.
   if (encrypt_str != "") {
-    auto now = TIME_MANAGER_POINTER->get_ctime();
-    std::string str{""};
-    pf_basic::string::encrypt(encrypt_str, now, str);
-    char temp[512]{0,};
-    string::safecopy(temp, str.c_str(), sizeof(temp) - 1);
-    //std::cout << "str: " << str << std::endl;
-    auto key = base64_encode(reinterpret_cast<unsigned char *>(temp), strlen(temp));
-    //std::cout << "key: " << key << std::endl;
     pf_net::packet::Handshake handshake;
-    handshake.set_key(key);
+    handshake.set_encrypt_key(encrypt_str);
+    if (compact) handshake.set_flags(pf_net::packet::Handshake::kFlagCompact);
     connection->send(&handshake);
+    //After handshake all packets use the compact header.
+    if (compact) connection->set_protocol(Interface::protocol_compact());
   }
   return connection;
 }
@@ -284,19 +508,37 @@ bool Kernel::init_net() {
   SLOW_DEBUGLOG(ENGINE_MODULENAME, 
                 "[%s] Kernel::init_net start...", 
                 ENGINE_MODULENAME);
-  if (GLOBALS["default.net.open"] == true) {
+  metrics::set_enable(setting<bool>("default.net.metrics"));
+  if (setting<std::string>("default.net.capture") != "" && 
+      !capture::open(setting<std::string>("default.net.capture"))) return false;
+  //Receive the sockets from the old process before listen(--upgrade).
+  if (setting<bool>("app.upgrade") && 
+      setting<std::string>("default.net.handoff") != "" &&
+      !handoff::receive(setting<std::string>("default.net.handoff")))
+    return false;
+  if (setting<bool>("default.net.open")) {
     connection::manager::Basic *net{nullptr};
-    auto conn_max = GLOBALS["default.net.connmax"].get<uint16_t>();
-    if (GLOBALS["default.net.service"] == true) {
+    auto conn_max = setting<uint16_t>("default.net.connmax");
+    if (setting<bool>("default.net.service")) {
       net = new connection::manager::Listener();
       unique_move(connection::manager::Basic, net, net_)
-      auto service_ip = GLOBALS["default.net.ip"].c_str();
-      auto service_port = GLOBALS["default.net.port"].get<uint16_t>();
+      auto service_ip = setting<std::string>("default.net.ip");
+      auto service_port = setting<uint16_t>("default.net.port");
       auto service = dynamic_cast< connection::manager::Listener *>(net);
-      auto encrypt_str = GLOBALS["default.net.encrypt"].data;
+      auto encrypt_str = setting<std::string>("default.net.encrypt");
       if (!service->init(conn_max, service_port, service_ip)) return false;
       std::string host{service->host()};
       if (encrypt_str != "") service->set_safe_encrypt_str(encrypt_str);
+      service->set_compact(setting<bool>("default.net.compact"));
+      service->set_nodelay(setting<bool>("default.net.nodelay"));
+      service->set_send_policy(static_cast<connection::send_policy_t>(
+            setting<int8_t>("default.net.sendpolicy")));
+      service->set_limit(connection::limit_rule_t(
+            setting<uint32_t>("default.net.limitrate"),
+            setting<uint32_t>("default.net.limitburst"),
+            static_cast<connection::limit_action_t>(
+              setting<int8_t>("default.net.limitaction"))));
+      service->set_capture(capture::is_open());
       SLOW_DEBUGLOG(ENGINE_MODULENAME,
                     "[%s] service listen at: host[%s] port[%d] max[%d].",
                     ENGINE_MODULENAME,
@@ -310,8 +552,8 @@ bool Kernel::init_net() {
     }
   }
   //Extra net listeners.
-  if (GLOBALS["server.count"] > 0) {
-    auto count = GLOBALS["server.count"].get<int8_t>();
+  if (setting<int32_t>("server.count") > 0) {
+    auto count = setting<int8_t>("server.count");
     SLOW_DEBUGLOG(ENGINE_MODULENAME, 
                   "[%s] Kernel::init_net extra service count: %d", 
                   ENGINE_MODULENAME,
@@ -322,7 +564,7 @@ bool Kernel::init_net() {
     unique_move(ListenerFactory, factory, net_listener_factory_);
     for (int8_t i = 0; i < count; ++i) {
       //From global values.
-      auto name = GLOBALS["server.name" + std::to_string(i)].data;
+      auto name = setting<std::string>("server.name" + std::to_string(i));
       if ("" == name) {
         SLOW_ERRORLOG(ENGINE_MODULENAME,
                       "[%s] Kernel::init_net extra service can't get name: %d",
@@ -331,10 +573,15 @@ bool Kernel::init_net() {
         return false;
       }
       auto conn_max = 
-        GLOBALS["server.connmax" + std::to_string(i)].get<uint16_t>();
-      auto ip = GLOBALS["server.ip" + std::to_string(i)].data;
-      auto port = GLOBALS["server.port" + std::to_string(i)].get<uint16_t>();
-      auto encrypt_str = GLOBALS["server.encrypt" + std::to_string(i)].data;
+        setting<uint16_t>("server.connmax" + std::to_string(i));
+      auto ip = setting<std::string>("server.ip" + std::to_string(i));
+      auto port = setting<uint16_t>("server.port" + std::to_string(i));
+      auto encrypt_str = 
+        setting<std::string>("server.encrypt" + std::to_string(i));
+      auto compact = setting<bool>("server.compact" + std::to_string(i));
+      auto nodelay = setting<bool>("server.nodelay" + std::to_string(i));
+      auto send_policy = 
+        setting<int8_t>("server.sendpolicy" + std::to_string(i));
       if (0 == port || conn_max <= 0) {
         SLOW_ERRORLOG(ENGINE_MODULENAME,
                       "[%s] Kernel::init_net extra service the port or "
@@ -352,9 +599,20 @@ bool Kernel::init_net() {
       config.port = port;
       config.conn_max = conn_max;
       config.encrypt_str = encrypt_str;
+      config.compact = compact;
+      config.nodelay = nodelay;
+      config.send_policy = send_policy;
+      config.limit.rate = 
+        setting<uint32_t>("server.limitrate" + std::to_string(i));
+      config.limit.burst = 
+        setting<uint32_t>("server.limitburst" + std::to_string(i));
+      config.limit.action = static_cast<connection::limit_action_t>(
+        setting<int8_t>("server.limitaction" + std::to_string(i)));
+      config.capture = capture::is_open() &&
+        setting<bool>("server.capture" + std::to_string(i));
       auto envid = net_listener_factory_->newenv(config);
       if (NET_EID_INVALID == envid) return false;
-      listen_list_[name] = envid;
+      listen_pending_[name] = envid;
       listen_env_[name] = i;
       SLOW_DEBUGLOG(ENGINE_MODULENAME,
                     "[%s] service extra listen at: host[%s] port[%d] max[%d].",
@@ -365,16 +623,17 @@ bool Kernel::init_net() {
     }
   }
   //Extra net connectors.
-  if (GLOBALS["client.count"] > 0 || GLOBALS["client.usercount"] > 0) {
+  if (setting<int32_t>("client.count") > 0 || 
+      setting<int32_t>("client.usercount") > 0) {
     using namespace pf_net::connection::manager;
-    auto count = GLOBALS["client.count"].get<int8_t>();
+    auto count = setting<int8_t>("client.count");
     SLOW_DEBUGLOG(ENGINE_MODULENAME, 
                     "[%s] Kernel::init_net extra client count: %d", 
                     ENGINE_MODULENAME,
                     count);
     auto connector = new Connector;
     if (is_null(connector)) return false;
-    auto usercount = GLOBALS["client.usercount"].get<int8_t>();
+    auto usercount = setting<int8_t>("client.usercount");
     if (!connector->init(count + usercount + 1)) return false;
     auto reset_connect = [this](pf_net::connection::Basic *connection) {
       std::cout << "reset_connect" << std::endl;
@@ -389,8 +648,8 @@ bool Kernel::init_net() {
     if (count > 0) connector->callback_disconnect(reset_connect);
     unique_move(Connector, connector, net_connector_);
     for (int8_t i = 0; i < count; ++i) {
-      auto name = GLOBALS["client.name" + std::to_string(i)].data;
-      auto startup = GLOBALS["client.startup" + std::to_string(i)].get<bool>();
+      auto name = setting<std::string>("client.name" + std::to_string(i));
+      auto startup = setting<bool>("client.startup" + std::to_string(i));
       if ("" == name) {
         SLOW_ERRORLOG(ENGINE_MODULENAME,
                     "[%s] Kernel::init_net extra client can't get name: %d",
@@ -404,6 +663,388 @@ bool Kernel::init_net() {
       connect(name);
     }
   }
+  return init_metrics();
+}
+
+bool Kernel::init_metrics() {
+  using namespace pf_net::connection::manager;
+  auto port = setting<uint16_t>("default.net.metricsport");
+  if (0 == port) return true;
+  pf_net::metrics::set_enable(true);
+  if (is_null(net_listener_factory_)) {
+    auto factory = new ListenerFactory();
+    if (is_null(factory)) return false;
+    unique_move(ListenerFactory, factory, net_listener_factory_);
+  }
+  std::unique_ptr<pf_net::protocol::Http> http(new pf_net::protocol::Http);
+  http->set_content_type("text/plain; version=0.0.4; charset=utf-8");
+  http->set_handler([this](const std::string &path, std::string &content) {
+    if ("/trace" == path) { //The chrome trace json(default.engine.trace).
+      pf_basic::trace::dump(content);
+      return true;
+    }
+    if (path != "/metrics") return false;
+    return this->metrics_exposition(content);
+  });
+  listener_config_t config;
+  config.name = "metrics";
+  config.ip = setting<std::string>("default.net.metricsip");
+  config.port = port;
+  config.conn_max = 16;
+  auto envid = net_listener_factory_->newenv(config);
+  if (NET_EID_INVALID == envid) return false;
+  net_listener_factory_->getenv(envid)->set_protocol(http.get());
+  metrics_http_ = std::move(http);
+  listen_pending_[config.name] = envid;
+  SLOW_DEBUGLOG(ENGINE_MODULENAME,
+                "[%s] metrics listen at: host[%s] port[%d].",
+                ENGINE_MODULENAME,
+                0 == config.ip.size() ? "*" : config.ip.c_str(),
+                port);
+  return true;
+}
+
+bool Kernel::init_handoff() {
+  using namespace pf_net;
+  std::vector<connection::manager::Listener *> listeners;
+  handoff_listeners(listeners);
+  for (auto listener : listeners) {
+    auto count = listener->adopt();
+    if (0 == count) continue;
+    SLOW_LOG(ENGINE_MODULENAME,
+             "[%s] Kernel::init_handoff port[%d] adopt connections: %d",
+             ENGINE_MODULENAME,
+             listener->port(),
+             count);
+  }
+  handoff::clear(); //The sockets not used(the listener closed in config).
+  auto path = setting<std::string>("default.net.handoff");
+  if ("" == path || listeners.empty()) return true;
+  if (!handoff::listen(path)) return false;
+  schedule([this]() { handoff(); }, 100, 100);
+  return true;
+}
+
+void Kernel::handoff_listeners(
+    std::vector<pf_net::connection::manager::Listener *> &listeners) {
+  auto service = get_service("default");
+  if (!is_null(service)) listeners.push_back(service);
+  for (auto it = listen_list_.begin(); it != listen_list_.end(); ++it) {
+    auto listener = get_listener(it->first);
+    if (!is_null(listener)) listeners.push_back(listener);
+  }
+}
+
+void Kernel::replay() {
+  using namespace pf_net;
+  auto service = get_service("default");
+  if (is_null(service)) {
+    SLOW_ERRORLOG(ENGINE_MODULENAME,
+                  "[%s] Kernel::replay need the default service",
+                  ENGINE_MODULENAME);
+    stop();
+    return;
+  }
+  auto filename = GLOBALS["default.net.replay"].data;
+  auto speed = GLOBALS["default.net.replayspeed"].get<double>();
+  //The connections of pool only used in the net thread.
+  service->post([this, service, filename, speed]() {
+    capture::Replayer replayer;
+    auto result = replayer.init(filename, service) && replayer.run(speed);
+    auto &stat = replayer.stat();
+    SLOW_LOG(ENGINE_MODULENAME,
+             "[%s] Kernel::replay %s %s records: %" PRIu64 " bytes: %" PRIu64
+             " failed: %" PRIu64 " in %" PRIu64 "ms",
+             ENGINE_MODULENAME,
+             filename.c_str(),
+             result ? "ok" : "failed",
+             stat.records,
+             stat.bytes,
+             stat.failed,
+             stat.elapsed / 1000000);
+    stop();
+  });
+}
+
+void Kernel::handoff() {
+  using namespace pf_net;
+  if (stop_) return;
+  auto peer = handoff::accept();
+  if (SOCKET_INVALID == peer) return;
+  SLOW_LOG(ENGINE_MODULENAME, 
+           "[%s] Kernel::handoff the new process connected", 
+           ENGINE_MODULENAME);
+  std::vector<connection::manager::Listener *> listeners;
+  handoff_listeners(listeners);
+  auto connections = GLOBALS["default.net.handoffconn"] == true;
+  //Run in the listener tick(the connections not changed in it).
+  auto run = [](connection::manager::Listener *listener,
+                const std::function<void()> &function) {
+    auto promise = std::make_shared< std::promise<void> >();
+    auto future = promise->get_future();
+    listener->post([function, promise]() {
+      function();
+      promise->set_value();
+    });
+    return future.wait_for(std::chrono::seconds(NET_HANDOFF_TIMEOUT)) == 
+           std::future_status::ready;
+  };
+  std::vector<handoff::item_t> items;
+  std::shared_ptr< std::vector<handoff::item_t> > timeout_items;
+  size_t collected{0};
+  for (auto listener : listeners) {
+    auto _items = std::make_shared< std::vector<handoff::item_t> >();
+    ++collected;
+    if (!run(listener, [listener, connections, _items]() {
+          listener->handoff(*_items, connections);
+        })) {
+      SLOW_ERRORLOG(ENGINE_MODULENAME,
+                    "[%s] Kernel::handoff port[%d] timeout",
+                    ENGINE_MODULENAME,
+                    listener->port());
+      timeout_items = _items;
+      break;
+    }
+    items.insert(items.end(), _items->begin(), _items->end());
+  }
+  auto count = items.size();
+  auto result = is_null(timeout_items) && handoff::send(peer, items);
+  if (!is_null(timeout_items)) {
+    for (auto &item : items) socket::api::closeex(item.fd);
+  }
+  socket::api::closeex(peer);
+  //Drop the connections after the ack, or serve and accept again.
+  for (size_t i = 0; i < collected; ++i) {
+    auto listener = listeners[i];
+    auto _items = i + 1 == collected ? timeout_items : nullptr;
+    run(listener, [listener, result, _items]() {
+      if (_items) { //Collected after the timeout, not sent.
+        for (auto &item : *_items) socket::api::closeex(item.fd);
+      }
+      listener->handoff_finish(result);
+    });
+  }
+  SLOW_LOG(ENGINE_MODULENAME,
+           "[%s] Kernel::handoff send %d sockets %s",
+           ENGINE_MODULENAME,
+           static_cast<int32_t>(count),
+           result ? "ok, stop" : "failed, keep serving");
+  if (!result) return;
+  handoff::close();
+  //The pid file is the new process now, so not Application::stop.
+  stop();
+}
+
+//The prometheus summary from the histogram(ns to seconds).
+static void metrics_summary(std::string &content,
+                            const std::string &name,
+                            const std::string &labels,
+                            const pf_basic::Histogram &histogram) {
+  static const double kQuantiles[] = {0.5, 0.9, 0.99};
+  char temp[512]{0};
+  auto prefix = "" == labels ? std::string{""} : labels + ",";
+  for (auto quantile : kQuantiles) {
+    snprintf(temp, sizeof(temp) - 1, "%s{%squantile=\"%g\"} %.9f\n",
+             name.c_str(), prefix.c_str(), quantile,
+             histogram.percentile(quantile) / 1e9);
+    content += temp;
+  }
+  auto braces = "" == labels ? std::string{""} : "{" + labels + "}";
+  snprintf(temp, sizeof(temp) - 1, "%s_sum%s %.9f\n%s_count%s %" PRIu64 "\n",
+           name.c_str(), braces.c_str(), histogram.sum() / 1e9,
+           name.c_str(), braces.c_str(), histogram.count());
+  content += temp;
+}
+
+static void metrics_value(std::string &content,
+                          const std::string &name,
+                          const std::string &labels,
+                          double value) {
+  char temp[512]{0};
+  auto braces = "" == labels ? std::string{""} : "{" + labels + "}";
+  snprintf(temp, sizeof(temp) - 1, "%s%s %.17g\n", 
+           name.c_str(), braces.c_str(), value);
+  content += temp;
+}
+
+bool Kernel::metrics_exposition(std::string &content) {
+  using namespace pf_net::connection::manager;
+  content.clear();
+  content += "# TYPE pf_engine_frame_seconds summary\n";
+  metrics_summary(content, "pf_engine_frame_seconds", "", frame_time_);
+
+  //The subsystem ticks.
+  auto &stats = watchdog_.stats();
+  content += "# TYPE pf_engine_tick_seconds summary\n";
+  for (auto &stat : stats) {
+    metrics_summary(content, 
+                    "pf_engine_tick_seconds", 
+                    "subsystem=\"" + stat->name + "\"", 
+                    stat->time);
+  }
+  content += "# TYPE pf_engine_tick_overruns_total counter\n";
+  for (auto &stat : stats) {
+    metrics_value(content, 
+                  "pf_engine_tick_overruns_total", 
+                  "subsystem=\"" + stat->name + "\"", 
+                  stat->overruns.load(std::memory_order_relaxed));
+  }
+  content += "# TYPE pf_engine_tick_stalls_total counter\n";
+  for (auto &stat : stats) {
+    metrics_value(content, 
+                  "pf_engine_tick_stalls_total", 
+                  "subsystem=\"" + stat->name + "\"", 
+                  stat->stalls.load(std::memory_order_relaxed));
+  }
+  content += "# TYPE pf_engine_tick_stalled gauge\n";
+  for (auto &stat : stats) {
+    metrics_value(content, 
+                  "pf_engine_tick_stalled", 
+                  "subsystem=\"" + stat->name + "\"", 
+                  stat->stalled.load(std::memory_order_relaxed) ? 1 : 0);
+  }
+
+  //The net managers.
+  std::vector< std::pair<std::string, Basic *> > services;
+  if (!is_null(net_)) services.push_back(std::make_pair("default", net_.get()));
+  for (auto it = listen_list_.begin(); it != listen_list_.end(); ++it)
+    services.push_back(std::make_pair(it->first, get_listener(it->first)));
+  if (!is_null(net_connector_))
+    services.push_back(std::make_pair("connector", net_connector_.get()));
+  content += "# TYPE pf_net_tick_seconds summary\n";
+  for (auto &service : services) {
+    if (is_null(service.second)) continue;
+    auto labels = "service=\"" + service.first + "\"";
+    metrics_summary(content, 
+                    "pf_net_tick_seconds", 
+                    labels, 
+                    service.second->get_metrics().tick);
+  }
+  content += "# TYPE pf_net_connections gauge\n";
+  for (auto &service : services) {
+    if (is_null(service.second)) continue;
+    auto &metrics = service.second->get_metrics();
+    metrics_value(content, 
+                  "pf_net_connections", 
+                  "service=\"" + service.first + "\"", 
+                  metrics.connections.load(std::memory_order_relaxed));
+  }
+  content += "# TYPE pf_net_input_pending_bytes gauge\n";
+  for (auto &service : services) {
+    if (is_null(service.second)) continue;
+    auto &metrics = service.second->get_metrics();
+    metrics_value(content, 
+                  "pf_net_input_pending_bytes", 
+                  "service=\"" + service.first + "\"", 
+                  metrics.input_pending.load(std::memory_order_relaxed));
+  }
+  content += "# TYPE pf_net_output_pending_bytes gauge\n";
+  for (auto &service : services) {
+    if (is_null(service.second)) continue;
+    auto &metrics = service.second->get_metrics();
+    metrics_value(content, 
+                  "pf_net_output_pending_bytes", 
+                  "service=\"" + service.first + "\"", 
+                  metrics.output_pending.load(std::memory_order_relaxed));
+  }
+  content += "# TYPE pf_net_limit_total counter\n";
+  for (auto &service : services) {
+    if (is_null(service.second) || !service.second->is_service()) continue;
+    auto listener = dynamic_cast<Listener *>(service.second);
+    if (is_null(listener)) continue;
+    auto &counters = listener->limit_counters();
+    auto labels = "service=\"" + service.first + "\",action=";
+    metrics_value(content, "pf_net_limit_total", 
+                  labels + "\"pass\"", 
+                  counters.passed.load(std::memory_order_relaxed));
+    metrics_value(content, "pf_net_limit_total", 
+                  labels + "\"drop\"", 
+                  counters.dropped.load(std::memory_order_relaxed));
+    metrics_value(content, "pf_net_limit_total", 
+                  labels + "\"delay\"", 
+                  counters.delayed.load(std::memory_order_relaxed));
+    metrics_value(content, "pf_net_limit_total", 
+                  labels + "\"disconnect\"", 
+                  counters.disconnected.load(std::memory_order_relaxed));
+  }
+
+  //The packets.
+  std::vector<pf_net::metrics::packet_snapshot_t> snapshots;
+  pf_net::metrics::packet_snapshot(snapshots);
+  content += "# TYPE pf_net_packets_total counter\n";
+  for (auto &snapshot : snapshots) {
+    metrics_value(content, 
+                  "pf_net_packets_total", 
+                  "id=\"" + std::to_string(snapshot.id) + "\"", 
+                  snapshot.count);
+  }
+  content += "# TYPE pf_net_packet_bytes_total counter\n";
+  for (auto &snapshot : snapshots) {
+    metrics_value(content, 
+                  "pf_net_packet_bytes_total", 
+                  "id=\"" + std::to_string(snapshot.id) + "\"", 
+                  snapshot.bytes);
+  }
+  content += "# TYPE pf_net_packet_decode_seconds summary\n";
+  for (auto &snapshot : snapshots) {
+    metrics_summary(content, 
+                    "pf_net_packet_decode_seconds", 
+                    "id=\"" + std::to_string(snapshot.id) + "\"", 
+                    *snapshot.decode);
+  }
+  content += "# TYPE pf_net_packet_execute_seconds summary\n";
+  for (auto &snapshot : snapshots) {
+    metrics_summary(content, 
+                    "pf_net_packet_execute_seconds", 
+                    "id=\"" + std::to_string(snapshot.id) + "\"", 
+                    *snapshot.execute);
+  }
+  content += "# TYPE pf_net_flush_stalls_total counter\n";
+  metrics_value(content, 
+                "pf_net_flush_stalls_total", 
+                "", 
+                pf_net::metrics::flush_stalls());
+
+  //The cache.
+  auto repository = is_null(cache_) ? nullptr : cache_->get_db_dirver();
+  if (!is_null(repository)) {
+    content += "# TYPE pf_cache_requests_total counter\n";
+    metrics_value(content, 
+                  "pf_cache_requests_total", 
+                  "result=\"hit\"", 
+                  repository->hits());
+    metrics_value(content, 
+                  "pf_cache_requests_total", 
+                  "result=\"miss\"", 
+                  repository->misses());
+  }
+
+  //The logger.
+  if (!is_null(LOGSYSTEM_POINTER)) {
+    content += "# TYPE pf_log_backlog_bytes gauge\n";
+    metrics_value(content, 
+                  "pf_log_backlog_bytes", 
+                  "", 
+                  LOGSYSTEM_POINTER->backlog());
+    content += "# TYPE pf_log_dropped_total counter\n";
+    metrics_value(content, 
+                  "pf_log_dropped_total", 
+                  "", 
+                  LOGSYSTEM_POINTER->dropped());
+  }
+
+  //The process.
+  auto pid = pf_sys::process::getid();
+  content += "# TYPE process_cpu_seconds_total counter\n";
+  metrics_value(content, 
+                "process_cpu_seconds_total", 
+                "", 
+                pf_sys::process::get_cpu_time(pid) / 1000.0);
+  content += "# TYPE process_resident_memory_bytes gauge\n";
+  metrics_value(content, 
+                "process_resident_memory_bytes", 
+                "", 
+                pf_sys::process::get_physicalmemory_usage(pid));
   return true;
 }
 
@@ -413,22 +1054,24 @@ bool Kernel::init_db() {
   SLOW_DEBUGLOG(ENGINE_MODULENAME, 
                 "[%s] Kernel::init_db start...", 
                 ENGINE_MODULENAME);
-  if (GLOBALS["default.db.open"] == true || GLOBALS["database.count"] > 0) {
+  if (setting<bool>("default.db.open") || 
+      setting<int32_t>("database.count") > 0) {
     auto factory = new Factory();
     if (is_null(factory)) return false;
     unique_move(Factory, factory, db_factory_);
   }
-  if (GLOBALS["default.db.open"] == true) {
+  if (setting<bool>("default.db.open")) {
     config_t conf;
-    conf.type = GLOBALS["default.db.type"].get<int8_t>();
-    conf.name = GLOBALS["default.db.name"].c_str();
-    conf.username = GLOBALS["default.db.user"].c_str();
-    if (GLOBALS["default.db.encrypt"] == true) {
+    conf.type = setting<int8_t>("default.db.type");
+    conf.name = setting<std::string>("default.db.name");
+    conf.username = setting<std::string>("default.db.user");
+    if (setting<bool>("default.db.encrypt")) {
       std::string password{""};
-      pf_basic::string::decrypt(GLOBALS["default.db.password"].data, password);
+      pf_basic::string::decrypt(
+          setting<std::string>("default.db.password"), password);
       conf.password = password;
     } else {
-      conf.password = GLOBALS["default.db.password"].c_str();
+      conf.password = setting<std::string>("default.db.password");
     }
     db_eid_ = db_factory_->newenv(conf);
     if (DB_EID_INVALID == db_eid_) return false;
@@ -437,26 +1080,28 @@ bool Kernel::init_db() {
   }
   
   //Extra.
-  if (GLOBALS["database.count"] > 0) {
-    auto count = GLOBALS["database.count"].get<int8_t>();
+  if (setting<int32_t>("database.count") > 0) {
+    auto count = setting<int8_t>("database.count");
     SLOW_DEBUGLOG(ENGINE_MODULENAME, 
                   "[%s] Kernel::init_db the extra count: %d", 
                   ENGINE_MODULENAME,
                   count);
     for (int8_t i = 0; i < count; ++i) {
       config_t conf;
-      auto name = GLOBALS["database.name" + std::to_string(i)];
-      conf.type = GLOBALS["database.type" + std::to_string(i)].get<int8_t>();
-      conf.name = GLOBALS["database.dbname" + std::to_string(i)].c_str();
-      conf.username = GLOBALS["database.dbuser" + std::to_string(i)].c_str();
-      if (GLOBALS["database.encrypt" + std::to_string(i)] == true) {
+      auto name = setting<std::string>("database.name" + std::to_string(i));
+      conf.type = setting<int8_t>("database.type" + std::to_string(i));
+      conf.name = setting<std::string>("database.dbname" + std::to_string(i));
+      conf.username = 
+        setting<std::string>("database.dbuser" + std::to_string(i));
+      if (setting<bool>("database.encrypt" + std::to_string(i))) {
         std::string password{""};
         pf_basic::string::decrypt(
-            GLOBALS["database.dbpassword" + std::to_string(i)].data, password);
+            setting<std::string>("database.dbpassword" + std::to_string(i)), 
+            password);
         conf.password = password;
       } else {
         conf.password = 
-          GLOBALS["database.dbpassword" + std::to_string(i)].c_str();
+          setting<std::string>("database.dbpassword" + std::to_string(i));
       }
       auto eid = db_factory_->newenv(conf);
       if (DB_EID_INVALID == eid) return false;
@@ -470,7 +1115,7 @@ bool Kernel::init_db() {
 
 bool Kernel::init_cache() {
   using namespace pf_cache;
-  if (GLOBALS["default.cache.open"] == false) return true;
+  if (!setting<bool>("default.cache.open")) return true;
   SLOW_DEBUGLOG(ENGINE_MODULENAME, 
                 "[%s] Kernel::init_cache start...", 
                 ENGINE_MODULENAME);
@@ -480,12 +1125,14 @@ bool Kernel::init_cache() {
   auto dirver = cache->create_db_dirver();
   if (is_null(dirver)) return false;
   auto store = dynamic_cast< DBStore *>(dirver->store());
-  auto key_map = GLOBALS["default.cache.key_map"].get<int32_t>();
-  auto recycle_map = GLOBALS["default.cache.recycle_map"].get<int32_t>();
-  auto query_map = GLOBALS["default.cache.query_map"].get<int32_t>();
+  auto key_map = setting<int32_t>("default.cache.key_map");
+  auto recycle_map = setting<int32_t>("default.cache.recycle_map");
+  auto query_map = setting<int32_t>("default.cache.query_map");
   store->set_key(key_map, recycle_map, query_map);
-  store->set_service(GLOBALS["default.cache.service"].get<bool>());
-  if (!store->load_config(GLOBALS["default.cache.conf"].c_str())) return false;
+  store->set_service(setting<bool>("default.cache.service"));
+  if (executor_) store->set_executor(executor_.get());
+  if (!store->load_config(setting<std::string>("default.cache.conf").c_str()))
+    return false;
   if (!store->init()) return false;
   return true;
 }
@@ -551,52 +1198,51 @@ const std::string Kernel::get_script_function(
 }
 
 void Kernel::loop() {
-  using namespace pf_basic::rang;
-  using namespace pf_basic::rlutil;
-  uint32_t last_reconnect{0};
-  uint32_t last_fps{0};
-  for (;;) {
-    auto curtime = TIME_MANAGER_POINTER->get_ctime();
-    if (GLOBALS["app.status"] == kAppStatusStop) break;
-    auto starttime = TIME_MANAGER_POINTER->get_tickcount();
-    std::function<void()> task;
-    {
-      if (!tasks_.empty()) {
-        task = std::move(this->tasks_.front());
-        this->tasks_.pop();
+  //Drain the ready tasks(not more than the budget) and the expired schedules
+  //each wakeup, then wait the enqueue or the next deadline.
+  auto budget = GLOBALS["default.engine.taskbudget"].get<uint32_t>();
+  if (0 == budget) budget = UINT32_MAX;
+  auto reconnect_time = GLOBALS["default.net.reconnect_time"].get<uint32_t>();
+  if (reconnect_time > 0)
+    schedule([this]() { reconnect(); }, 0, reconnect_time * 1000);
+  //The awaitable created in main loop resume in it.
+  pf_sys::ResumerGuard guard([this](const std::function<void()> &function) {
+    schedule(function, 0);
+  });
+  //The loop only wakeup for the work, so the fps is the ticks of the slowest
+  //subsystem, or the drained tasks if not any tick.
+  uint32_t tasks{0};
+  std::vector<uint64_t> ticks;
+  if (GLOBALS["default.engine.fps"] == true) {
+    schedule([this, &tasks, &ticks]() {
+      auto &stats = watchdog_.stats();
+      ticks.resize(stats.size(), 0);
+      uint64_t fps{tasks};
+      for (size_t i = 0; i < stats.size(); ++i) {
+        auto count = stats[i]->time.count();
+        if (0 == i || count - ticks[i] < fps) fps = count - ticks[i];
+        ticks[i] = count;
       }
-    }
-    if (task) task();
-    auto reconnect_time = GLOBALS["default.net.reconnect_time"].get<uint32_t>();
-    if (reconnect_time > 0 && curtime - last_reconnect > reconnect_time) {
-      last_reconnect = curtime;
-      //Reconnect the connected.
-      for (auto it = connect_list_.begin(); it != connect_list_.end(); ++it) {
-        if (-1 == it->second) connect(it->first);
-      }
-    }
-    worksleep(starttime);
-    if (GLOBALS["default.engine.fps"] == true && curtime - last_fps >= 1) {
-      const CursorHider hider;
-      auto curr_t = TIME_MANAGER_POINTER->get_tickcount();
-      auto interval = curr_t - starttime;
-      int32_t fps{-1};
-      if (interval != 0) fps = 1000 / interval;
-      char fps_str[16]{0};
-      snprintf(fps_str, sizeof(fps_str) - 1, "FPS: %3d", fps);
-      if (fps >= 60) {
-        std::cout << fgB::green; 
-      } else if (fps >= 30 && fps < 60) {
-        std::cout << fgB::yellow; 
-      } else if (fps >= 0 && fps < 30) {
-        std::cout << fgB::red; 
-      }
-      setString(fps_str);
-      std::cout.flush();
-      std::cout << fg::reset;
-      last_fps = curtime;
-    }
+      show_fps(static_cast<uint32_t>(fps));
+      tasks = 0;
+    }, 1000, 1000);
   }
+  static const pf_basic::config::handle<int32_t> status{"app.status"};
+  for (;;) {
+    if (stop_ || kAppStatusStop == status.get()) break;
+    TIME_MANAGER_POINTER->tick();
+    auto frame_start = pf_net::metrics::now();
+    auto count = run_tasks(budget);
+    auto deadline = run_schedules();
+    tasks += count;
+    if (pf_net::metrics::enable())
+      frame_time_.record(pf_net::metrics::now() - frame_start);
+    if (count >= budget) continue; //Have more tasks.
+    event_.wait(deadline);
+  }
+  shutdown();
+  GLOBALS["app.status"] = kAppStatusStop;
+  pf_basic::config::commit();
   auto check_starttime = TIME_MANAGER_POINTER->get_tickcount();
   for (;;) {
     auto diff_time = TIME_MANAGER_POINTER->get_tickcount() - check_starttime;
@@ -609,3 +1255,67 @@ void Kernel::loop() {
   }
   SLOW_LOG(ENGINE_MODULENAME, "[%s] exited normally", GLOBALS["app.name"].c_str());
 }
+
+uint32_t Kernel::run_tasks(uint32_t budget) {
+  std::vector< std::function<void()> > tasks;
+  {
+    std::unique_lock<std::mutex> autolock(queue_mutex_);
+    while (!tasks_.empty() && tasks.size() < budget) {
+      tasks.emplace_back(std::move(tasks_.front()));
+      tasks_.pop();
+    }
+  }
+  for (auto &task : tasks) {
+    TRACE_SCOPE("engine", "task");
+    task();
+  }
+  return static_cast<uint32_t>(tasks.size());
+}
+
+uint64_t Kernel::run_schedules() {
+  auto now = pf_net::metrics::now();
+  for (;;) {
+    schedule_t item;
+    {
+      std::unique_lock<std::mutex> autolock(queue_mutex_);
+      if (schedules_.empty()) return 0;
+      if (schedules_.top().deadline > now) return schedules_.top().deadline;
+      item = schedules_.top();
+      schedules_.pop();
+    }
+    {
+      TRACE_SCOPE("engine", "schedule");
+      item.function();
+    }
+    if (0 == item.interval) continue;
+    item.deadline += item.interval;
+    if (item.deadline <= now) item.deadline = now + item.interval; //Missed.
+    std::unique_lock<std::mutex> autolock(queue_mutex_);
+    schedules_.push(std::move(item));
+  }
+}
+
+void Kernel::reconnect() {
+  for (auto it = connect_list_.begin(); it != connect_list_.end(); ++it) {
+    if (-1 == it->second) connect(it->first);
+  }
+}
+
+void Kernel::show_fps(uint32_t count) {
+  using namespace pf_basic::rang;
+  using namespace pf_basic::rlutil;
+  //The ticks(or tasks) in the last second.
+  const CursorHider hider;
+  char fps_str[16]{0};
+  snprintf(fps_str, sizeof(fps_str) - 1, "FPS: %3u", count);
+  if (count >= 60) {
+    std::cout << fgB::green; 
+  } else if (count >= 30) {
+    std::cout << fgB::yellow; 
+  } else {
+    std::cout << fgB::red; 
+  }
+  setString(fps_str);
+  std::cout.flush();
+  std::cout << fg::reset;
+}
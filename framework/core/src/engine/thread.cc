@@ -4,6 +4,7 @@
 #include "pf/cache/repository.h"
 #include "pf/cache/db_store.h"
 #include "pf/cache/manager.h"
+#include "pf/basic/trace.h"
 #include "pf/sys/thread.h"
 #include "pf/engine/thread.h"
 
@@ -39,15 +40,34 @@ bool for_cache(pf_cache::Manager *cache) {
 bool for_script(pf_script::Interface *env) {
   using namespace pf_script;
   if (is_null(env)) return false;
-  env->task_queue()->work_one();
-  if (GLOBALS["default.script.heartbeat"] != "") 
-    env->call(GLOBALS["default.script.heartbeat"].data);
-  auto time = 
-    static_cast<int32_t>(1000 / GLOBALS["default.engine.frame"].get<int32_t>());
+  static const pf_basic::config::handle<std::string> 
+    heartbeat{"default.script.heartbeat"};
+  static const pf_basic::config::handle<int32_t> frame{"default.engine.frame"};
+  static const pf_basic::config::handle<uint32_t> 
+    budget{"default.script.taskbudget"};
+  std::unique_lock<std::mutex> lock(env->mutex());
+  env->task_queue()->drain(budget.get());
+  auto function = heartbeat.get();
+  if (function != "") {
+    TRACE_SCOPE("script", "heartbeat");
+    env->call(function);
+  }
+  auto time = static_cast<int32_t>(1000 / frame.get());
   env->gccheck(time);
   return true;
 }
 
+bool for_script_tasks(pf_script::Interface *env) {
+  if (is_null(env)) return false;
+  static const pf_basic::config::handle<uint32_t> 
+    budget{"default.script.taskbudget"};
+  //The tick running, the task run in it or the next tick.
+  std::unique_lock<std::mutex> lock(env->mutex(), std::try_to_lock);
+  if (!lock.owns_lock()) return true;
+  env->task_queue()->drain(budget.get());
+  return true;
+}
+
 } //namespace thread
 
 } //namespace pf_engine
@@ -0,0 +1,131 @@
+#include "pf/basic/logger.h"
+#include "pf/basic/trace.h"
+#include "pf/sys/thread.h"
+#include "pf/engine/watchdog.h"
+
+namespace pf_engine {
+
+void tick_stat_struct::on_begin() {
+  auto now = pf_basic::trace::now();
+  begin.store(now, std::memory_order_relaxed);
+  heartbeat.store(now, std::memory_order_relaxed);
+  trace_tid.store(pf_basic::trace::thread_id(), std::memory_order_relaxed);
+#if OS_UNIX
+  handle.store(pthread_self(), std::memory_order_relaxed);
+#endif
+}
+
+void tick_stat_struct::on_end(uint64_t budget) {
+  auto now = pf_basic::trace::now();
+  auto duration = now - begin.load(std::memory_order_relaxed);
+  time.record(duration);
+  if (budget > 0 && duration > budget)
+    overruns.store(overruns.load(std::memory_order_relaxed) + 1,
+                   std::memory_order_relaxed);
+  begin.store(0, std::memory_order_relaxed);
+  heartbeat.store(now, std::memory_order_relaxed);
+}
+
+Watchdog::Watchdog() : budget_{0}, frames_{0}, stop_{false} {
+
+}
+
+Watchdog::~Watchdog() {
+  stop();
+}
+
+tick_stat_t *Watchdog::add(const std::string &name) {
+  std::unique_ptr<tick_stat_t> pointer(new tick_stat_t(name));
+  auto stat = pointer.get();
+  stats_.emplace_back(std::move(pointer));
+  return stat;
+}
+
+void Watchdog::start(uint32_t frames, uint64_t budget) {
+  budget_ = budget;
+  frames_ = frames;
+  if (0 == frames_ || 0 == budget_ || thread_.joinable()) return;
+  stop_ = false;
+  thread_ = std::thread([this]() {
+#if OS_UNIX
+    //The app signals(stop in the handler) not to this thread.
+    sigset_t set;
+    sigfillset(&set);
+    pthread_sigmask(SIG_BLOCK, &set, nullptr);
+#endif
+    pf_sys::thread::bind("watchdog");
+    auto period = std::chrono::nanoseconds(budget_);
+    std::unique_lock<std::mutex> autolock(mutex_);
+    while (!stop_) {
+      condition_.wait_for(autolock, period);
+      if (stop_) break;
+      auto now = pf_basic::trace::now();
+      for (auto &stat : stats_) check(stat.get(), now);
+    }
+  });
+}
+
+void Watchdog::stop() {
+  {
+    std::unique_lock<std::mutex> autolock(mutex_);
+    stop_ = true;
+  }
+  condition_.notify_all();
+  if (thread_.joinable()) thread_.join();
+}
+
+void Watchdog::check(tick_stat_t *stat, uint64_t now) {
+  auto heartbeat = stat->heartbeat.load(std::memory_order_relaxed);
+  if (0 == heartbeat || now < heartbeat) return; //Not ticked.
+  auto elapsed = now - heartbeat;
+  if (elapsed > budget_ * frames_) {
+    if (stat->stalled.exchange(true)) return; //Reported.
+    ++stat->stalls;
+    report(stat, elapsed);
+  } else if (stat->stalled.exchange(false)) {
+    SLOW_WARNINGLOG(ENGINE_MODULENAME,
+                    "[%s] watchdog %s recovered",
+                    ENGINE_MODULENAME,
+                    stat->name.c_str());
+  }
+}
+
+void Watchdog::report(tick_stat_t *stat, uint64_t elapsed) {
+  auto ticking = stat->begin.load(std::memory_order_relaxed) != 0;
+  auto span =
+    pf_basic::trace::current_span(stat->trace_tid.load(std::memory_order_relaxed));
+  SLOW_ERRORLOG(ENGINE_MODULENAME,
+                "[%s] watchdog %s no heartbeat for %dms(%d frames), %s,"
+                " span: %s",
+                ENGINE_MODULENAME,
+                stat->name.c_str(),
+                static_cast<int32_t>(elapsed / 1000000),
+                frames_,
+                ticking ? "stuck in tick" : "not ticked",
+                "" == span ? "none(default.engine.trace)" : span.c_str());
+  if (!ticking) return;
+#if OS_UNIX
+  //The stack of the ticking thread to the watchdog log.
+  char filename[FILENAME_MAX]{0};
+  pf_basic::Logger::get_log_filename("watchdog", filename);
+  auto fp = fopen(filename, "ab");
+  if (is_null(fp)) return;
+  char time_str[256]{0};
+  pf_basic::Logger::get_log_timestr(time_str, sizeof(time_str) - 1);
+  fprintf(fp,
+          "%s [%s] %s stuck %dms, span: %s, stack:" LF,
+          time_str,
+          ENGINE_MODULENAME,
+          stat->name.c_str(),
+          static_cast<int32_t>(elapsed / 1000000),
+          span.c_str());
+  fflush(fp);
+  if (!pf_sys::thread::dump_stack(
+        stat->handle.load(std::memory_order_relaxed), fileno(fp))) {
+    fprintf(fp, "dump stack failed" LF);
+  }
+  fclose(fp);
+#endif
+}
+
+} //namespace pf_engine
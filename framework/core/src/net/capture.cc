@@ -0,0 +1,279 @@
+#include "pf/net/stream/input.h"
+#include "pf/net/connection/basic.h"
+#include "pf/net/connection/manager/listener.h"
+#include "pf/net/metrics.h"
+#include "pf/basic/logger.h"
+#include "pf/net/capture.h"
+
+namespace pf_net {
+
+namespace capture {
+
+namespace {
+
+struct buffer_struct {
+  std::mutex mutex; //Only flush(other thread) will compete with the owner.
+  std::string data;
+};
+
+using buffer_t = buffer_struct;
+
+std::mutex g_mutex; //The file and buffer list.
+FILE *g_fp{nullptr};
+std::atomic<bool> g_open{false};
+uint64_t g_start{0};
+std::list< std::unique_ptr<buffer_t> > g_buffers;
+thread_local buffer_t *t_buffer{nullptr};
+
+buffer_t *thread_buffer() {
+  if (t_buffer) return t_buffer;
+  std::unique_ptr<buffer_t> pointer(new buffer_t);
+  pointer->data.reserve(NET_CAPTURE_BUFFER_SIZE * 2);
+  t_buffer = pointer.get();
+  std::unique_lock<std::mutex> autolock(g_mutex);
+  g_buffers.push_back(std::move(pointer));
+  return t_buffer;
+}
+
+//Need lock the buffer mutex before call this.
+void write_buffer(buffer_t *buffer) {
+  if (buffer->data.empty()) return;
+  {
+    std::unique_lock<std::mutex> autolock(g_mutex);
+    if (g_fp) fwrite(buffer->data.data(), 1, buffer->data.size(), g_fp);
+  }
+  buffer->data.clear();
+}
+
+template <typename T>
+char *put(char *pointer, T value) {
+  memcpy(pointer, &value, sizeof(value));
+  return pointer + sizeof(value);
+}
+
+template <typename T>
+const char *get(const char *pointer, T &value) {
+  memcpy(&value, pointer, sizeof(value));
+  return pointer + sizeof(value);
+}
+
+} //namespace
+
+bool open(const std::string &filename) {
+  close();
+  std::unique_lock<std::mutex> autolock(g_mutex);
+  g_fp = fopen(filename.c_str(), "wb");
+  if (is_null(g_fp)) {
+    SLOW_ERRORLOG(NET_MODULENAME,
+                  "[net.capture] open(%s) failed",
+                  filename.c_str());
+    return false;
+  }
+  char header[NET_CAPTURE_HEADER_SIZE]{0};
+  auto pointer = put(header, static_cast<uint32_t>(NET_CAPTURE_MAGIC));
+  put(pointer, static_cast<uint16_t>(NET_CAPTURE_VERSION));
+  fwrite(header, 1, sizeof(header), g_fp);
+  g_start = metrics::now();
+  g_open = true;
+  return true;
+}
+
+void close() {
+  if (!is_open()) return;
+  flush();
+  std::unique_lock<std::mutex> autolock(g_mutex);
+  g_open = false;
+  if (g_fp) fclose(g_fp);
+  g_fp = nullptr;
+}
+
+bool is_open() {
+  return g_open.load(std::memory_order_relaxed);
+}
+
+void flush() {
+  std::vector<buffer_t *> buffers;
+  {
+    std::unique_lock<std::mutex> autolock(g_mutex);
+    for (auto &buffer : g_buffers) buffers.push_back(buffer.get());
+  }
+  for (auto buffer : buffers) {
+    std::unique_lock<std::mutex> autolock(buffer->mutex);
+    write_buffer(buffer);
+  }
+  std::unique_lock<std::mutex> autolock(g_mutex);
+  if (g_fp) fflush(g_fp);
+}
+
+bool record(connection::Basic *connection,
+            stream::Input &istream,
+            uint32_t size) {
+  if (!is_open() || is_null(connection)) return false;
+  auto buffer = thread_buffer();
+  using namespace pf_net::connection::manager;
+  uint8_t flags = connection->protocol() == Interface::protocol_compact() ?
+                  kFlagCompact : kFlagNone;
+  uint64_t time = metrics::now() - g_start;
+  std::unique_lock<std::mutex> autolock(buffer->mutex);
+  auto offset = buffer->data.size();
+  buffer->data.resize(offset + NET_CAPTURE_RECORD_HEADER_SIZE + size);
+  char *pointer = &buffer->data[offset];
+  pointer = put(pointer, time);
+  pointer = put(pointer, static_cast<uint16_t>(connection->get_managerid()));
+  pointer = put(pointer, connection->get_id());
+  pointer = put(pointer, flags);
+  pointer = put(pointer, static_cast<uint8_t>(0));
+  pointer = put(pointer, size);
+  if (!istream.peek(pointer, size)) {
+    buffer->data.resize(offset);
+    return false;
+  }
+  if (buffer->data.size() >= NET_CAPTURE_BUFFER_SIZE) write_buffer(buffer);
+  return true;
+}
+
+bool Reader::open(const std::string &filename) {
+  close();
+  fp_ = fopen(filename.c_str(), "rb");
+  if (is_null(fp_)) return false;
+  char header[NET_CAPTURE_HEADER_SIZE]{0};
+  uint32_t magic{0};
+  uint16_t version{0};
+  if (fread(header, 1, sizeof(header), fp_) != sizeof(header)) {
+    close();
+    return false;
+  }
+  get(get(header, magic), version);
+  if (magic != NET_CAPTURE_MAGIC || version != NET_CAPTURE_VERSION) {
+    SLOW_ERRORLOG(NET_MODULENAME,
+                  "[net.capture] Reader::open(%s) invalid file: %x|%d",
+                  filename.c_str(),
+                  magic,
+                  version);
+    close();
+    return false;
+  }
+  return true;
+}
+
+void Reader::close() {
+  if (fp_) fclose(fp_);
+  fp_ = nullptr;
+}
+
+bool Reader::next(record_t &record) {
+  if (is_null(fp_)) return false;
+  char header[NET_CAPTURE_RECORD_HEADER_SIZE]{0};
+  if (fread(header, 1, sizeof(header), fp_) != sizeof(header)) return false;
+  uint8_t reserved{0};
+  uint32_t size{0};
+  const char *pointer = header;
+  pointer = get(pointer, record.time);
+  pointer = get(pointer, record.managerid);
+  pointer = get(pointer, record.id);
+  pointer = get(pointer, record.flags);
+  pointer = get(pointer, reserved);
+  get(pointer, size);
+  record.data.resize(size);
+  if (size > 0 && fread(&record.data[0], 1, size, fp_) != size) return false;
+  return true;
+}
+
+bool Replayer::init(const std::string &filename,
+                    connection::manager::Interface *manager) {
+  if (is_null(manager) || !manager->is_ready()) return false;
+  clear();
+  filename_ = filename;
+  manager_ = manager;
+  stat_ = replay_stat_t();
+  return true;
+}
+
+bool Replayer::run(double speed) {
+  using namespace pf_net::connection::manager;
+  if (is_null(manager_)) return false;
+  Reader reader;
+  if (!reader.open(filename_)) return false;
+  record_t record;
+  uint64_t first{0};
+  bool started{false};
+  auto begin = metrics::now();
+  while (reader.next(record)) {
+    if (!started) {
+      first = record.time;
+      started = true;
+    }
+    if (speed > 0) {
+      auto target = static_cast<uint64_t>((record.time - first) / speed);
+      auto elapsed = metrics::now() - begin;
+      if (target > elapsed) {
+        std::this_thread::sleep_for(
+            std::chrono::nanoseconds(target - elapsed));
+      }
+    }
+    ++stat_.records;
+    stat_.bytes += record.data.size();
+    auto connection = get(record);
+    if (is_null(connection)) {
+      ++stat_.failed;
+      continue;
+    }
+    auto size = static_cast<uint32_t>(record.data.size());
+    if (kFlagCompact == (record.flags & kFlagCompact))
+      connection->set_protocol(Interface::protocol_compact());
+    bool result =
+      connection->istream().write(record.data.data(), size) == size &&
+      connection->protocol()->command(connection, 1);
+    //Without socket, so drop the responses.
+    connection->ostream().clear();
+    if (!result) {
+      ++stat_.failed;
+      release((static_cast<uint32_t>(record.managerid) << 16) |
+              static_cast<uint16_t>(record.id));
+    }
+  }
+  stat_.elapsed = metrics::now() - begin;
+  clear();
+  return true;
+}
+
+connection::Basic *Replayer::get(const record_t &record) {
+  using namespace pf_net::connection::manager;
+  uint32_t key = (static_cast<uint32_t>(record.managerid) << 16) |
+                 static_cast<uint16_t>(record.id);
+  auto it = connections_.find(key);
+  if (it != connections_.end()) return it->second;
+  auto pool = manager_->get_pool();
+  if (is_null(pool)) return nullptr;
+  auto connection = pool->create();
+  if (is_null(connection)) return nullptr;
+  if (!connection->init(manager_->protocol())) {
+    pool->remove(connection->get_id());
+    return nullptr;
+  }
+  //Not attached to the manager(without socket), so keep the invalid manager
+  //id, the listener's options and limit rules applied as a new connection.
+  connection->clear();
+  connection->set_disconnect(false);
+  connection->set_empty(false);
+  manager_->on_connect(connection);
+  connection->set_capture(false);
+  connections_[key] = connection;
+  return connection;
+}
+
+void Replayer::release(uint32_t key) {
+  auto it = connections_.find(key);
+  if (it == connections_.end()) return;
+  if (manager_ && manager_->get_pool())
+    manager_->get_pool()->remove(it->second->get_id());
+  connections_.erase(it);
+}
+
+void Replayer::clear() {
+  while (!connections_.empty()) release(connections_.begin()->first);
+}
+
+} //namespace capture
+
+} //namespace pf_net
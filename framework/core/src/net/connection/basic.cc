@@ -9,6 +9,7 @@
 #include "pf/engine/kernel.h"
 #include "pf/script/interface.h"
 #include "pf/net/connection/manager/listener.h"
+#include "pf/net/metrics.h"
 #include "pf/net/connection/basic.h"
 
 namespace pf_net {
@@ -32,13 +33,18 @@ Basic::Basic() :
   compress_buffer_{nullptr},
   receive_bytes_{0},
   send_bytes_{0},
+  send_policy_{kSendPolicyTick},
+  flush_stalls_{0},
+  capture_{false},
+  corked_{false},
+  cork_bulk_{false},
   packet_index_{0},
   execute_count_pretick_{NET_CONNECTION_EXECUTE_COUNT_PRE_TICK_DEFAULT},
   status_{0},
   safe_encrypt_{false},
   safe_encrypt_time_{0},
   name_{""} {
-  //do nothing
+  lane_clear();
 }
 
 Basic::~Basic() {
@@ -120,8 +126,25 @@ void Basic::process_input_compress() {
 }
 
 bool Basic::process_output() {
-  bool result = false;
   if (is_disconnect()) return true;
+  std::unique_lock<std::mutex> autolock(mutex_);
+  return flush_output();
+}
+
+bool Basic::flush() {
+  std::unique_lock<std::mutex> autolock(mutex_);
+  if (is_disconnect()) return false;
+  return flush_output(true);
+}
+
+bool Basic::flush_output(bool push) {
+  bool result = false;
+  lane_schedule();
+  if (0 == ostream_->size() && !corked_) return true;
+  //塞子跨帧保持，显式flush或大量数据（多次才能发完）发送完时才打开，剩余不满
+  //一包的数据此时才发出
+  bool cork = kSendPolicyCork == send_policy_;
+  if (cork && !corked_) corked_ = socket_->set_cork(true);
   try {
     int32_t flushresult = ostream_->flush();
     if (flushresult <= SOCKET_ERROR) {
@@ -138,13 +161,80 @@ bool Basic::process_output() {
     } else {
       result = true;
       send_bytes_ += static_cast<uint32_t>(flushresult);
+      if (ostream_->size() > 0) {
+        cork_bulk_ = corked_;
+        ++flush_stalls_;
+        if (metrics::enable()) metrics::flush_stall();
+      }
     }
   } catch(...) {
     SaveErrorLog();
   }
+  if (corked_ && (push || !cork || (cork_bulk_ && 0 == output_pending()))) {
+    socket_->set_cork(false);
+    corked_ = false;
+    cork_bulk_ = false;
+  }
+  return result;
+}
+
+stream::Output &Basic::lane_ostream(uint8_t lane) {
+  if (0 == lane || lane >= NET_CONNECTION_LANE_MAX) return *ostream_.get();
+  if (!lanes_[lane]) {
+    std::unique_ptr<stream::Output> pointer(
+        new stream::Output(socket_.get(), 
+                           NETOUTPUT_BUFFERSIZE_DEFAULT, 
+                           NET_CONNECTION_LANE_SIZEMAX));
+    lanes_[lane] = std::move(pointer);
+    lanes_[lane]->init();
+    lanes_[lane]->set_compact(ostream_->compact());
+  }
+  return *lanes_[lane].get();
+}
+
+//按权重轮流（deficit round robin）把通道中的完整消息移入输出流，只在输出流
+//快要发送完时补充，使通道0的消息不会排在大量低优先级数据之后
+void Basic::lane_schedule() {
+  bool pending = true;
+  while (pending && ostream_->size() < NET_CONNECTION_LANE_FLUSH_BUDGET) {
+    pending = false;
+    for (uint8_t i = 1; i < NET_CONNECTION_LANE_MAX; ++i) {
+      auto &packets = lane_packets_[i];
+      if (packets.empty()) {
+        lane_deficits_[i] = 0;
+        continue;
+      }
+      lane_deficits_[i] += lane_weights_[i] * NET_CONNECTION_LANE_QUANTUM;
+      while (!packets.empty() && 
+             packets.front() <= lane_deficits_[i] &&
+             ostream_->size() < NET_CONNECTION_LANE_FLUSH_BUDGET) {
+        auto size = packets.front();
+        if (lanes_[i]->transfer(*ostream_.get(), size) != size) return;
+        lane_deficits_[i] -= size;
+        packets.pop_front();
+      }
+      if (!packets.empty()) pending = true;
+    }
+  }
+}
+
+uint32_t Basic::output_pending() const {
+  uint32_t result = ostream_ ? static_cast<uint32_t>(ostream_->size()) : 0;
+  for (uint8_t i = 1; i < NET_CONNECTION_LANE_MAX; ++i) {
+    if (lanes_[i]) result += static_cast<uint32_t>(lanes_[i]->size());
+  }
   return result;
 }
 
+void Basic::lane_clear() {
+  for (uint8_t i = 0; i < NET_CONNECTION_LANE_MAX; ++i) {
+    if (lanes_[i]) lanes_[i]->clear();
+    lane_packets_[i].clear();
+    lane_deficits_[i] = 0;
+    lane_weights_[i] = static_cast<uint8_t>(NET_CONNECTION_LANE_MAX - i);
+  }
+}
+
 bool Basic::process_command() {
   if (is_null(protocol_)) return false;
   return protocol_->command(this, execute_count_pretick_);
@@ -154,10 +244,13 @@ bool Basic::send(packet::Interface *packet) {
   std::unique_lock<std::mutex> autolock(mutex_);
   if (is_disconnect()) return false;
   if (is_null(protocol_)) return false;
-  return protocol_->send(this, packet);
+  if (!protocol_->send(this, packet)) return false;
+  //The flush error will be found by process_output in the next tick.
+  if (kSendPolicyImmediate == send_policy_) flush_output();
+  return true;
 }
 
-bool Basic::heartbeat(uint32_t, uint32_t) {
+bool Basic::heartbeat(uint64_t, uint32_t) {
   using namespace pf_basic;
   auto now = TIME_MANAGER_POINTER->get_ctime();
   if (is_disconnect()) return false;
@@ -170,11 +263,13 @@ bool Basic::heartbeat(uint32_t, uint32_t) {
     }
   }
   std::string aim_name = params_["routing"].data;
-  if (aim_name != "") {
+  //The net can work without the engine(like the tools).
+  auto engine = ENGINE_POINTER;
+  if (aim_name != "" && !is_null(engine)) {
     auto last_check = params_["routing_check"].get<uint32_t>();
     if (now - last_check >= 3) {
       std::string service = params_["routing_service"].data;
-      manager::Listener *listener = ENGINE_POINTER->get_service(service);
+      manager::Listener *listener = engine->get_service(service);
       if (is_null(listener)) return false;
       auto connection = listener->get(aim_name);
       if (is_null(connection) || connection->is_disconnect()) {
@@ -194,9 +289,11 @@ void Basic::disconnect() {
   using namespace pf_basic::type;
   //Notice routing original.
   std::string aim_name = params_["routing"].data;
-  if (aim_name != "") {
+  //The net can work without the engine(like the tools).
+  auto engine = ENGINE_POINTER;
+  if (aim_name != "" && !is_null(engine)) {
     std::string service = params_["routing_service"].data;
-    manager::Listener *listener = ENGINE_POINTER->get_service(service);
+    manager::Listener *listener = engine->get_service(service);
     if (is_null(listener)) return;
     auto connection = listener->get(aim_name);
     if (!is_null(connection) && name_ != "") {
@@ -205,7 +302,7 @@ void Basic::disconnect() {
       connection->send(&packet);
     }
   }
-  auto script = ENGINE_POINTER->get_script();
+  auto script = is_null(engine) ? nullptr : engine->get_script();
   if (!is_null(script) && GLOBALS["default.script.netlost"] != "") {
     auto func = GLOBALS["default.script.netlost"].data;
     variable_array_t params;
@@ -232,6 +329,13 @@ void Basic::clear() {
   packet_index_ = 0;
   status_ = 0;
   execute_count_pretick_ = NET_CONNECTION_EXECUTE_COUNT_PRE_TICK_DEFAULT;
+  send_policy_ = kSendPolicyTick;
+  lane_clear();
+  limiter_.clear();
+  flush_stalls_ = 0;
+  capture_ = false;
+  corked_ = false;
+  cork_bulk_ = false;
   set_disconnect(true);
   set_empty(true);
   set_safe_encrypt(false);
@@ -239,6 +343,19 @@ void Basic::clear() {
   name_ = "";
   params_.clear();
   routing_list_.clear();
+  //The compact(from handshake) or listener protocol only for this session.
+  set_protocol(manager::Interface::protocol_default());
+}
+
+void Basic::set_protocol(protocol::Interface *_protocol) {
+  protocol_ = _protocol;
+  //The generated packets read and write varint by the stream.
+  bool compact = protocol_ == manager::Interface::protocol_compact();
+  if (istream_) istream_->set_compact(compact);
+  if (istream_compress_) istream_compress_->set_compact(compact);
+  if (ostream_) ostream_->set_compact(compact);
+  for (auto &lane : lanes_)
+    if (lane) lane->set_compact(compact);
 }
 
 uint32_t Basic::get_receive_bytes() {
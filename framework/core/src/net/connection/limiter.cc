@@ -0,0 +1,84 @@
+#include "pf/net/connection/limiter.h"
+
+namespace pf_net {
+
+namespace connection {
+
+Limiter::Limiter() :
+  rules_{nullptr},
+  delaying_{false} {
+  //do nothing
+}
+
+void Limiter::set_rules(limit_rules_t *rules, uint64_t now) {
+  clear();
+  rules_ = rules;
+  if (is_null(rules_)) return;
+  //The bucket is full when start.
+  bucket_.tokens = rules_->connection.burst * NET_CONNECTION_LIMIT_TOKEN_SCALE;
+  bucket_.last = now;
+}
+
+void Limiter::clear() {
+  rules_ = nullptr;
+  bucket_ = token_bucket_t();
+  packet_buckets_.clear();
+  counters_.clear();
+  delaying_ = false;
+}
+
+limit_action_t Limiter::check_rules(uint16_t packetid, uint64_t now) {
+  //Check all the buckets before take, the held packet not charged.
+  const limit_rule_t &rule = rules_->connection;
+  if (rule.rate > 0) {
+    bucket_.refill(rule, now);
+    if (!bucket_.ready()) return count(rule.action);
+  }
+  auto it = rules_->packets.find(packetid);
+  if (it != rules_->packets.end() && it->second.rate > 0) {
+    auto bucket = packet_buckets_.find(packetid);
+    if (bucket == packet_buckets_.end()) {
+      token_bucket_t _bucket;
+      _bucket.tokens = it->second.burst * NET_CONNECTION_LIMIT_TOKEN_SCALE;
+      _bucket.last = now;
+      bucket = packet_buckets_.insert(std::make_pair(packetid, _bucket)).first;
+    }
+    bucket->second.refill(it->second, now);
+    if (!bucket->second.ready()) return count(it->second.action);
+    bucket->second.consume();
+  }
+  if (rule.rate > 0) bucket_.consume();
+  return count(kLimitActionNone);
+}
+
+limit_action_t Limiter::count(limit_action_t action) {
+  limit_counters_t &total = rules_->counters;
+  switch (action) {
+    case kLimitActionNone:
+      counters_.passed.fetch_add(1, std::memory_order_relaxed);
+      total.passed.fetch_add(1, std::memory_order_relaxed);
+      break;
+    case kLimitActionDrop:
+      counters_.dropped.fetch_add(1, std::memory_order_relaxed);
+      total.dropped.fetch_add(1, std::memory_order_relaxed);
+      break;
+    case kLimitActionDelay:
+      //The delayed packet stay at the stream head, the next check is retry.
+      if (delaying_) break;
+      counters_.delayed.fetch_add(1, std::memory_order_relaxed);
+      total.delayed.fetch_add(1, std::memory_order_relaxed);
+      break;
+    case kLimitActionDisconnect:
+      counters_.disconnected.fetch_add(1, std::memory_order_relaxed);
+      total.disconnected.fetch_add(1, std::memory_order_relaxed);
+      break;
+    default:
+      break;
+  }
+  delaying_ = kLimitActionDelay == action;
+  return action;
+}
+
+} //namespace connection
+
+} //namespace pf_net
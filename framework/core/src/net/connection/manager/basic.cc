@@ -1,10 +1,12 @@
 #include "pf/basic/time_manager.h"
 #include "pf/sys/assert.h"
+#include "pf/net/metrics.h"
+#include "pf/basic/trace.h"
 #include "pf/net/connection/manager/basic.h"
 
 using namespace pf_net::connection::manager;
 
-bool Basic::heartbeat(uint32_t time) {
+bool Basic::heartbeat(uint64_t time) {
   using namespace pf_net;
   auto _time = 0 == time ? TIME_MANAGER_POINTER->get_tickcount() : time;
   auto _size = size();
@@ -27,8 +29,14 @@ bool Basic::heartbeat(uint32_t time) {
 
 void Basic::tick() {
   bool result = false;
+  bool use_metrics = pf_net::metrics::enable();
+  uint64_t begin = use_metrics ? pf_net::metrics::now() : 0;
+  //The awaitable created in handlers resume in this manager tick.
+  pf_sys::ResumerGuard guard(resumer());
+  TRACE_SCOPE("net", "tick");
   //normal.
   try {
+    TRACE_SCOPE("net", "io");
     result = select();
     //Assert(result);
 
@@ -46,6 +54,7 @@ void Basic::tick() {
 
   //command.
   try {
+    TRACE_SCOPE("net", "command");
     result = process_command();
     //Assert(result);
   } catch(...) {
@@ -53,17 +62,48 @@ void Basic::tick() {
   }
   //cache command. 
   try {
+    TRACE_SCOPE("net", "command_cache");
     result = process_command_cache();
     //Assert(result);
   } catch(...) {
 
   }
 
+  //resume the awaitable continuations.
+  try {
+    TRACE_SCOPE("net", "post");
+    result = process_post();
+  } catch(...) {
+
+  }
+
   //heartbeat.
   try {
+    TRACE_SCOPE("net", "heartbeat");
     result = heartbeat();
     //Assert(result);
   } catch(...) {
 
   }
+
+  if (use_metrics) {
+    metrics_.tick.record(pf_net::metrics::now() - begin);
+    update_metrics();
+  }
+}
+
+void Basic::update_metrics() {
+  uint64_t input_pending{0};
+  uint64_t output_pending{0};
+  auto _size = size();
+  for (decltype(_size)i = 0; i < _size; ++i) {
+    if (ID_INVALID == connection_idset_[i]) continue;
+    auto connection = pool_->get(connection_idset_[i]);
+    if (is_null(connection)) continue;
+    input_pending += connection->input_pending();
+    output_pending += connection->output_pending();
+  }
+  metrics_.connections.store(_size, std::memory_order_relaxed);
+  metrics_.input_pending.store(input_pending, std::memory_order_relaxed);
+  metrics_.output_pending.store(output_pending, std::memory_order_relaxed);
 }
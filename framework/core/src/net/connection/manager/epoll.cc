@@ -113,11 +113,12 @@ bool Epoll::process_input() {
         util::get_highsection(polldata_.events[i].data.u64));
     int16_t connection_id = static_cast<int16_t>(
         util::get_lowsection(polldata_.events[i].data.u64));
-    if (socket_id != SOCKET_INVALID && 
-        socket_id == listener_socket_id() && 
-        accept_count < onestep_accept_ ) {
-      accept();
-      ++accept_count;
+    if (socket_id != SOCKET_INVALID && socket_id == listener_socket_id()) {
+      //Edge triggered, so accept all the pending(one event for them).
+      while (onestep_accept_ < 0 || accept_count < onestep_accept_) {
+        if (is_null(accept())) break;
+        ++accept_count;
+      }
     } else if (polldata_.events[i].events & EPOLLIN) {
       connection::Basic *connection = nullptr;
       if (ID_INVALID == connection_id) {
@@ -224,7 +225,7 @@ bool Epoll::process_command() {
   return true;
 }
 
-bool Epoll::heartbeat(uint32_t time) {
+bool Epoll::heartbeat(uint64_t time) {
   bool result = Interface::heartbeat(time);
   return result;
 }
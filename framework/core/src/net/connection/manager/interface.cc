@@ -74,12 +74,19 @@ void Interface::pool_set(connection::Pool *pool) {
   pool_ = std::move(pointer);
 }
 
-bool Interface::heartbeat(uint32_t) {
+bool Interface::heartbeat(uint64_t) {
   bool result = true;
   return result;
 }
 
 bool Interface::add(connection::Basic *connection) {
+  if (!attach(connection)) return false;
+  on_connect(connection);
+  if (!is_null(callback_connect_)) callback_connect_(connection);
+  return true;
+}
+
+bool Interface::attach(connection::Basic *connection) {
   Assert(connection);
   if (size_ >= max_size_) return false;
   //首先处理socket
@@ -96,8 +103,6 @@ bool Interface::add(connection::Basic *connection) {
   }
   connection->set_disconnect(false); //connect is success
   connection->set_empty(false);      //Pool use flag.
-  on_connect(connection);
-  if (!is_null(callback_connect_)) callback_connect_(connection);
   return true;
 }
 
@@ -134,9 +139,9 @@ bool Interface::erase(connection::Basic *connection) {
   //Second clean in connection manager.
   if (!remove(connection->get_id())) return false;
 #ifdef _DEBUG
-  FAST_LOG(NET_MODULENAME, 
-           "[net.connection.manager] (Interface::erase) id: %d", 
-           connection->get_id());
+  BINARY_LOG(NET_MODULENAME,
+             "[net.connection.manager] (Interface::erase) id: %d", 
+             connection->get_id());
 #endif
   return true;
 }
@@ -386,6 +391,43 @@ void Interface::broadcast(packet::Interface *packet) {
   }
 }
 
+void Interface::post(const std::function<void()> &function) {
+  std::unique_lock<std::mutex> autolock(post_mutex_);
+  posts_.emplace_back(function);
+}
+
+bool Interface::process_post() {
+  std::vector< std::function<void()> > posts;
+  {
+    std::unique_lock<std::mutex> autolock(post_mutex_);
+    if (posts_.empty()) return true;
+    posts.swap(posts_);
+  }
+  //The continuation post again will run in next tick.
+  pf_sys::ResumerGuard guard(resumer());
+  for (auto &function : posts) {
+    try {
+      function();
+    } catch (...) {
+      SaveErrorLog();
+    }
+  }
+  return true;
+}
+
+pf_sys::Awaitable<bool> Interface::send_async(packet::Interface *packet, 
+                                              uint16_t id) {
+  pf_sys::Promise<bool> promise;
+  post([this, packet, id, promise]() mutable {
+    auto connection = get(id);
+    bool result = connection && connection->send(packet);
+    if (NET_PACKET_FACTORYMANAGER_POINTER)
+      NET_PACKET_FACTORYMANAGER_POINTER->packet_remove(packet);
+    promise.set_value(result);
+  });
+  return promise.awaitable();
+}
+
 bool Interface::checkpool(bool log) {
   if (is_null(pool_) && log) {
     SLOW_ERRORLOG(NET_MODULENAME,
@@ -9,8 +9,14 @@ using namespace pf_net::connection::manager;
 
 Listener::Listener() :
   listener_socket_{nullptr},
+  safe_encrypt_str_{""},
+  compact_{false},
+  nodelay_{false},
+  send_policy_{kSendPolicyTick},
+  capture_{false},
+  protocol_{nullptr},
   ready_{false}, 
-  safe_encrypt_str_{""} {
+  handoff_accept_{-2} {
   //do nothing
 }
 
@@ -24,7 +30,12 @@ bool Listener::init(uint16_t _max_size, uint16_t _port, const std::string &ip) {
     pointer{new socket::Listener()};
   if (is_null(pointer)) return false;
   listener_socket_ = std::move(pointer);
-  if (!listener_socket_->init(_port, ip)) return false;
+  auto id = pf_net::handoff::take_listener(_port);
+  if (id != SOCKET_INVALID) {
+    if (!listener_socket_->attach(id, _port, ip)) return false;
+  } else if (!listener_socket_->init(_port, ip)) {
+    return false;
+  }
   listener_socket_->set_nonblocking();
   Assert(listener_socket_->get_id() != SOCKET_INVALID);
   return Basic::init(_max_size);
@@ -40,7 +51,7 @@ pf_net::connection::Basic *Listener::accept() {
     if (listener_socket_->accept(&socket)) {
       socket.close();
     }
-    static uint32_t checktime{0};
+    static uint64_t checktime{0};
     auto _tick = TIME_MANAGER_POINTER->get_tickcount();
     if (0 == checktime || _tick - checktime >= 600000) {
       SLOW_WARNINGLOG(NET_MODULENAME, 
@@ -105,12 +116,12 @@ pf_net::connection::Basic *Listener::accept() {
     step += 100000;
   }
 #ifdef _DEBUG
-  FAST_LOG(NET_MODULENAME,
-           "[net.connection.manager] (Listener::accept)"
-           " host: %s id: %d socketid: %d",
-           newconnection->socket()->host(),
-           newconnection->get_id(),
-           newconnection->socket()->get_id());
+  BINARY_LOG(NET_MODULENAME,
+             "[net.connection.manager] (Listener::accept)"
+             " host: %s id: %d socketid: %d",
+             newconnection->socket()->host(),
+             newconnection->get_id(),
+             newconnection->socket()->get_id());
 #endif
   return newconnection;
 EXCEPTION:
@@ -123,4 +134,111 @@ void Listener::on_connect(connection::Basic *connection) {
   if (safe_encrypt_str_ != "")
     connection->set_safe_encrypt_time(TIME_MANAGER_POINTER->get_ctime());
   connection->set_listener(this);
+  if (nodelay_) connection->socket()->set_nodelay(true);
+  connection->set_send_policy(send_policy_);
+  connection->set_capture(capture_);
+  if (protocol_) connection->set_protocol(protocol_);
+  if (limit_rules_.connection.rate > 0 || !limit_rules_.packets.empty()) {
+    connection->limiter().set_rules(
+        &limit_rules_, TIME_MANAGER_POINTER->get_tickcount());
+  }
+}
+
+void Listener::handoff(std::vector<pf_net::handoff::item_t> &items,
+                       bool connections) {
+#if OS_UNIX
+  using namespace pf_net::handoff;
+  if (!listener_socket_) return;
+  if (-2 == handoff_accept_) handoff_accept_ = get_onestep_accept();
+  set_onestep_accept(0); //The new process accept from now.
+  item_t item;
+  item.type = kTypeListener;
+  item.fd = dup(listener_socket_->get_id());
+  item.port = port();
+  if (item.fd < 0) return;
+  items.push_back(item);
+  if (!connections) return;
+  std::vector<connection::Basic *> list;
+  for (uint16_t i = 0; i < size_; ++i) {
+    if (ID_INVALID == connection_idset_[i]) continue;
+    auto connection = pool_->get(connection_idset_[i]);
+    if (is_null(connection) || connection->is_disconnect()) continue;
+    connection->flush();
+    auto &istream = connection->istream();
+    if (connection->ostream().size() > 0 ||
+        istream.encrypt_isenable() ||
+        connection->compress_get_mode() != kCompressModeNone) continue;
+    item_t _item;
+    _item.type = kTypeConnection;
+    _item.fd = dup(connection->socket()->get_id());
+    if (_item.fd < 0) continue;
+    _item.port = port();
+    _item.remote_port = connection->socket()->port();
+    _item.host = connection->socket()->host();
+    _item.name = connection->name();
+    if (connection->protocol() == protocol_compact())
+      _item.flags |= kFlagCompact;
+    auto size = static_cast<uint32_t>(istream.size());
+    if (size > 0) {
+      _item.input.resize(size);
+      istream.peek(&_item.input[0], size);
+    }
+    items.push_back(_item);
+    list.push_back(connection);
+  }
+  //Not read(the input sent) until finish.
+  for (auto connection : list) {
+    if (!erase(connection)) continue;
+    handoff_connections_.push_back(connection->get_id());
+  }
+#endif
+}
+
+void Listener::handoff_finish(bool result) {
+  for (auto id : handoff_connections_) {
+    auto connection = pool_->get(id);
+    if (is_null(connection)) continue;
+    if (!result && attach(connection)) continue;
+    //Without the disconnect callbacks, the peer is connected to the new one.
+    if (connection->name() != "") connection_names_[connection->name()] = -1;
+    connection->clear();
+    pool_->remove(id);
+  }
+  handoff_connections_.clear();
+  if (!result && handoff_accept_ != -2) set_onestep_accept(handoff_accept_);
+  handoff_accept_ = -2;
+}
+
+uint16_t Listener::adopt() {
+  using namespace pf_net::handoff;
+  std::vector<item_t> items;
+  take_connections(port(), items);
+  uint16_t count{0};
+  for (auto &item : items) {
+    auto connection = pool_->create();
+    if (is_null(connection)) {
+      socket::api::closeex(item.fd);
+      continue;
+    }
+    connection->init(protocol());
+    connection->clear();
+    auto socket = connection->socket();
+    socket->set_id(item.fd);
+    socket->set_port(item.remote_port);
+    socket->set_host(item.host.c_str());
+    if (!socket->set_nonblocking() || !add(connection)) {
+      connection->clear();
+      pool_->remove(connection->get_id());
+      continue;
+    }
+    if (item.flags & kFlagCompact) connection->set_protocol(protocol_compact());
+    if (item.name != "") {
+      connection->set_name(item.name);
+      set_connection_name(connection->get_id(), item.name);
+    }
+    auto size = static_cast<uint32_t>(item.input.size());
+    if (size > 0) connection->istream().write(item.input.data(), size);
+    ++count;
+  }
+  return count;
 }
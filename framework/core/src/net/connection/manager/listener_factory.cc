@@ -16,6 +16,11 @@ eid_t ListenerFactory::newenv(const listener_config_t &config) {
   pointer->set_name(config.name); 
   if (config.encrypt_str != "") 
     pointer->set_safe_encrypt_str(config.encrypt_str);
+  pointer->set_compact(config.compact);
+  pointer->set_nodelay(config.nodelay);
+  pointer->set_send_policy(static_cast<send_policy_t>(config.send_policy));
+  pointer->set_capture(config.capture);
+  pointer->set_limit(config.limit);
   envs_[eid] = std::move(pointer);
   return eid;
 }
@@ -72,7 +72,7 @@ bool Select::process_input() {
   //接受新连接的时候至少尝试两次，所以连接池里会多创建一个
   if (listener_socket_id() != SOCKET_INVALID && 
       FD_ISSET(listener_socket_id(), &readfds_[kSelectUse])) {
-    for (i = 0; i < onestep_accept_; ++i) {
+    for (i = 0; onestep_accept_ < 0 || i < onestep_accept_; ++i) {
       if (!accept()) break;
     }
   }
@@ -250,7 +250,7 @@ bool Select::socket_remove(int32_t socketid) {
   return true;
 }
 
-bool Select::heartbeat(uint32_t time) {
+bool Select::heartbeat(uint64_t time) {
   bool result = Interface::heartbeat(time);
   return result;
 }
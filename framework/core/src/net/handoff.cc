@@ -0,0 +1,389 @@
+#include "pf/basic/logger.h"
+#include "pf/net/socket/api.h"
+#include "pf/net/handoff.h"
+#if OS_UNIX
+#include <sys/un.h>
+#include <sys/stat.h>
+#endif
+
+namespace pf_net {
+
+namespace handoff {
+
+namespace {
+
+std::mutex g_mutex; //The received items.
+std::vector<item_t> g_items;
+int32_t g_listen{SOCKET_INVALID};
+
+#if OS_UNIX
+
+template <typename T>
+void append(std::string &data, T value) {
+  data.append(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+void append(std::string &data, const std::string &value, bool large) {
+  if (large) {
+    append(data, static_cast<uint32_t>(value.size()));
+  } else {
+    append(data, static_cast<uint16_t>(value.size()));
+  }
+  data.append(value);
+}
+
+template <typename T>
+bool extract(const std::string &data, size_t &position, T &value) {
+  if (position + sizeof(value) > data.size()) return false;
+  memcpy(&value, data.data() + position, sizeof(value));
+  position += sizeof(value);
+  return true;
+}
+
+bool extract(const std::string &data,
+             size_t &position,
+             std::string &value,
+             bool large) {
+  uint32_t size{0};
+  if (large) {
+    if (!extract(data, position, size)) return false;
+  } else {
+    uint16_t _size{0};
+    if (!extract(data, position, _size)) return false;
+    size = _size;
+  }
+  if (position + size > data.size()) return false;
+  value.assign(data.data() + position, size);
+  position += size;
+  return true;
+}
+
+bool write_all(int32_t fd, const char *data, size_t size) {
+  while (size > 0) {
+    auto result = ::write(fd, data, size);
+    if (result < 0 && EINTR == errno) continue;
+    if (result <= 0) return false;
+    data += result;
+    size -= static_cast<size_t>(result);
+  }
+  return true;
+}
+
+bool read_all(int32_t fd, char *data, size_t size) {
+  while (size > 0) {
+    auto result = ::read(fd, data, size);
+    if (result < 0 && EINTR == errno) continue;
+    if (result <= 0) return false;
+    data += result;
+    size -= static_cast<size_t>(result);
+  }
+  return true;
+}
+
+void set_timeout(int32_t fd) {
+  struct timeval timeout;
+  timeout.tv_sec = NET_HANDOFF_TIMEOUT;
+  timeout.tv_usec = 0;
+  ::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+  ::setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+}
+
+//Only the same user can take the sockets.
+bool peer_trusted(int32_t fd) {
+#if defined(SO_PEERCRED)
+  struct ucred credentials;
+  socklen_t size = sizeof(credentials);
+  if (::getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &credentials, &size) != 0)
+    return false;
+  return credentials.uid == ::geteuid();
+#else
+  uid_t uid;
+  gid_t gid;
+  if (::getpeereid(fd, &uid, &gid) != 0) return false;
+  return uid == ::geteuid();
+#endif
+}
+
+bool address(const std::string &path, struct sockaddr_un &addr) {
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  if (path.empty() || path.size() >= sizeof(addr.sun_path)) return false;
+  memcpy(addr.sun_path, path.c_str(), path.size());
+  return true;
+}
+
+//Send the header with the fds, then the items data.
+bool send_message(int32_t peer,
+                  const std::vector<item_t> &items,
+                  size_t begin,
+                  size_t count) {
+  std::string data;
+  for (size_t i = begin; i < begin + count; ++i) {
+    auto &item = items[i];
+    append(data, item.type);
+    append(data, item.flags);
+    append(data, item.port);
+    append(data, item.remote_port);
+    append(data, item.host, false);
+    append(data, item.name, false);
+    append(data, item.input, true);
+  }
+  char header[NET_HANDOFF_HEADER_SIZE] = {0};
+  uint32_t magic{NET_HANDOFF_MAGIC};
+  uint16_t _count = static_cast<uint16_t>(count);
+  uint32_t size = static_cast<uint32_t>(data.size());
+  memcpy(header, &magic, sizeof(magic));
+  memcpy(header + 4, &_count, sizeof(_count));
+  memcpy(header + 8, &size, sizeof(size));
+  struct iovec iov;
+  iov.iov_base = header;
+  iov.iov_len = sizeof(header);
+  struct msghdr message;
+  memset(&message, 0, sizeof(message));
+  message.msg_iov = &iov;
+  message.msg_iovlen = 1;
+  char control[CMSG_SPACE(sizeof(int32_t) * NET_HANDOFF_FDS_MAX)];
+  if (count > 0) {
+    memset(control, 0, sizeof(control));
+    message.msg_control = control;
+    message.msg_controllen = CMSG_SPACE(sizeof(int32_t) * count);
+    auto cmsg = CMSG_FIRSTHDR(&message);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(int32_t) * count);
+    auto fds = reinterpret_cast<int32_t *>(CMSG_DATA(cmsg));
+    for (size_t i = 0; i < count; ++i) fds[i] = items[begin + i].fd;
+  }
+  ssize_t result{0};
+  do {
+    result = ::sendmsg(peer, &message, 0);
+  } while (result < 0 && EINTR == errno);
+  if (result < 0) return false;
+  //The fds only with the first bytes.
+  auto sent = static_cast<size_t>(result);
+  if (sent < sizeof(header) &&
+      !write_all(peer, header + sent, sizeof(header) - sent)) return false;
+  return write_all(peer, data.data(), data.size());
+}
+
+//Return the count of items, -1 is error.
+int32_t receive_message(int32_t peer) {
+  char header[NET_HANDOFF_HEADER_SIZE] = {0};
+  struct iovec iov;
+  iov.iov_base = header;
+  iov.iov_len = sizeof(header);
+  struct msghdr message;
+  memset(&message, 0, sizeof(message));
+  message.msg_iov = &iov;
+  message.msg_iovlen = 1;
+  char control[CMSG_SPACE(sizeof(int32_t) * NET_HANDOFF_FDS_MAX)];
+  message.msg_control = control;
+  message.msg_controllen = sizeof(control);
+  ssize_t result{0};
+  do {
+    result = ::recvmsg(peer, &message, MSG_CMSG_CLOEXEC);
+  } while (result < 0 && EINTR == errno);
+  if (result <= 0) return -1;
+  std::vector<int32_t> fds;
+  for (auto cmsg = CMSG_FIRSTHDR(&message);
+       cmsg != nullptr;
+       cmsg = CMSG_NXTHDR(&message, cmsg)) {
+    if (cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS)
+      continue;
+    auto count = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int32_t);
+    auto data = reinterpret_cast<int32_t *>(CMSG_DATA(cmsg));
+    for (size_t i = 0; i < count; ++i) fds.push_back(data[i]);
+  }
+  auto received = static_cast<size_t>(result);
+  uint32_t magic{0};
+  uint16_t count{0};
+  uint32_t size{0};
+  std::string data;
+  bool ok = received == sizeof(header) ||
+    read_all(peer, header + received, sizeof(header) - received);
+  if (ok) {
+    memcpy(&magic, header, sizeof(magic));
+    memcpy(&count, header + 4, sizeof(count));
+    memcpy(&size, header + 8, sizeof(size));
+    ok = NET_HANDOFF_MAGIC == magic && fds.size() == count;
+  }
+  if (ok) {
+    data.resize(size);
+    ok = 0 == size || read_all(peer, &data[0], size);
+  }
+  size_t position{0};
+  std::vector<item_t> items;
+  for (uint16_t i = 0; ok && i < count; ++i) {
+    item_t item;
+    ok = extract(data, position, item.type) &&
+         extract(data, position, item.flags) &&
+         extract(data, position, item.port) &&
+         extract(data, position, item.remote_port) &&
+         extract(data, position, item.host, false) &&
+         extract(data, position, item.name, false) &&
+         extract(data, position, item.input, true);
+    item.fd = fds[i];
+    items.push_back(item);
+  }
+  if (!ok) {
+    for (int32_t fd : fds) ::close(fd);
+    return -1;
+  }
+  std::unique_lock<std::mutex> autolock(g_mutex);
+  for (auto &item : items) g_items.push_back(std::move(item));
+  return count;
+}
+
+#endif
+
+} //namespace
+
+#if OS_UNIX
+
+bool listen(const std::string &path) {
+  struct sockaddr_un addr;
+  if (!address(path, addr)) return false;
+  close();
+  auto fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (fd < 0) return false;
+  unlink(path.c_str());
+  //The owner only, not connectable before listen.
+  if (::bind(fd, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) != 0
+      || ::chmod(path.c_str(), S_IRUSR | S_IWUSR) != 0
+      || ::listen(fd, 1) != 0) {
+    SLOW_ERRORLOG(NET_MODULENAME,
+                  "[net.handoff] listen(%s) failed, errno: %d",
+                  path.c_str(),
+                  errno);
+    ::close(fd);
+    return false;
+  }
+  g_listen = fd;
+  return true;
+}
+
+int32_t accept() {
+  if (SOCKET_INVALID == g_listen) return SOCKET_INVALID;
+  auto fd = ::accept(g_listen, nullptr, nullptr);
+  if (fd < 0) return SOCKET_INVALID;
+  if (!peer_trusted(fd)) {
+    SLOW_ERRORLOG(NET_MODULENAME,
+                  "[net.handoff] accept the peer not the same user");
+    ::close(fd);
+    return SOCKET_INVALID;
+  }
+  set_timeout(fd);
+  return fd;
+}
+
+void close() {
+  if (SOCKET_INVALID == g_listen) return;
+  ::close(g_listen);
+  //Not unlink, the new process may listen the same path.
+  g_listen = SOCKET_INVALID;
+}
+
+bool send(int32_t peer, std::vector<item_t> &items) {
+  bool result = true;
+  for (size_t i = 0; result && i < items.size(); i += NET_HANDOFF_FDS_MAX) {
+    auto count = items.size() - i;
+    if (count > NET_HANDOFF_FDS_MAX) count = NET_HANDOFF_FDS_MAX;
+    result = send_message(peer, items, i, count);
+  }
+  for (auto &item : items) {
+    if (item.fd != SOCKET_INVALID) ::close(item.fd);
+    item.fd = SOCKET_INVALID;
+  }
+  char ack{0};
+  result = result &&
+           send_message(peer, items, 0, 0) &&
+           read_all(peer, &ack, sizeof(ack));
+  if (!result) {
+    SLOW_ERRORLOG(NET_MODULENAME,
+                  "[net.handoff] send failed, errno: %d",
+                  errno);
+  }
+  return result;
+}
+
+bool receive(const std::string &path) {
+  struct sockaddr_un addr;
+  if (!address(path, addr)) return false;
+  auto fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (fd < 0) return false;
+  set_timeout(fd);
+  if (::connect(fd, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr))
+      != 0) {
+    SLOW_ERRORLOG(NET_MODULENAME,
+                  "[net.handoff] receive connect(%s) failed, errno: %d",
+                  path.c_str(),
+                  errno);
+    ::close(fd);
+    return false;
+  }
+  int32_t count{0};
+  size_t total{0};
+  for (;;) {
+    count = receive_message(fd);
+    if (count <= 0) break;
+    total += static_cast<size_t>(count);
+  }
+  char ack{1};
+  bool result = 0 == count && write_all(fd, &ack, sizeof(ack));
+  ::close(fd);
+  if (!result) {
+    SLOW_ERRORLOG(NET_MODULENAME, "[net.handoff] receive failed");
+    clear();
+    return false;
+  }
+  SLOW_LOG(NET_MODULENAME,
+           "[net.handoff] received %d sockets",
+           static_cast<int32_t>(total));
+  return true;
+}
+
+#else
+
+bool listen(const std::string &) { return false; }
+int32_t accept() { return SOCKET_INVALID; }
+void close() {}
+bool send(int32_t, std::vector<item_t> &) { return false; }
+bool receive(const std::string &) { return false; }
+
+#endif
+
+int32_t take_listener(uint16_t port) {
+  std::unique_lock<std::mutex> autolock(g_mutex);
+  for (auto it = g_items.begin(); it != g_items.end(); ++it) {
+    if (kTypeListener == it->type && port == it->port) {
+      auto fd = it->fd;
+      g_items.erase(it);
+      return fd;
+    }
+  }
+  return SOCKET_INVALID;
+}
+
+void take_connections(uint16_t port, std::vector<item_t> &items) {
+  std::unique_lock<std::mutex> autolock(g_mutex);
+  for (auto it = g_items.begin(); it != g_items.end();) {
+    if (kTypeConnection == it->type && port == it->port) {
+      items.push_back(std::move(*it));
+      it = g_items.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+void clear() {
+  std::unique_lock<std::mutex> autolock(g_mutex);
+#if OS_UNIX
+  for (auto &item : g_items) ::close(item.fd);
+#endif
+  g_items.clear();
+}
+
+} //namespace handoff
+
+} //namespace pf_net
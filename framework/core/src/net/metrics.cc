@@ -0,0 +1,72 @@
+#include "pf/net/metrics.h"
+
+namespace pf_net {
+
+namespace metrics {
+
+namespace {
+
+std::atomic<bool> g_enable{false};
+std::atomic<uint64_t> g_flush_stalls{0};
+std::mutex g_mutex;
+std::list< std::unique_ptr<packet_stat_t> > g_packet_stats; //All threads.
+thread_local std::map<uint16_t, packet_stat_t *> t_packet_stats;
+
+} //namespace
+
+bool enable() {
+  return g_enable.load(std::memory_order_relaxed);
+}
+
+void set_enable(bool flag) {
+  g_enable = flag;
+}
+
+packet_stat_t *packet_stat(uint16_t id) {
+  auto it = t_packet_stats.find(id);
+  if (it != t_packet_stats.end()) return it->second;
+  std::unique_ptr<packet_stat_t> pointer(new packet_stat_t(id));
+  packet_stat_t *stat = pointer.get();
+  {
+    std::unique_lock<std::mutex> autolock(g_mutex);
+    g_packet_stats.push_back(std::move(pointer));
+  }
+  t_packet_stats[id] = stat;
+  return stat;
+}
+
+void packet_snapshot(std::vector<packet_snapshot_t> &snapshots) {
+  std::map<uint16_t, packet_snapshot_t> merged;
+  std::unique_lock<std::mutex> autolock(g_mutex);
+  for (auto &stat : g_packet_stats) {
+    auto it = merged.find(stat->id);
+    if (it == merged.end()) {
+      packet_snapshot_t snapshot;
+      snapshot.id = stat->id;
+      snapshot.count = 0;
+      snapshot.bytes = 0;
+      snapshot.decode = std::make_shared<pf_basic::Histogram>();
+      snapshot.execute = std::make_shared<pf_basic::Histogram>();
+      it = merged.insert(std::make_pair(stat->id, snapshot)).first;
+    }
+    auto &snapshot = it->second;
+    snapshot.count += stat->count.load(std::memory_order_relaxed);
+    snapshot.bytes += stat->bytes.load(std::memory_order_relaxed);
+    snapshot.decode->merge(stat->decode);
+    snapshot.execute->merge(stat->execute);
+  }
+  snapshots.clear();
+  for (auto &it : merged) snapshots.push_back(it.second);
+}
+
+void flush_stall() {
+  g_flush_stalls.fetch_add(1, std::memory_order_relaxed);
+}
+
+uint64_t flush_stalls() {
+  return g_flush_stalls.load(std::memory_order_relaxed);
+}
+
+} //namespace metrics
+
+} //namespace pf_net
@@ -1,5 +1,6 @@
 #include "pf/basic/string.h"
 #include "pf/basic/logger.h"
+#include "pf/basic/trace.h"
 #include "pf/basic/io.tcc"
 #include "pf/basic/stringstream.h"
 #include "pf/basic/type/variable.h"
@@ -80,6 +81,7 @@ uint32_t CallScript::execute(pf_net::connection::Basic *connection) {
   for (const std::string &item : _params)
     params.emplace_back(item);
   type::variable_array_t results;
+  TRACE_SCOPE("script", "call");
   script->call(func_, params, results);
   return kPacketExecuteStatusContinue;
 }
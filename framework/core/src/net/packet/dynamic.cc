@@ -1,4 +1,5 @@
 #include "pf/basic/logger.h"
+#include "pf/net/stream/varint.h"
 #include "pf/net/packet/factorymanager.h"
 #include "pf/net/packet/dynamic.h"
 
@@ -180,6 +181,52 @@ uint32_t Dynamic::read_bytes(unsigned char *value, size_t size) {
   return read((char *)value, size > length ? length : size);
 }
 
+void Dynamic::write_varuint32(uint32_t value) {
+  char buffer[NET_STREAM_VARINT32_SIZEMAX]{0};
+  write(buffer, stream::varint::encode32(value, buffer));
+}
+
+void Dynamic::write_varint32(int32_t value) {
+  write_varuint32(stream::varint::zigzag_encode32(value));
+}
+
+void Dynamic::write_varuint64(uint64_t value) {
+  char buffer[NET_STREAM_VARINT64_SIZEMAX]{0};
+  write(buffer, stream::varint::encode64(value, buffer));
+}
+
+void Dynamic::write_varint64(int64_t value) {
+  write_varuint64(stream::varint::zigzag_encode64(value));
+}
+
+uint32_t Dynamic::read_varuint32() {
+  uint32_t result = 0;
+  if (!readable_ || offset_ >= size_) return result;
+  char *_buffer = reinterpret_cast<char *>(allocator_.get()) + offset_;
+  auto length = stream::varint::decode32(_buffer, size_ - offset_, result);
+  if (length <= 0) return 0;
+  offset_ += static_cast<uint32_t>(length);
+  return result;
+}
+
+int32_t Dynamic::read_varint32() {
+  return stream::varint::zigzag_decode32(read_varuint32());
+}
+
+uint64_t Dynamic::read_varuint64() {
+  uint64_t result = 0;
+  if (!readable_ || offset_ >= size_) return result;
+  char *_buffer = reinterpret_cast<char *>(allocator_.get()) + offset_;
+  auto length = stream::varint::decode64(_buffer, size_ - offset_, result);
+  if (length <= 0) return 0;
+  offset_ += static_cast<uint32_t>(length);
+  return result;
+}
+
+int64_t Dynamic::read_varint64() {
+  return stream::varint::zigzag_decode64(read_varuint64());
+}
+
 void Dynamic::check_memory(uint32_t length) {
   if (length > NET_PACKET_DYNAMIC_SIZEMAX) {
     SLOW_ERRORLOG(NET_MODULENAME,
@@ -1,5 +1,6 @@
 #include "pf/basic/type/variable.h"
 #include "pf/basic/logger.h"
+#include "pf/basic/trace.h"
 #include "pf/engine/kernel.h"
 #include "pf/script/interface.h"
 #include "pf/net/connection/manager/listener.h"
@@ -175,6 +176,11 @@ void FactoryManager::add_factory(Factory *factory) {
     ++factory_size_;
     id_indexs_.add(factory->packet_id(), index);
     factories_[index] = factory;
+    if (factory->packet_lane() != 0) {
+      packet_lanes_[factory->packet_id()] = 
+        factory->packet_lane() < NET_CONNECTION_LANE_MAX ? 
+        factory->packet_lane() : NET_CONNECTION_LANE_MAX - 1;
+    }
   } else {
     SLOW_WARNINGLOG(NET_MODULENAME, 
                     "[net.packet] (FactoryManager::add_factory) repeat add"
@@ -226,6 +232,7 @@ uint32_t FactoryManager::packet_execute(
           params.emplace_back(connection->get_id());
         }
         if (original != "") params.emplace_back(original);
+        TRACE_SCOPE_ARG("script", "call", packet->get_id());
         script->call(funcname, params, r);
       }
       return kPacketExecuteStatusContinue;
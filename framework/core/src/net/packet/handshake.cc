@@ -11,11 +11,13 @@ using namespace pf_net::packet;
 
 bool Handshake::read(pf_net::stream::Input &istream) {
   istream.read_string(key_, sizeof(key_) - 1);
+  if (size_ > sizeof(uint32_t) + strlen(key_)) flags_ = istream.read_uint8();
   return true;
 }
 
 bool Handshake::write(pf_net::stream::Output &ostream) {
   ostream << key_;
+  if (flags_ != 0) ostream << flags_;
   return true;
 }
 
@@ -23,9 +25,21 @@ uint32_t Handshake::size() const {
   size_t result = 0;
   result += sizeof(uint32_t);
   result += strlen(key_);
+  if (flags_ != 0) result += sizeof(flags_);
   return static_cast<uint32_t>(result);
 }
 
+void Handshake::set_encrypt_key(const std::string &encrypt_str) {
+  auto now = TIME_MANAGER_POINTER->get_ctime();
+  std::string str{""};
+  pf_basic::string::encrypt(encrypt_str, now, str);
+  char temp[512]{0,};
+  pf_basic::string::safecopy(temp, str.c_str(), sizeof(temp) - 1);
+  auto key = pf_basic::base64_encode(
+      reinterpret_cast<unsigned char *>(temp), strlen(temp));
+  set_key(key);
+}
+
 uint32_t Handshake::execute(pf_net::connection::Basic *connection) {
   using namespace pf_net::connection;
   using namespace pf_basic;
@@ -58,7 +72,7 @@ uint32_t Handshake::execute(pf_net::connection::Basic *connection) {
   }
   if (encrypt_str == decode_key_1) {
     connection->set_safe_encrypt(true);
-    return kPacketExecuteStatusContinue;
+    return options(connection);
   }
   std::string decode_key_2;
   string::decrypt(decode_key_1, decode_key_2);
@@ -67,5 +81,20 @@ uint32_t Handshake::execute(pf_net::connection::Basic *connection) {
              NET_MODULENAME);    
     return kPacketExecuteStatusError;
   }
-  return kPacketExecuteStatusContinue;
+  return options(connection);
+}
+
+uint32_t Handshake::options(pf_net::connection::Basic *connection) {
+  using namespace pf_net::connection;
+  using namespace pf_basic;
+  if (!(flags_ & kFlagCompact)) return kPacketExecuteStatusContinue;
+  auto listener = connection->get_listener();
+  if (!listener->compact()) {
+    io_cwarn("[%s] The handshake compact protocol not allowed!",
+             NET_MODULENAME);    
+    return kPacketExecuteStatusError;
+  }
+  //The next packets use the compact header, so break the command loop.
+  connection->set_protocol(manager::Interface::protocol_compact());
+  return kPacketExecuteStatusBreak;
 }
@@ -5,6 +5,10 @@
 #include "pf/basic/io.tcc"
 #include "pf/sys/assert.h"
 #include "pf/basic/logger.h"
+#include "pf/basic/time_manager.h"
+#include "pf/basic/trace.h"
+#include "pf/net/metrics.h"
+#include "pf/net/capture.h"
 #include "pf/net/protocol/basic.h"
 
 namespace pf_net {
@@ -21,29 +25,35 @@ Basic::~Basic() {
 
 bool Basic::command(connection::Basic *connection, uint16_t count) {
   bool result = false;
-  char packetheader[NET_PACKET_HEADERSIZE + 1] = {0};
+  header_t header;
   uint16_t packetid = 0;
   if (is_null(connection)) return false;
   stream::Input *istream = &connection->istream();
-  uint32_t packetcheck, packetsize, packetindex;
+  uint32_t packetsize, packetindex, headersize;
   packet::Interface *packet = nullptr;
   if (connection->is_disconnect()) return false; //leave this to connection.
+  auto &limiter = connection->limiter();
+  //The tick cached(the limiter only need the frame precision).
+  uint64_t now = 
+    is_null(limiter.rules()) ? 0 : TIME_MANAGER_POINTER->get_saved_time();
+  bool use_metrics = metrics::enable();
   try {
     uint32_t i;
     for (i = 0; i < count; ++i) {
-      memset(packetheader, 0, sizeof(packetheader));
       if (!istream || 0 == istream->size()) return true;
-      if (!istream->peek(&packetheader[0], NET_PACKET_HEADERSIZE)) {
-        std::cout << "command can't peek" << std::endl;
+      auto peeksize = peek_header(*istream, header);
+      if (peeksize < 0) {
+        pf_basic::io_cerr("packet header error");
+        return false;
+      }
+      if (0 == peeksize) {
         //数据不能填充消息头
         break;
       }
-      memcpy(&packetid, &packetheader[0], sizeof(packetid));
-      memcpy(&packetcheck, 
-             &packetheader[sizeof(packetid)], 
-             sizeof(packetcheck));
-      packetsize = NET_PACKET_GETLENGTH(packetcheck);
-      packetindex = NET_PACKET_GETINDEX(packetcheck);
+      headersize = static_cast<uint32_t>(peeksize);
+      packetid = header.id;
+      packetsize = header.size;
+      packetindex = header.index;
       if (!NET_PACKET_FACTORYMANAGER_POINTER->
           is_valid_packet_id(packetid) &&
           !NET_PACKET_FACTORYMANAGER_POINTER->
@@ -72,13 +82,31 @@ bool Basic::command(connection::Basic *connection, uint16_t count) {
           }
         }
         //check packet size
-        if (istream->size() < 
-            NET_PACKET_HEADERSIZE + packetsize) {
+        if (istream->size() < headersize + packetsize) {
           //message not receive full
           break;
         }
 
+        //rate limit
+        auto action = limiter.check(packetid, now);
+        if (connection::kLimitActionDrop == action) {
+          istream->skip(headersize + packetsize);
+          continue;
+        } else if (connection::kLimitActionDelay == action) {
+          break;
+        } else if (connection::kLimitActionDisconnect == action) {
+          pf_basic::io_cwarn("packet rate limit: %d", packetid);
+          return false;
+        }
+
+        //capture the admitted only(the delayed checked again next tick)
+        if (connection->is_capture())
+          capture::record(connection, *istream, headersize + packetsize);
+
         //create packet
+        TRACE_SCOPE_ARG("net", "packet", packetid);
+        uint64_t begin = use_metrics ? metrics::now() : 0;
+        metrics::packet_stat_t *stat{nullptr};
         packet = NET_PACKET_FACTORYMANAGER_POINTER->packet_create(packetid);
         if (nullptr == packet) return false;
 
@@ -88,12 +116,29 @@ bool Basic::command(connection::Basic *connection, uint16_t count) {
         packet->set_size(packetsize);
 
         //read packet
-        result = istream->skip(NET_PACKET_HEADERSIZE);
+        result = istream->skip(headersize);
+        auto remain = istream->size();
         result = result ? packet->read(*istream) : result;
+        if (result) {
+          //Keep the next packet's head, the read past the body is malformed.
+          auto used = remain - istream->size();
+          if (used > packetsize) {
+            pf_basic::io_cwarn("packet read overflow: %d", packetid);
+            result = false;
+          } else if (used < packetsize) {
+            result = istream->skip(static_cast<uint32_t>(packetsize - used));
+          }
+        }
         if (false == result) {
           NET_PACKET_FACTORYMANAGER_POINTER->packet_remove(packet);
           return result;
         }
+        if (use_metrics) {
+          stat = metrics::packet_stat(packetid);
+          auto _now = metrics::now();
+          stat->on_read(headersize + packetsize, _now - begin);
+          begin = _now;
+        }
         bool needremove = true;
         bool exception = false;
         uint32_t executestatus{kPacketExecuteStatusContinue};
@@ -110,6 +155,7 @@ bool Basic::command(connection::Basic *connection, uint16_t count) {
             SaveErrorLog();
             executestatus = kPacketExecuteStatusError;
           }
+          if (stat) stat->execute.record(metrics::now() - begin);
           if (kPacketExecuteStatusError == executestatus) {
             if (packet) 
               NET_PACKET_FACTORYMANAGER_POINTER->packet_remove(packet);
@@ -266,59 +312,70 @@ bool Basic::compress(connection::Basic * connection,
 
 bool Basic::send(connection::Basic * connection, packet::Interface *packet) {
   bool result = false;
-  stream::Output &ostream = connection->ostream();
+  auto lane = NET_PACKET_FACTORYMANAGER_POINTER->packet_lane(packet->get_id());
+  stream::Output &ostream = connection->lane_ostream(lane);
   if (&ostream) {
-    if (!ostream.use(NET_PACKET_HEADERSIZE + packet->size())) {
+    auto packetsize = 
+      ostream.compact() ? packet->compact_size() : packet->size();
+    if (!ostream.use(header_size() + packetsize)) {
       return false;
     }
     packet->set_index(connection->packet_index());
     uint32_t before_writesize = ostream.size();
-    uint16_t packetid = packet->get_id();
-
-    uint32_t packetcheck{0}; //index and size(if diffrent then have error) 
-    ostream.write(reinterpret_cast<const char *>(&packetid), sizeof(packetid));
-    uint32_t packetsize = packet->size();
-    uint32_t packetindex = packet->get_index();
-    NET_PACKET_SETINDEX(packetcheck, packetindex);
-    NET_PACKET_SETLENGTH(packetcheck, packetsize);
-    ostream.write(reinterpret_cast<const char *>(&packetcheck), 
-                  sizeof(packetcheck));
-    result = packet->write(ostream);
-    Assert(result);
+    header_t header;
+    header.id = packet->get_id();
+    header.size = packetsize;
+    header.index = static_cast<uint8_t>(packet->get_index());
+    uint32_t headersize = write_header(ostream, header);
+    if (headersize > 0) {
+      result = packet->write(ostream);
+      Assert(result);
+    }
     uint32_t after_writesize = ostream.size();
-    if (packet->size() != 
-        after_writesize - before_writesize - NET_PACKET_HEADERSIZE) {
-      FAST_ERRORLOG(NET_MODULENAME,
-                    "[net.protocol] (Basic::send) size error,"
-                    " id = %d(write: %d, should: %d)",
-                    packet->get_id(),
-                    after_writesize - before_writesize - 6,
-                    packet->size());
+    if (result && packetsize != 
+        after_writesize - before_writesize - headersize) {
+      BINARY_ERRORLOG(NET_MODULENAME,
+                      "[net.protocol] (Basic::send) size error,"
+                      " id = %d(write: %d, should: %d)",
+                      packet->get_id(),
+                      after_writesize - before_writesize - headersize,
+                      packetsize);
       result = false;
     }
+    //Not leave the bad packet in the stream, or the lane commit the bytes.
+    auto writesize = after_writesize - before_writesize;
+    if (!result) {
+      //The encrypted or compressed stream can't roll back, disconnect it.
+      if (writesize > 0 && !ostream.rollback(writesize)) {
+        SLOW_ERRORLOG(NET_MODULENAME,
+                      "[net.protocol] (Basic::send) rollback failed,"
+                      " id = %d, size = %d",
+                      packet->get_id(),
+                      writesize);
+        connection->set_disconnect(true);
+      }
+      return false;
+    }
+    if (writesize > 0) connection->lane_commit(lane, writesize);
   }
   return result;
 }
 
 packet::Interface *Basic::read_packet(connection::Basic * connection) {
-  char packetheader[NET_PACKET_HEADERSIZE + 1] = {0};
-  uint16_t packetid = 0;
+  header_t header;
   stream::Input *istream = &connection->istream();
-  uint32_t packetcheck, packetsize, packetindex;
   packet::Interface *packet = nullptr;
   //if (isdisconnect()) return true; leave this to connection.
-  memset(packetheader, 0, sizeof(packetheader));
   if (!istream) return nullptr;
-  if (!istream->peek(&packetheader[0], NET_PACKET_HEADERSIZE)) {
+  auto peeksize = peek_header(*istream, header);
+  if (peeksize <= 0) {
     //数据不能填充消息头
     return nullptr;
   }
-  memcpy(&packetid, &packetheader[0], sizeof(packetid));
-  memcpy(&packetcheck, 
-         &packetheader[sizeof(packetid)], 
-         sizeof(packetcheck));
-  packetsize = NET_PACKET_GETLENGTH(packetcheck);
-  packetindex = NET_PACKET_GETINDEX(packetcheck);
+  uint32_t headersize = static_cast<uint32_t>(peeksize);
+  uint16_t packetid = header.id;
+  uint32_t packetsize = header.size;
+  uint32_t packetindex = header.index;
   if (!NET_PACKET_FACTORYMANAGER_POINTER->
       is_valid_packet_id(packetid) &&
       !NET_PACKET_FACTORYMANAGER_POINTER->
@@ -332,8 +389,7 @@ packet::Interface *Basic::read_packet(connection::Basic * connection) {
       !connection->check_safe_encrypt())
     return nullptr;
   //check packet length
-  if (istream->size() < 
-      NET_PACKET_HEADERSIZE + packetsize) {
+  if (istream->size() < headersize + packetsize) {
     //message not receive full
     return nullptr;
   }
@@ -362,7 +418,7 @@ packet::Interface *Basic::read_packet(connection::Basic * connection) {
   
   //read packet
   bool result{false};
-  result = istream->skip(NET_PACKET_HEADERSIZE);
+  result = istream->skip(headersize);
   result = result ? packet->read(*istream) : result;
   if (false == result) {
     NET_PACKET_FACTORYMANAGER_POINTER->packet_remove(packet);
@@ -371,6 +427,31 @@ packet::Interface *Basic::read_packet(connection::Basic * connection) {
   return packet;
 }
 
+int32_t Basic::peek_header(stream::Input &istream, header_t &header) {
+  char packetheader[NET_PACKET_HEADERSIZE] = {0};
+  if (!istream.peek(&packetheader[0], NET_PACKET_HEADERSIZE)) return 0;
+  uint32_t packetcheck{0};
+  memcpy(&header.id, &packetheader[0], sizeof(header.id));
+  memcpy(&packetcheck, 
+         &packetheader[sizeof(header.id)], 
+         sizeof(packetcheck));
+  header.size = NET_PACKET_GETLENGTH(packetcheck);
+  header.index = NET_PACKET_GETINDEX(packetcheck);
+  return static_cast<int32_t>(NET_PACKET_HEADERSIZE);
+}
+
+uint32_t Basic::write_header(stream::Output &ostream, const header_t &header) {
+  uint32_t packetcheck{0}; //index and size(if diffrent then have error) 
+  NET_PACKET_SETINDEX(packetcheck, header.index);
+  NET_PACKET_SETLENGTH(packetcheck, header.size);
+  char packetheader[NET_PACKET_HEADERSIZE] = {0};
+  memcpy(&packetheader[0], &header.id, sizeof(header.id));
+  memcpy(&packetheader[sizeof(header.id)], &packetcheck, sizeof(packetcheck));
+  if (ostream.write(packetheader, sizeof(packetheader)) != 
+      sizeof(packetheader)) return 0;
+  return static_cast<uint32_t>(sizeof(packetheader));
+}
+
 } //namespace protocol
 
 } //namespace pf_net
@@ -0,0 +1,54 @@
+#include "pf/basic/logger.h"
+#include "pf/net/stream/input.h"
+#include "pf/net/stream/output.h"
+#include "pf/net/stream/varint.h"
+#include "pf/net/protocol/compact.h"
+
+namespace pf_net {
+
+namespace protocol {
+
+bool Compact::compress(connection::Basic *, char *, char *) {
+  SLOW_ERRORLOG(NET_MODULENAME,
+                "[net.protocol] (Compact::compress) the compact protocol"
+                " not support the compress mode");
+  return false;
+}
+
+int32_t Compact::peek_header(stream::Input &istream, header_t &header) {
+  char packetheader[NET_PACKET_COMPACT_HEADERSIZE_MAX] = {0};
+  uint32_t length = static_cast<uint32_t>(istream.size());
+  if (length > sizeof(packetheader)) length = sizeof(packetheader);
+  if (!istream.peek(packetheader, length)) return 0;
+  uint32_t id{0};
+  uint32_t size{0};
+  uint32_t position{0};
+  auto used = stream::varint::decode32(packetheader, length, id);
+  if (used <= 0) return used;
+  position += static_cast<uint32_t>(used);
+  used = stream::varint::decode32(
+      packetheader + position, length - position, size);
+  if (used <= 0) return used;
+  position += static_cast<uint32_t>(used);
+  if (position >= length) return 0;
+  if (id > 0xffff || size > 0xffffff) return -1;
+  header.id = static_cast<uint16_t>(id);
+  header.size = size;
+  header.index = static_cast<uint8_t>(packetheader[position]);
+  return static_cast<int32_t>(position + 1);
+}
+
+uint32_t Compact::write_header(stream::Output &ostream, 
+                               const header_t &header) {
+  char packetheader[NET_PACKET_COMPACT_HEADERSIZE_MAX] = {0};
+  if (header.size > 0xffffff) return 0;
+  uint32_t length = stream::varint::encode32(header.id, packetheader);
+  length += stream::varint::encode32(header.size, packetheader + length);
+  packetheader[length++] = static_cast<char>(header.index & 0xff);
+  if (ostream.write(packetheader, length) != length) return 0;
+  return length;
+}
+
+} //namespace protocol
+
+} //namespace pf_net
@@ -0,0 +1,55 @@
+#include "pf/net/connection/basic.h"
+#include "pf/net/protocol/http.h"
+
+namespace pf_net {
+
+namespace protocol {
+
+//The connection status after the response written.
+static const uint8_t kStatusResponded = 1;
+
+bool Http::command(connection::Basic *connection, uint16_t) {
+  if (is_null(connection) || connection->is_disconnect()) return false;
+  //HTTP/1.0 close the connection after all response sent.
+  if (kStatusResponded == connection->get_status())
+    return connection->output_pending() > 0;
+  stream::Input &istream = connection->istream();
+  uint32_t size = static_cast<uint32_t>(istream.size());
+  if (0 == size) return true;
+  if (size > NET_PROTOCOL_HTTP_REQUEST_MAX) return false;
+  std::string request(size, '\0');
+  if (!istream.peek(&request[0], size)) return true;
+  if (std::string::npos == request.find("\r\n\r\n")) return true; //Not full.
+  istream.skip(size);
+  std::string method;
+  std::string path;
+  std::istringstream line(request.substr(0, request.find("\r\n")));
+  line >> method >> path;
+  auto position = path.find('?');
+  if (position != std::string::npos) path = path.substr(0, position);
+  std::string content;
+  if (method != "GET")
+    return response(connection, "405 Method Not Allowed", "");
+  if (!handler_ || !handler_(path, content))
+    return response(connection, "404 Not Found", "");
+  return response(connection, "200 OK", content);
+}
+
+bool Http::response(connection::Basic *connection,
+                    const std::string &status,
+                    const std::string &content) {
+  std::string result{"HTTP/1.0 " + status + "\r\n"};
+  result += "Content-Type: " + content_type_ + "\r\n";
+  result += "Content-Length: " + std::to_string(content.size()) + "\r\n";
+  result += "Connection: close\r\n\r\n";
+  result += content;
+  auto length = static_cast<uint32_t>(result.size());
+  if (connection->ostream().write(result.c_str(), length) != length)
+    return false;
+  connection->set_status(kStatusResponded);
+  return true;
+}
+
+} //namespace protocol
+
+} //namespace pf_net
@@ -282,6 +282,44 @@ bool Basic::set_send_buffer_size(uint32_t size) {
   return result;
 }
 
+bool Basic::is_nodelay() const {
+  int32_t option_value = 0;
+  uint32_t option_length = sizeof(option_value);
+  api::getsockopt_exb(id_, 
+                      IPPROTO_TCP, 
+                      TCP_NODELAY, 
+                      &option_value, 
+                      &option_length);
+  return option_value != 0;
+}
+
+bool Basic::set_nodelay(bool on) {
+  bool result = true;
+  int32_t option = true == on ? 1 : 0;
+  result = api::setsockopt_ex(id_, 
+                              IPPROTO_TCP, 
+                              TCP_NODELAY, 
+                              &option, 
+                              sizeof(option));
+  return result;
+}
+
+//TCP_CORK打开时内核只发送满包，关闭时立即发出剩余的数据
+bool Basic::set_cork(bool on) {
+  bool result = false;
+#if defined(TCP_CORK)
+  int32_t option = true == on ? 1 : 0;
+  result = api::setsockopt_ex(id_, 
+                              IPPROTO_TCP, 
+                              TCP_CORK, 
+                              &option, 
+                              sizeof(option));
+#else
+  UNUSED(on);
+#endif
+  return result;
+}
+
 uint64_t Basic::uint64host() const {
   uint64_t result = 0;
   if (0 == strlen(host_)) {
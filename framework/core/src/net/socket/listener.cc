@@ -52,6 +52,16 @@ bool Listener::init(uint16_t _port, const std::string &ip, uint32_t backlog) {
   return true;
 }
 
+bool Listener::attach(int32_t id, uint16_t _port, const std::string &ip) {
+  if (SOCKET_INVALID == id) return false;
+  std::unique_ptr< Basic > __socket(new pf_net::socket::Basic());
+  socket_ = std::move(__socket);
+  socket_->set_id(id);
+  socket_->set_port(_port);
+  socket_->set_host(ip.c_str());
+  return true;
+}
+
 Listener::~Listener() {
   if (socket_ != nullptr) {
     socket_->close();
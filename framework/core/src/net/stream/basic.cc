@@ -10,7 +10,8 @@ Basic::Basic(socket::Basic *_socket,
              uint32_t bufferlength_max) : 
               socket_{_socket},
               encrypt_isenable_{false},
-              isinit_{false} {
+              isinit_{false},
+              compact_{false} {
   streamdata_.buffer = nullptr;
   streamdata_.bufferlength = bufferlength;
   streamdata_.bufferlength_max = bufferlength_max;
@@ -28,6 +28,7 @@ bool Compressor::alloc(uint32_t size) {
   safe_delete_array(buffer_);
   buffer_ = new char[size];
   if (is_null(buffer_)) return false;
+  maxsize_ = size;
   return true;
 }
 
@@ -1,6 +1,7 @@
 #include "pf/basic/util.h"
 #include "pf/basic/logger.h"
 #include "pf/net/socket/basic.h"
+#include "pf/net/stream/varint.h"
 #include "pf/net/stream/input.h"
 
 namespace pf_net {
@@ -271,20 +272,113 @@ uint64_t Input::read_uint64() {
   return result;
 }
    
-void Input::read_string(char *buffer, size_t _size) {
-  int32_t length = read_uint32();
-  auto read_length = static_cast< int32_t >(_size);
-  if (length <= 0 || read_length < length) {
-    if (read_length < length) {
-      SLOW_ERRORLOG(NET_MODULENAME,
-                    "[net.stream] Input::read_string size < length"
-                    " not read, size: %d, length: %d",
-                    _size, 
-                    length);
-    }
-    return;
+bool Input::read_string(char *buffer, size_t _size) {
+  uint32_t length = read_uint32();
+  if (0 == length) return true;
+  if (length > _size) {
+    SLOW_ERRORLOG(NET_MODULENAME,
+                  "[net.stream] Input::read_string size < length"
+                  " not read, size: %zu, length: %u",
+                  _size, 
+                  length);
+    skip(length); //Keep the next fields.
+    return false;
+  }
+  return read(buffer, length) == length;
+}
+
+bool Input::read_varuint64(uint64_t &value) {
+  char buffer[NET_STREAM_VARINT64_SIZEMAX]{0};
+  uint32_t length = static_cast<uint32_t>(size());
+  if (length > sizeof(buffer)) length = sizeof(buffer);
+  if (0 == length || !peek(buffer, length)) return false;
+  auto used = varint::decode64(buffer, length, value);
+  if (used <= 0) return false;
+  return skip(static_cast<uint32_t>(used));
+}
+
+bool Input::read_varuint32(uint32_t &value) {
+  char buffer[NET_STREAM_VARINT32_SIZEMAX]{0};
+  uint32_t length = static_cast<uint32_t>(size());
+  if (length > sizeof(buffer)) length = sizeof(buffer);
+  if (0 == length || !peek(buffer, length)) return false;
+  auto used = varint::decode32(buffer, length, value);
+  if (used <= 0) return false;
+  return skip(static_cast<uint32_t>(used));
+}
+
+bool Input::read_varint32(int32_t &value) {
+  uint32_t result{0};
+  if (!read_varuint32(result)) return false;
+  value = varint::zigzag_decode32(result);
+  return true;
+}
+
+bool Input::read_varint64(int64_t &value) {
+  uint64_t result{0};
+  if (!read_varuint64(result)) return false;
+  value = varint::zigzag_decode64(result);
+  return true;
+}
+
+uint64_t Input::read_varuint64() {
+  uint64_t result{0};
+  return read_varuint64(result) ? result : 0;
+}
+
+uint32_t Input::read_varuint32() {
+  uint32_t result{0};
+  return read_varuint32(result) ? result : 0;
+}
+
+int32_t Input::read_varint32() {
+  int32_t result{0};
+  return read_varint32(result) ? result : 0;
+}
+
+int64_t Input::read_varint64() {
+  int64_t result{0};
+  return read_varint64(result) ? result : 0;
+}
+
+bool Input::read_varuint32_array(uint32_t *values, uint32_t count) {
+  char buffer[1024]{0};
+  uint32_t decoded = 0;
+  while (decoded < count) {
+    uint32_t length = static_cast<uint32_t>(size());
+    if (length > sizeof(buffer)) length = sizeof(buffer);
+    if (!peek(buffer, length)) return false;
+    uint32_t consumed = 0;
+    auto result = varint::decode32_array(
+        buffer, length, values + decoded, count - decoded, consumed);
+    if (result <= 0) return false;
+    decoded += static_cast<uint32_t>(result);
+    skip(consumed);
+  }
+  return true;
+}
+
+uint32_t Input::read_bytes(unsigned char *buffer, size_t _size) {
+  uint32_t length{0};
+  return read_bytes(buffer, _size, length) ? length : 0;
+}
+
+bool Input::read_bytes(unsigned char *buffer, size_t _size, uint32_t &length) {
+  length = read_uint32();
+  if (0 == length) return true;
+  if (length > _size) {
+    SLOW_ERRORLOG(NET_MODULENAME,
+                  "[net.stream] Input::read_bytes size < length"
+                  " not read, size: %zu, length: %u",
+                  _size,
+                  length);
+    skip(length); //Keep the next fields.
+    length = 0;
+    return false;
   }
-  read(buffer, length);
+  if (read(reinterpret_cast<char *>(buffer), length) == length) return true;
+  length = 0;
+  return false;
 }
 
 float Input::read_float() {
@@ -317,6 +411,8 @@ uint32_t Input::write(const char *buffer, uint32_t length) {
       } else {
         memcpy(&streamdata_.buffer[streamdata_.tail], buffer, copysize);
       }
+      fillcount += copysize;
+      streamdata_.tail += copysize;
     } else {
       freecount = streamdata_.bufferlength - streamdata_.tail;
       uint32_t copysize1 = freecount > length ? length : freecount;
@@ -1,4 +1,5 @@
 #include "pf/net/socket/basic.h"
+#include "pf/net/stream/varint.h"
 #include "pf/net/stream/output.h"
 
 namespace pf_net {
@@ -30,11 +31,13 @@ uint32_t Output::write(const char *buffer, uint32_t length) {
         memcpy(&(streamdata_.buffer[tail]), buffer, length);
       }
     } else {
+      //Wrap happens only when head > 0, the right side can fill to the end.
+      freecount = bufferlength - tail;
       if (encrypt_isenable()) {
         encryptor_.encrypt(&(streamdata_.buffer[tail]), buffer, freecount);
         encryptor_.encrypt(streamdata_.buffer, 
                            &buffer[freecount], 
-                           bufferlength - freecount);
+                           length - freecount);
       } else {
         memcpy(&(streamdata_.buffer[tail]), buffer, freecount);
         memcpy(streamdata_.buffer, &buffer[freecount], length - freecount);
@@ -51,6 +54,31 @@ uint32_t Output::write(const char *buffer, uint32_t length) {
   return length;
 }
 
+uint32_t Output::transfer(Output &target, uint32_t length) {
+  auto &head = streamdata_.head;
+  auto bufferlength = streamdata_.bufferlength;
+  if (0 == length || length > size()) return 0;
+  if (!target.use(length)) return 0; //The writes can't fail after this.
+  uint32_t right = bufferlength - head;
+  if (length <= right) {
+    target.write(&(streamdata_.buffer[head]), length);
+  } else {
+    target.write(&(streamdata_.buffer[head]), right);
+    target.write(streamdata_.buffer, length - right);
+  }
+  head = (head + length) % bufferlength;
+  return length;
+}
+
+bool Output::rollback(uint32_t length) {
+  if (length > size() || 
+      encrypt_isenable() || 
+      compressor_.getassistant()->isenable()) return false;
+  auto bufferlength = streamdata_.bufferlength;
+  streamdata_.tail = (streamdata_.tail + bufferlength - length) % bufferlength;
+  return true;
+}
+
 int32_t Output::flush() {
   if (!socket_->is_valid()) return 0;
   if (0 == size()) return 0;
@@ -205,6 +233,39 @@ bool Output::write_bytes(const unsigned char *value, size_t size) {
   return write((const char *)value, size) == size;
 }
 
+bool Output::write_varuint32(uint32_t value) {
+  char buffer[NET_STREAM_VARINT32_SIZEMAX]{0};
+  uint32_t length = varint::encode32(value, buffer);
+  return write(buffer, length) == length;
+}
+
+bool Output::write_varint32(int32_t value) {
+  return write_varuint32(varint::zigzag_encode32(value));
+}
+
+bool Output::write_varuint64(uint64_t value) {
+  char buffer[NET_STREAM_VARINT64_SIZEMAX]{0};
+  uint32_t length = varint::encode64(value, buffer);
+  return write(buffer, length) == length;
+}
+
+bool Output::write_varint64(int64_t value) {
+  return write_varuint64(varint::zigzag_encode64(value));
+}
+
+bool Output::write_varuint32_array(const uint32_t *values, uint32_t count) {
+  //Encode in chunks, each chunk is one write.
+  char buffer[NET_STREAM_VARINT32_SIZEMAX * 64]{0};
+  uint32_t i = 0;
+  while (i < count) {
+    uint32_t length = 0;
+    for (uint32_t j = 0; j < 64 && i < count; ++j, ++i)
+      length += varint::encode32(values[i], buffer + length);
+    if (write(buffer, length) != length) return false;
+  }
+  return true;
+}
+
 int32_t Output::compressflush() {
   if (0 == compressor_.getsize()) return 0;
   uint32_t flushcount = 0;
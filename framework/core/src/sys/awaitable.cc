@@ -0,0 +1,19 @@
+#include "pf/sys/awaitable.h"
+
+namespace pf_sys {
+
+resumer_t &current_resumer() {
+  static thread_local resumer_t resumer;
+  return resumer;
+}
+
+ResumerGuard::ResumerGuard(const resumer_t &resumer) :
+  last_{current_resumer()} {
+  current_resumer() = resumer;
+}
+
+ResumerGuard::~ResumerGuard() {
+  current_resumer() = last_;
+}
+
+} //namespace pf_sys
@@ -0,0 +1,182 @@
+#include "pf/basic/time_manager.h"
+#include "pf/sys/thread.h"
+#include "pf/sys/awaitable.h"
+#include "pf/sys/executor.h"
+
+using namespace pf_sys;
+
+namespace {
+
+thread_local Executor *t_executor{nullptr};
+thread_local int32_t t_index{-1};
+
+} //namespace
+
+Executor::Executor(size_t count) :
+  next_deadline_{UINT64_MAX},
+  pending_{0},
+  sleepers_{0},
+  next_{0},
+  stop_{false} {
+  if (0 == count) count = 1;
+  for (size_t i = 0; i < count; ++i)
+    workers_.emplace_back(new worker_t);
+  for (size_t i = 0; i < count; ++i)
+    threads_.emplace_back([this, i]() { work(i); });
+}
+
+Executor::~Executor() {
+  stop();
+  for (std::thread &thread : threads_) {
+    if (thread.joinable()) thread.join();
+  }
+}
+
+void Executor::submit(const std::function<void()> &task, int32_t hint) {
+  size_t index{0};
+  if (hint >= 0) {
+    index = static_cast<size_t>(hint) % size();
+  } else if (current() >= 0) {
+    index = static_cast<size_t>(current());
+  } else {
+    index = next_++ % size();
+  }
+  push(index, std::function<void()>(task));
+}
+
+void Executor::every(uint32_t interval,
+                     const std::function<bool()> &function,
+                     int32_t hint) {
+  tick_t tick;
+  tick.deadline = now();
+  tick.interval = static_cast<uint64_t>(interval) * 1000000;
+  tick.hint = hint;
+  tick.function = function;
+  arm(std::move(tick));
+}
+
+void Executor::stop() {
+  {
+    std::unique_lock<std::mutex> autolock(mutex_);
+    stop_ = true;
+  }
+  condition_.notify_all();
+}
+
+int32_t Executor::current() const {
+  return this == t_executor ? t_index : -1;
+}
+
+void Executor::work(size_t index) {
+  t_executor = this;
+  t_index = static_cast<int32_t>(index);
+  thread::bind("executor" + std::to_string(index));
+  ThreadCollect collect;
+  //The awaitable created in task resume in this worker.
+  ResumerGuard guard([this, index](const std::function<void()> &function) {
+    submit(function, static_cast<int32_t>(index));
+  });
+  std::function<void()> task;
+  for (;;) {
+    auto time = now();
+    if (time >= next_deadline_) fire(time);
+    if (pop(index, task)) {
+      task();
+      task = nullptr;
+      continue;
+    }
+    std::unique_lock<std::mutex> autolock(mutex_);
+    if (stop_ && 0 == pending_) break;
+    //The push increase pending before check sleepers, so not lost wakeup.
+    ++sleepers_;
+    if (0 == pending_ && !stop_) {
+      uint64_t deadline = next_deadline_;
+      if (UINT64_MAX == deadline) {
+        condition_.wait(autolock);
+      } else {
+        std::chrono::steady_clock::time_point point{
+          std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+              std::chrono::nanoseconds(deadline))};
+        condition_.wait_until(autolock, point);
+      }
+    }
+    --sleepers_;
+  }
+}
+
+//The owner pop from back, steal the others from front.
+bool Executor::pop(size_t index, std::function<void()> &task) {
+  if (0 == pending_) return false;
+  {
+    auto &worker = *workers_[index];
+    std::unique_lock<std::mutex> autolock(worker.mutex);
+    if (!worker.tasks.empty()) {
+      task = std::move(worker.tasks.back());
+      worker.tasks.pop_back();
+      --pending_;
+      return true;
+    }
+  }
+  for (size_t i = 1; i < size(); ++i) {
+    auto &worker = *workers_[(index + i) % size()];
+    std::unique_lock<std::mutex> autolock(worker.mutex);
+    if (!worker.tasks.empty()) {
+      task = std::move(worker.tasks.front());
+      worker.tasks.pop_front();
+      --pending_;
+      return true;
+    }
+  }
+  return false;
+}
+
+void Executor::push(size_t index, std::function<void()> &&task) {
+  ++pending_;
+  {
+    auto &worker = *workers_[index];
+    std::unique_lock<std::mutex> autolock(worker.mutex);
+    worker.tasks.emplace_back(std::move(task));
+  }
+  if (sleepers_ > 0) {
+    std::unique_lock<std::mutex> autolock(mutex_);
+    condition_.notify_one();
+  }
+}
+
+//Submit the expired ticks, rearm after the function finished.
+void Executor::fire(uint64_t time) {
+  std::vector<tick_t> ticks;
+  {
+    std::unique_lock<std::mutex> autolock(mutex_);
+    while (!ticks_.empty() && ticks_.top().deadline <= time) {
+      ticks.push_back(ticks_.top());
+      ticks_.pop();
+    }
+    next_deadline_ = ticks_.empty() ? UINT64_MAX : ticks_.top().deadline;
+    if (stop_) return;
+  }
+  for (tick_t &tick : ticks) {
+    auto pointer = std::make_shared<tick_t>(std::move(tick));
+    submit([this, pointer]() {
+      auto start = now();
+      if (stop_ || !pointer->function()) return;
+      pointer->deadline = start + pointer->interval;
+      arm(std::move(*pointer));
+    }, pointer->hint);
+  }
+}
+
+void Executor::arm(tick_t &&tick) {
+  {
+    std::unique_lock<std::mutex> autolock(mutex_);
+    if (stop_) return;
+    if (tick.deadline < next_deadline_) next_deadline_ = tick.deadline;
+    ticks_.push(std::move(tick));
+    //Wake one to wait the new deadline.
+    if (sleepers_ > 0) condition_.notify_one();
+  }
+}
+
+uint64_t Executor::now() {
+  return pf_basic::TimeManager::get_nanotime();
+}
@@ -325,13 +325,23 @@ bool Base::merge(const char *filename) {
 
 //-- functions start
 
+//The lock and unlock read them every time, so from the config snapshot.
+static bool app_isstop() {
+  static const pf_basic::config::handle<int32_t> status{"app.status"};
+  return kAppStatusStop == status.get();
+}
+
+static bool lock_isskip() {
+  static const pf_basic::config::handle<int32_t> cmdmodel{"app.cmdmodel"};
+  return kCmdModelRecover == cmdmodel.get() || app_isstop();
+}
+
 void lock(mutex_t &mutex, int8_t type) {
-  if (GLOBALS["app.cmdmodel"] == kCmdModelRecover ||
-      GLOBALS["app.status"] == kAppStatusStop) return;
+  if (lock_isskip()) return;
   int32_t count = 0;
   int8_t flag{kFlagFree};
   while (!mutex.compare_exchange_weak(flag, type)) {
-    if (GLOBALS["app.status"] == kAppStatusStop) break;
+    if (app_isstop()) break;
     flag = kFlagFree; ++count;
     std::this_thread::sleep_for(std::chrono::milliseconds(0));
     if (count > 100) {
@@ -346,12 +356,11 @@ void lock(mutex_t &mutex, int8_t type) {
 }
 
 void unlock(mutex_t &mutex, int8_t type) {
-  if (GLOBALS["app.cmdmodel"] == kCmdModelRecover ||
-      GLOBALS["app.status"] == kAppStatusStop) return;
+  if (lock_isskip()) return;
   int8_t flag{type};
   int8_t count{0};
   while (!mutex.compare_exchange_weak(flag, kFlagFree)) {
-    if (GLOBALS["app.status"] == kAppStatusStop) break;
+    if (app_isstop()) break;
     //auto cur = flag;
     flag = type; ++count;
     std::this_thread::sleep_for(std::chrono::milliseconds(0));
@@ -193,6 +193,20 @@ uint64_t get_physicalmemory_usage(int32_t id) {
       result = pmc.WorkingSetSize;
     }
 #elif OS_UNIX /* }{ */
+#if defined(__linux__)
+  //Read the proc file is much cheaper than fork the ps command.
+  char filename[64] = {0};
+  snprintf(filename, sizeof(filename) - 1, "/proc/%d/statm", id);
+  FILE *fp = fopen(filename, "r");
+  if (fp) {
+    unsigned long size = 0;
+    unsigned long resident = 0;
+    if (2 == fscanf(fp, "%lu %lu", &size, &resident))
+      result = static_cast<uint64_t>(resident) * sysconf(_SC_PAGESIZE);
+    fclose(fp);
+    return result;
+  }
+#endif
   char temp[128] = {0};
   char command[128] = {0};
   snprintf(command, 
@@ -208,6 +222,47 @@ uint64_t get_physicalmemory_usage(int32_t id) {
   return result;
 }
 
+uint64_t get_cpu_time(int32_t id) {
+  uint64_t result = 0;
+#if OS_WIN /* { */
+  FILETIME creation_time;
+  FILETIME exit_time;
+  FILETIME kernel_time;
+  FILETIME user_time;
+  HANDLE hProcess = ::OpenProcess(PROCESS_ALL_ACCESS, FALSE, id);
+  if (::GetProcessTimes(hProcess, 
+                        &creation_time, 
+                        &exit_time, 
+                        &kernel_time, 
+                        &user_time)) {
+    result = (file_time_2_utc(&kernel_time) + file_time_2_utc(&user_time)) / 
+      10000;
+  }
+#elif defined(__linux__) /* }{ */
+  char filename[64] = {0};
+  snprintf(filename, sizeof(filename) - 1, "/proc/%d/stat", id);
+  FILE *fp = fopen(filename, "r");
+  if (is_null(fp)) return result;
+  char buffer[1024] = {0};
+  size_t length = fread(buffer, 1, sizeof(buffer) - 1, fp);
+  fclose(fp);
+  buffer[length] = '\0';
+  //The command name may have spaces, so start from the last ')'.
+  const char *position = strrchr(buffer, ')');
+  unsigned long utime = 0;
+  unsigned long stime = 0;
+  if (position && 
+      2 == sscanf(position + 1, 
+                  " %*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %lu %lu",
+                  &utime, 
+                  &stime)) {
+    result = static_cast<uint64_t>(utime + stime) * 1000 / 
+      sysconf(_SC_CLK_TCK);
+  }
+#endif /* } */
+  return result;
+}
+
 bool daemon() {
   bool result = false;
 #if OS_UNIX
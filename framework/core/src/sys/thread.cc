@@ -0,0 +1,150 @@
+#include "pf/basic/logger.h"
+#include "pf/basic/trace.h"
+#include "pf/sys/thread.h"
+#if OS_UNIX && defined(__linux__)
+#include <pthread.h>
+#include <sys/syscall.h>
+#ifndef MPOL_LOCAL
+#define MPOL_LOCAL 4
+#endif
+#define SYS_THREAD_AFFINITY 1
+#else
+#define SYS_THREAD_AFFINITY 0
+#endif
+
+namespace pf_sys {
+
+namespace thread {
+
+//The cpu list like "2,3" or "4-7,9".
+static bool parse_cpus(const std::string &cpus, std::vector<int32_t> &list) {
+  size_t position{0};
+  while (position < cpus.size()) {
+    auto stop = cpus.find(',', position);
+    if (std::string::npos == stop) stop = cpus.size();
+    auto item = cpus.substr(position, stop - position);
+    position = stop + 1;
+    if (item.empty()) continue;
+    const char *begin = item.c_str();
+    char *end{nullptr};
+    auto first = strtol(begin, &end, 10);
+    if (end == begin) return false;
+    auto last = first;
+    if ('-' == *end) {
+      begin = end + 1;
+      last = strtol(begin, &end, 10);
+      if (end == begin) return false;
+    }
+    if (*end != '\0' || first < 0 || last < first) return false;
+    for (auto cpu = first; cpu <= last; ++cpu)
+      list.push_back(static_cast<int32_t>(cpu));
+  }
+  return !list.empty();
+}
+
+bool set_affinity(const std::string &cpus) {
+  std::vector<int32_t> list;
+  if (!parse_cpus(cpus, list)) return false;
+#if SYS_THREAD_AFFINITY
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (int32_t cpu : list) {
+    if (cpu < CPU_SETSIZE) CPU_SET(cpu, &set);
+  }
+  return 0 == pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+  return false;
+#endif
+}
+
+bool set_numa_local() {
+#if SYS_THREAD_AFFINITY
+  //Not link the libnuma, the memory touch first in this thread from local node.
+  return 0 == syscall(SYS_set_mempolicy, MPOL_LOCAL, nullptr, 0);
+#else
+  return false;
+#endif
+}
+
+#if SYS_THREAD_AFFINITY
+static std::atomic<int32_t> g_stack_fd{-1};
+static std::atomic<bool> g_stack_done{false};
+
+static void stack_handler(int32_t) {
+  void *frames[64];
+  auto count = backtrace(frames, 64);
+  auto fd = g_stack_fd.load();
+  if (fd >= 0) backtrace_symbols_fd(frames, count, fd);
+  g_stack_done = true;
+}
+#endif
+
+bool dump_stack(std::thread::native_handle_type handle, 
+                int32_t fd, 
+                uint32_t timeout) {
+#if SYS_THREAD_AFFINITY
+  static std::mutex mutex; //One thread each time.
+  std::unique_lock<std::mutex> autolock(mutex);
+  static bool installed{false};
+  if (!installed) {
+    void *frames[1];
+    backtrace(frames, 1); //Load the unwinder before the signal.
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = stack_handler;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESTART;
+    if (sigaction(SIGUSR2, &action, nullptr) != 0) return false;
+    installed = true;
+  }
+  g_stack_fd = fd;
+  g_stack_done = false;
+  if (pthread_kill(handle, SIGUSR2) != 0) return false;
+  for (uint32_t i = 0; i < timeout && !g_stack_done; ++i)
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  g_stack_fd = -1;
+  return g_stack_done;
+#else
+  return false;
+#endif
+}
+
+bool bind(const std::string &name) {
+  if (name.empty()) return true;
+  pf_basic::trace::set_thread_name(name);
+  //The committed values(the threads not read the GLOBALS).
+  using pf_basic::config::find;
+  pf_basic::config::value_t value;
+  std::string key{"default.engine.affinity."};
+  std::string cpus;
+  if (find(key + name, value)) cpus = value.data;
+  if (cpus.empty()) {
+    //The "executor" for all "executor0", "executor1" ...
+    auto position = name.find_last_not_of("0123456789");
+    if (position != std::string::npos && position + 1 < name.size() &&
+        find(key + name.substr(0, position + 1), value))
+      cpus = value.data;
+  }
+  bool result = true;
+  if (!cpus.empty() && !set_affinity(cpus)) {
+    SLOW_ERRORLOG(SYS_MODULENAME,
+                  "[sys] thread::bind(%s) affinity %s failed",
+                  name.c_str(),
+                  cpus.c_str());
+    result = false;
+  }
+  auto numa = find("default.engine.numa.policy", value) && 
+              "local" == value.data;
+  if (numa && !set_numa_local()) {
+    SLOW_ERRORLOG(SYS_MODULENAME,
+                  "[sys] thread::bind(%s) numa local failed, errno: %d",
+                  name.c_str(),
+                  errno);
+    result = false;
+  }
+  return result;
+}
+
+} //namespace thread
+
+} //namespace pf_sys
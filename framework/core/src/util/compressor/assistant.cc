@@ -17,10 +17,10 @@ Assistant::~Assistant() {
 
 void Assistant::enable(bool _enable, uint64_t threadid) {
   if (true == _enable) {
-    if (!UTIL_COMPRESSOR_MINIMANAGER_POINTER ||
-        nullptr == UTIL_COMPRESSOR_MINIMANAGER_POINTER->alloc(threadid)) {
-      isenable_ = false;
-    }
+    workmemory_ = UTIL_COMPRESSOR_MINIMANAGER_POINTER ?
+                  UTIL_COMPRESSOR_MINIMANAGER_POINTER->alloc(threadid) :
+                  nullptr;
+    if (is_null(workmemory_)) _enable = false;
   }
   isenable_ = _enable;
 }
@@ -52,9 +52,10 @@ void MiniManager::destory() {
 void *MiniManager::alloc(uint64_t threadid) {
   std::unique_lock<std::mutex> autolock(mutex_);
   for (uint16_t i = 0; i < UTIL_COMPRESSOR_MINI_MANAGER_THREAD_SIZEMAX; ++i) {
-    if (workmemory_[i].threadid == threadid) return workmemory_[i].pointer;
+    if (workmemory_[i].pointer && workmemory_[i].threadid == threadid)
+      return workmemory_[i].pointer;
   }
-  if (workmemory_size_ > UTIL_COMPRESSOR_MINI_MANAGER_THREAD_SIZEMAX) 
+  if (workmemory_size_ >= UTIL_COMPRESSOR_MINI_MANAGER_THREAD_SIZEMAX) 
     return nullptr;
   lzo_align_t* workmemory = 
     new lzo_align_t[UTIL_COMPRESSOR_MINI_MANAGER_WORK_MEMORY_SIZE];
@@ -69,8 +70,9 @@ bool MiniManager::compress(const unsigned char *in,
                            unsigned char *out,
                            uint32_t &outsize,
                            void *workmemory) {
-  int32_t result = 
-    lzo1x_1_compress(in, insize, out, (lzo_uint *)&outsize, workmemory);
+  lzo_uint size{0}; //The lzo_uint is 64 bits on 64 bits system.
+  int32_t result = lzo1x_1_compress(in, insize, out, &size, workmemory);
+  outsize = static_cast<uint32_t>(size);
   if (result != LZO_E_OK || outsize + 2 >= insize) return false;
   return true;
 }
@@ -79,7 +81,8 @@ int32_t MiniManager::decompress(const unsigned char *in,
                                 uint32_t insize,
                                 unsigned char *out,
                                 uint32_t &outsize) {
-  int32_t result = 
-    lzo1x_decompress(in, insize, out, (lzo_uint *)&outsize, nullptr);
+  lzo_uint size{outsize};
+  int32_t result = lzo1x_decompress(in, insize, out, &size, nullptr);
+  outsize = static_cast<uint32_t>(size);
   return result;
 }
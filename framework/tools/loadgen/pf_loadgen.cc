@@ -0,0 +1,402 @@
+/**
+ * PLAIN FRAMEWORK ( https://github.com/viticm/plainframework )
+ * $Id pf_loadgen.cc
+ * @link https://github.com/viticm/plainframework for the canonical source repository
+ * @copyright Copyright (c) 2014- viticm( viticm.ti@gmail.com )
+ * @license
+ * @user viticm<viticm.ti@gmail.com>
+ * @date 2019/04/06 15:02
+ * @uses The net load generator, open connections with the Connector, drive
+ *       the probe packets with a size mix at a target rate and report the
+ *       throughput, round trip time and the server cpu.
+ *       默认在本进程的回环地址上启动一个Listener作为服务端（--local=0 时
+ *       连接外部服务，服务端需要注册同样的探测消息）。
+ *       usage: pf_loadgen --connections=100 --rate=10000 --duration=10
+ *                         --mix=64:70,512:25,4096:5 [--port=17100]
+ *                         [--host=127.0.0.1] [--local=1] [--encrypt=]
+ *                         [--compact=0] [--frame=1] [--log=0]
+ */
+#include "pf/basic/time_manager.h"
+#include "pf/basic/logger.h"
+#include "pf/basic/histogram.h"
+#include "pf/basic/string.h"
+#include "pf/net/connection/basic.h"
+#include "pf/net/connection/manager/listener.h"
+#include "pf/net/connection/manager/connector.h"
+#include "pf/net/packet/handshake.h"
+#include "pf/net/packet/factorymanager.h"
+#include "pf/net/metrics.h"
+#include "pf/sys/process.h"
+
+#define LOADGEN_PACKET_PING (NET_PACKET_ID_NORMAL_END)
+#define LOADGEN_PACKET_PONG (NET_PACKET_ID_NORMAL_END - 1)
+#define LOADGEN_PAYLOAD_MAX (64 * 1024)
+
+using namespace pf_net;
+
+namespace {
+
+struct options_struct {
+  uint32_t connections;
+  uint32_t rate;      //Packets per second of all connections, 0 is no limit.
+  uint32_t duration;  //Seconds.
+  std::string mix;    //size:weight,...
+  std::string host;
+  uint16_t port;
+  bool local;         //Start the listener in this process.
+  std::string encrypt;
+  bool compact;
+  uint32_t frame;     //The tick sleep(ms).
+  bool log;
+  options_struct() :
+    connections{100},
+    rate{10000},
+    duration{10},
+    mix{"64:1"},
+    host{"127.0.0.1"},
+    port{17100},
+    local{true},
+    encrypt{""},
+    compact{false},
+    frame{1},
+    log{false} {};
+};
+
+using options_t = options_struct;
+
+struct mix_struct {
+  uint32_t size;
+  uint32_t weight;
+};
+
+using mix_t = mix_struct;
+
+//The client side result, only the client net thread write.
+struct result_struct {
+  pf_basic::Histogram rtt;  //ns
+  std::atomic<uint64_t> sent;
+  std::atomic<uint64_t> received;
+  std::atomic<uint64_t> bytes;
+  result_struct() : sent{0}, received{0}, bytes{0} {};
+};
+
+using result_t = result_struct;
+
+result_t g_result;
+
+//The ping and pong packet, the server send back the ping as pong.
+class Probe : public packet::Interface {
+
+ public:
+   Probe(uint16_t id) : id_{id}, time_{0} {};
+   virtual ~Probe() {};
+
+ public:
+   virtual bool read(stream::Input &istream) {
+     uint32_t size{0};
+     istream >> time_ >> size;
+     if (size > LOADGEN_PAYLOAD_MAX) return false;
+     payload_.resize(size);
+     return 0 == size || istream.read(&payload_[0], size) == size;
+   };
+   virtual bool write(stream::Output &ostream) {
+     auto size = static_cast<uint32_t>(payload_.size());
+     ostream << time_ << size;
+     return 0 == size || ostream.write(payload_.data(), size) == size;
+   };
+   virtual uint32_t execute(connection::Basic *connection) {
+     if (LOADGEN_PACKET_PING == id_) {
+       Probe pong(LOADGEN_PACKET_PONG);
+       pong.time_ = time_;
+       pong.payload_.swap(payload_);
+       return connection->send(&pong) ?
+              kPacketExecuteStatusContinue : kPacketExecuteStatusError;
+     }
+     g_result.rtt.record(metrics::now() - time_);
+     g_result.received.store(
+         g_result.received.load(std::memory_order_relaxed) + 1,
+         std::memory_order_relaxed);
+     return kPacketExecuteStatusContinue;
+   };
+   virtual uint16_t get_id() const { return id_; };
+   virtual uint32_t size() const {
+     return static_cast<uint32_t>(
+         sizeof(time_) + sizeof(uint32_t) + payload_.size());
+   };
+
+ public:
+   void set(uint64_t time, uint32_t size) {
+     time_ = time;
+     payload_.assign(size, 'x');
+   };
+
+ private:
+   uint16_t id_;
+   uint64_t time_;
+   std::string payload_;
+
+};
+
+class ProbeFactory : public packet::Factory {
+
+ public:
+   ProbeFactory(uint16_t id) : id_{id} {};
+   virtual ~ProbeFactory() {};
+
+ public:
+   virtual packet::Interface *packet_create() { return new Probe(id_); };
+   virtual uint16_t packet_id() const { return id_; };
+   virtual uint32_t packet_max_size() const {
+     return sizeof(uint64_t) + sizeof(uint32_t) + LOADGEN_PAYLOAD_MAX;
+   };
+
+ private:
+   uint16_t id_;
+
+};
+
+bool __stdcall register_factories() {
+  NET_PACKET_FACTORYMANAGER_POINTER->add_factory(
+      new ProbeFactory(LOADGEN_PACKET_PING));
+  NET_PACKET_FACTORYMANAGER_POINTER->add_factory(
+      new ProbeFactory(LOADGEN_PACKET_PONG));
+  return true;
+}
+
+bool parse(int argc, char *argv[], options_t &options) {
+  for (int i = 1; i < argc; ++i) {
+    std::string arg{argv[i]};
+    auto position = arg.find('=');
+    if (0 != arg.find("--") || std::string::npos == position) return false;
+    auto name = arg.substr(2, position - 2);
+    auto value = arg.substr(position + 1);
+    if ("connections" == name) {
+      options.connections = static_cast<uint32_t>(atoi(value.c_str()));
+    } else if ("rate" == name) {
+      options.rate = static_cast<uint32_t>(atoi(value.c_str()));
+    } else if ("duration" == name) {
+      options.duration = static_cast<uint32_t>(atoi(value.c_str()));
+    } else if ("mix" == name) {
+      options.mix = value;
+    } else if ("host" == name) {
+      options.host = value;
+    } else if ("port" == name) {
+      options.port = static_cast<uint16_t>(atoi(value.c_str()));
+    } else if ("local" == name) {
+      options.local = atoi(value.c_str()) != 0;
+    } else if ("encrypt" == name) {
+      options.encrypt = value;
+    } else if ("compact" == name) {
+      options.compact = atoi(value.c_str()) != 0;
+    } else if ("frame" == name) {
+      options.frame = static_cast<uint32_t>(atoi(value.c_str()));
+    } else if ("log" == name) {
+      options.log = atoi(value.c_str()) != 0;
+    } else {
+      return false;
+    }
+  }
+  return options.connections > 0 && options.duration > 0;
+}
+
+bool parse_mix(const std::string &str, std::vector<mix_t> &mixes) {
+  std::vector<std::string> array;
+  pf_basic::string::explode(str.c_str(), array, ",", true, true);
+  for (auto &item : array) {
+    std::vector<std::string> values;
+    pf_basic::string::explode(item.c_str(), values, ":", true, true);
+    if (values.empty()) return false;
+    mix_t mix;
+    mix.size = static_cast<uint32_t>(atoi(values[0].c_str()));
+    mix.weight = values.size() > 1 ?
+                 static_cast<uint32_t>(atoi(values[1].c_str())) : 1;
+    if (mix.size > LOADGEN_PAYLOAD_MAX || 0 == mix.weight) return false;
+    mixes.push_back(mix);
+  }
+  return !mixes.empty();
+}
+
+//The thread cpu time(ns).
+uint64_t thread_cpu_time() {
+#if OS_UNIX
+  struct timespec value;
+  if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &value) != 0) return 0;
+  return static_cast<uint64_t>(value.tv_sec) * 1000000000ULL + value.tv_nsec;
+#else
+  return 0;
+#endif
+}
+
+void net_loop(connection::manager::Basic *net,
+              std::atomic<bool> &stop,
+              uint32_t frame,
+              std::atomic<uint64_t> *cpu_time) {
+  while (!stop) {
+    net->tick();
+    if (frame > 0) std::this_thread::sleep_for(std::chrono::milliseconds(frame));
+  }
+  if (cpu_time) *cpu_time = thread_cpu_time();
+}
+
+} //namespace
+
+int32_t main(int32_t argc, char *argv[]) {
+  using namespace pf_net::connection::manager;
+  options_t options;
+  std::vector<mix_t> mixes;
+  if (!parse(argc, argv, options) || !parse_mix(options.mix, mixes)) {
+    printf("usage: %s --connections=100 --rate=10000 --duration=10"
+           " --mix=64:70,512:25,4096:5 [--port=17100] [--host=127.0.0.1]"
+           " [--local=1] [--encrypt=] [--compact=0] [--frame=1] [--log=0]\n",
+           argv[0]);
+    return 1;
+  }
+  GLOBALS["log.print"] = options.log;
+  GLOBALS["log.active"] = options.log;
+  pf_basic::config::commit();
+  {
+    auto time_manager = new pf_basic::TimeManager();
+    unique_move(pf_basic::TimeManager, time_manager, g_time_manager);
+    if (!g_time_manager->init()) return 1;
+    auto logger = new pf_basic::Logger();
+    unique_move(pf_basic::Logger, logger, g_logger);
+  }
+  {
+    using FactoryManager = pf_net::packet::FactoryManager;
+    std::unique_ptr<FactoryManager> pointer(new FactoryManager());
+    g_packetfactory_manager = std::move(pointer);
+    NET_PACKET_FACTORYMANAGER_POINTER->set_function_register_factories(
+        register_factories);
+    if (!NET_PACKET_FACTORYMANAGER_POINTER->init()) return 1;
+  }
+  std::atomic<bool> stop{false};
+  std::atomic<uint64_t> server_cpu{0};
+  std::unique_ptr<Listener> server;
+  std::thread server_thread;
+  if (options.local) {
+    server.reset(new Listener());
+    auto conn_max = static_cast<uint16_t>(options.connections + 16);
+    if (!server->init(conn_max, options.port, options.host.c_str())) {
+      printf("listen at %s:%d failed\n", options.host.c_str(), options.port);
+      return 1;
+    }
+    server->set_onestep_accept(-1);
+    if (options.encrypt != "") server->set_safe_encrypt_str(options.encrypt);
+    server->set_compact(options.compact);
+    server_thread = std::thread(
+        net_loop, server.get(), std::ref(stop), options.frame, &server_cpu);
+  }
+
+  //Connect and handshake.
+  Connector client;
+  if (!client.init(static_cast<uint16_t>(options.connections + 1))) return 1;
+  std::vector<connection::Basic *> connections;
+  auto connect_begin = metrics::now();
+  for (uint32_t i = 0; i < options.connections; ++i) {
+    auto connection = client.connect(options.host.c_str(), options.port);
+    if (is_null(connection)) continue;
+    if (options.encrypt != "") {
+      packet::Handshake handshake;
+      handshake.set_encrypt_key(options.encrypt);
+      if (options.compact)
+        handshake.set_flags(packet::Handshake::kFlagCompact);
+      connection->send(&handshake);
+      if (options.compact)
+        connection->set_protocol(Interface::protocol_compact());
+    }
+    connections.push_back(connection);
+  }
+  auto connect_time = metrics::now() - connect_begin;
+  if (connections.empty()) {
+    printf("no connection to %s:%d\n", options.host.c_str(), options.port);
+    stop = true;
+    if (server_thread.joinable()) server_thread.join();
+    return 1;
+  }
+
+  //Drive the packets in the client net thread(the probe sender).
+  std::atomic<bool> client_stop{false};
+  std::thread client_thread([&]() {
+    std::mt19937 random(20190406);
+    uint32_t total_weight{0};
+    for (auto &mix : mixes) total_weight += mix.weight;
+    uint64_t begin = metrics::now();
+    uint64_t end = begin + options.duration * 1000000000ULL;
+    uint64_t sent{0};
+    size_t index{0};
+    Probe ping(LOADGEN_PACKET_PING);
+    while (!client_stop) {
+      auto now = metrics::now();
+      if (now < end) {
+        uint64_t expect = 0 == options.rate ?
+          sent + connections.size() :
+          (now - begin) * options.rate / 1000000000ULL;
+        for (; sent < expect; ++sent) {
+          auto value = random() % total_weight;
+          uint32_t size{0};
+          for (auto &mix : mixes) {
+            if (value < mix.weight) {
+              size = mix.size;
+              break;
+            }
+            value -= mix.weight;
+          }
+          auto connection = connections[index++ % connections.size()];
+          if (connection->is_disconnect()) continue;
+          ping.set(metrics::now(), size);
+          if (!connection->send(&ping)) continue;
+          g_result.sent.store(sent + 1, std::memory_order_relaxed);
+          g_result.bytes.store(
+              g_result.bytes.load(std::memory_order_relaxed) + ping.size(),
+              std::memory_order_relaxed);
+        }
+      }
+      client.tick();
+      if (options.frame > 0)
+        std::this_thread::sleep_for(std::chrono::milliseconds(options.frame));
+    }
+  });
+  auto begin = metrics::now();
+  auto process_cpu = pf_sys::process::get_cpu_time(pf_sys::process::getid());
+  std::this_thread::sleep_for(std::chrono::seconds(options.duration));
+  //Wait the last responses.
+  std::this_thread::sleep_for(std::chrono::milliseconds(500));
+  client_stop = true;
+  client_thread.join();
+  auto elapsed = metrics::now() - begin;
+  process_cpu =
+    pf_sys::process::get_cpu_time(pf_sys::process::getid()) - process_cpu;
+  stop = true;
+  if (server_thread.joinable()) server_thread.join();
+
+  //Report.
+  uint32_t alive{0};
+  for (auto connection : connections)
+    if (!connection->is_disconnect()) ++alive;
+  auto &rtt = g_result.rtt;
+  double seconds = options.duration;
+  printf("connections: %u/%u(alive %u) connect: %.3fs\n",
+         static_cast<uint32_t>(connections.size()),
+         options.connections,
+         alive,
+         connect_time / 1e9);
+  printf("sent: %" PRIu64 " received: %" PRIu64 " lost: %" PRId64 "\n",
+         g_result.sent.load(),
+         g_result.received.load(),
+         static_cast<int64_t>(g_result.sent.load() - g_result.received.load()));
+  printf("throughput: %.1f packets/s %.3f MB/s\n",
+         g_result.received.load() / seconds,
+         g_result.bytes.load() / seconds / (1024 * 1024));
+  printf("rtt(us): p50 %.1f p99 %.1f p999 %.1f max %.1f\n",
+         rtt.percentile(0.5) / 1e3,
+         rtt.percentile(0.99) / 1e3,
+         rtt.percentile(0.999) / 1e3,
+         rtt.maximum() / 1e3);
+  if (options.local) {
+    printf("server cpu: %.1f%% process cpu: %.1f%%\n",
+           server_cpu.load() / (elapsed / 100.0),
+           process_cpu * 1e6 / (elapsed / 100.0));
+  }
+  client.destroy();
+  return 0;
+}
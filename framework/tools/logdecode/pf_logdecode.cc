@@ -0,0 +1,29 @@
+/**
+ * PLAIN FRAMEWORK ( https://github.com/viticm/plainframework )
+ * $Id pf_logdecode.cc
+ * @link https://github.com/viticm/plainframework for the canonical source repository
+ * @copyright Copyright (c) 2014- viticm( viticm.ti@gmail.com )
+ * @license
+ * @user viticm<viticm.ti@gmail.com>
+ * @date 2019/04/20 10:36
+ * @uses The binary log decoder, format the .blog files(GLOBALS["log.binary"]
+ *       with BINARY_LOG) to the text lines like the .log files, the
+ *       archives(.blog.gz) too when built with the zlib.
+ *       usage: pf_logdecode file.blog [file.blog.gz ...] > file.log
+ */
+#include "pf/basic/logger.h"
+
+int32_t main(int32_t argc, char *argv[]) {
+  if (argc < 2) {
+    fprintf(stderr, "usage: %s file.blog [file.blog ...]" LF, argv[0]);
+    return 1;
+  }
+  int32_t result{0};
+  for (int32_t i = 1; i < argc; ++i) {
+    if (!pf_basic::Logger::decode_binary(argv[i], stdout)) {
+      fprintf(stderr, "%s: decode failed" LF, argv[i]);
+      result = 1;
+    }
+  }
+  return result;
+}
@@ -0,0 +1,631 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+PLAIN FRAMEWORK ( https://github.com/viticm/plainframework )
+$Id packetgen.py
+@link https://github.com/viticm/plainframework for the canonical source repository
+@copyright Copyright (c) 2014- viticm( viticm.ti@gmail.com )
+@license
+@user viticm<viticm.ti@gmail.com>
+@date 2019/03/02 10:21
+@uses The packet schema compiler, generate packet classes, factories and
+      the register function from a .pkt file.
+
+Schema syntax(one statement each line, `//` or `#` for comments):
+
+  namespace game::packet;
+
+  packet LoginRequest = 1001 {
+    pod {                    // Fixed layout, one bounds check and one memcpy.
+      int32 level;
+      uint16 zone;
+      float x;
+    }
+    string account 32;       // uint32 length + bytes, at most 32 bytes.
+    bytes token 64;          // uint32 length + raw bytes, at most 64 bytes.
+    array<uint32> items 16;  // uint32 count + POD block, at most 16 items.
+    uint64 guid;             // Plain scalar, one write call.
+  }
+
+  packet MapChunk = 1002 lane 2 {   // Send by the lower priority lane 2.
+    bytes data 4096;
+  }
+
+Usage:
+  packetgen.py --output <dir> [--include-prefix <prefix>] file.pkt ...
+
+For each file `name.pkt`, write `name.h` and `name.cc` into the output dir,
+the register function is `bool <name>_register_factories()`.
+
+When the stream is compact(the connection use the compact protocol), the
+integer fields(16 bits and more), the lengths and the counts outside the pod
+block are varint(signed use zigzag), see compact_size() for the size. The
+read() return false if a varint is malformed or out of the field range.
+"""
+
+import argparse
+import os
+import re
+import sys
+
+# type: (ctype, size, stream suffix, compact varint suffix, compact size max)
+SCALARS = {
+  'bool': ('bool', 1, 'int8', None, 1),
+  'int8': ('int8_t', 1, 'int8', None, 1),
+  'uint8': ('uint8_t', 1, 'uint8', None, 1),
+  'int16': ('int16_t', 2, 'int16', 'varint32', 3),
+  'uint16': ('uint16_t', 2, 'uint16', 'varuint32', 3),
+  'int32': ('int32_t', 4, 'int32', 'varint32', 5),
+  'uint32': ('uint32_t', 4, 'uint32', 'varuint32', 5),
+  'int64': ('int64_t', 8, 'int64', 'varint64', 10),
+  'uint64': ('uint64_t', 8, 'uint64', 'varuint64', 10),
+  'float': ('float', 4, 'float', None, 4),
+  'double': ('double', 8, 'double', None, 8),
+}
+
+VARINT32_SIZEMAX = 5 # NET_STREAM_VARINT32_SIZEMAX
+
+LANE_MAX = 4 # NET_CONNECTION_LANE_MAX
+
+IDENT = r'[A-Za-z_][A-Za-z0-9_]*'
+RE_NAMESPACE = re.compile(r'^namespace\s+(%s(?:::%s)*)\s*;$' % (IDENT, IDENT))
+RE_PACKET = re.compile(r'^packet\s+(%s)\s*=\s*(\d+|0x[0-9a-fA-F]+)'
+                       r'(?:\s+lane\s+(\d+))?\s*\{$' % IDENT)
+RE_POD = re.compile(r'^pod\s*\{$')
+RE_SCALAR = re.compile(r'^(%s)\s+(%s)\s*;$' % (IDENT, IDENT))
+RE_SIZED = re.compile(r'^(string|bytes)\s+(%s)\s+(\d+)\s*;$' % IDENT)
+RE_ARRAY = re.compile(r'^array\s*<\s*(%s)\s*>\s+(%s)\s+(\d+)\s*;$'
+                      % (IDENT, IDENT))
+
+
+class SchemaError(Exception):
+  pass
+
+
+class Field(object):
+
+  def __init__(self, kind, name, type_name=None, capacity=0, pod=False):
+    self.kind = kind           # scalar, string, bytes, array
+    self.name = name
+    self.type_name = type_name
+    self.capacity = capacity
+    self.pod = pod
+
+  def ctype(self):
+    return SCALARS[self.type_name][0]
+
+  def csize(self):
+    return SCALARS[self.type_name][1]
+
+  def varint(self):
+    return SCALARS[self.type_name][3]
+
+  def compact_csize(self):
+    return SCALARS[self.type_name][4]
+
+
+class Packet(object):
+
+  def __init__(self, name, packet_id, lane=0):
+    self.name = name
+    self.packet_id = packet_id
+    self.lane = lane
+    self.pod_fields = []
+    self.fields = []
+
+  def max_size(self):
+    result = sum(field.csize() for field in self.pod_fields)
+    compact = result
+    for field in self.fields:
+      if 'scalar' == field.kind:
+        result += field.csize()
+        compact += field.compact_csize()
+      elif field.kind in ('string', 'bytes'):
+        result += 4 + field.capacity
+        compact += VARINT32_SIZEMAX + field.capacity
+      elif 'array' == field.kind:
+        result += 4 + field.capacity * field.csize()
+        compact += VARINT32_SIZEMAX + field.capacity * field.compact_csize()
+    return result if result > compact else compact
+
+
+def strip_comment(line):
+  for mark in ('//', '#'):
+    position = line.find(mark)
+    if position >= 0:
+      line = line[:position]
+  return line.strip()
+
+
+def parse(path):
+  namespace = []
+  packets = []
+  current = None
+  in_pod = False
+  names = set()
+  with open(path, 'r') as handle:
+    for number, raw in enumerate(handle, 1):
+      line = strip_comment(raw)
+      if not line:
+        continue
+      where = '%s:%d' % (path, number)
+
+      def field_name(name):
+        if name in names:
+          raise SchemaError('%s: repeat field name "%s"' % (where, name))
+        names.add(name)
+        return name
+
+      match = RE_NAMESPACE.match(line)
+      if match and current is None:
+        namespace = match.group(1).split('::')
+        continue
+      match = RE_PACKET.match(line)
+      if match and current is None:
+        current = Packet(match.group(1), int(match.group(2), 0),
+                         int(match.group(3) or 0))
+        if current.packet_id > 0xffff:
+          raise SchemaError('%s: packet id out of range' % where)
+        if current.lane >= LANE_MAX:
+          raise SchemaError('%s: packet lane out of range' % where)
+        names = set()
+        continue
+      if current is None:
+        raise SchemaError('%s: unexpected "%s"' % (where, line))
+      if '}' == line:
+        if in_pod:
+          in_pod = False
+        else:
+          packets.append(current)
+          current = None
+        continue
+      if RE_POD.match(line):
+        if in_pod or current.pod_fields:
+          raise SchemaError('%s: only one pod block each packet' % where)
+        in_pod = True
+        continue
+      match = RE_SCALAR.match(line)
+      if match and match.group(1) in SCALARS:
+        field = Field('scalar', field_name(match.group(2)), match.group(1),
+                      pod=in_pod)
+        (current.pod_fields if in_pod else current.fields).append(field)
+        continue
+      if in_pod:
+        raise SchemaError('%s: pod block only accept scalar fields' % where)
+      match = RE_SIZED.match(line)
+      if match:
+        current.fields.append(Field(match.group(1),
+                                    field_name(match.group(2)),
+                                    capacity=int(match.group(3))))
+        continue
+      match = RE_ARRAY.match(line)
+      if match and match.group(1) in SCALARS:
+        current.fields.append(Field('array',
+                                    field_name(match.group(2)),
+                                    match.group(1),
+                                    capacity=int(match.group(3))))
+        continue
+      raise SchemaError('%s: can not parse "%s"' % (where, line))
+  if current is not None or in_pod:
+    raise SchemaError('%s: unexpected end of file' % path)
+  ids = {}
+  for packet in packets:
+    if packet.packet_id in ids:
+      raise SchemaError('%s: repeat packet id %d(%s, %s)'
+                        % (path, packet.packet_id,
+                           ids[packet.packet_id], packet.name))
+    ids[packet.packet_id] = packet.name
+  return namespace, packets
+
+
+def header_comment(filename, uses):
+  return ('/**\n'
+          ' * PLAIN FRAMEWORK ( https://github.com/viticm/plainframework )\n'
+          ' * $Id %s\n'
+          ' * @uses %s\n'
+          ' * @note Generated by packetgen.py, do not edit.\n'
+          ' */\n') % (filename, uses)
+
+
+def open_namespace(namespace):
+  return ''.join('namespace %s {\n\n' % name for name in namespace)
+
+
+def close_namespace(namespace):
+  return ''.join('} //namespace %s\n\n' % name for name in reversed(namespace))
+
+
+def generate_header(base, namespace, packets):
+  guard = re.sub(r'[^A-Za-z0-9]', '_', base).upper() + '_PACKETS_H_'
+  out = [header_comment(base + '.h', 'The packets of %s.pkt.' % base)]
+  out.append('#ifndef %s\n#define %s\n\n' % (guard, guard))
+  out.append('#include "pf/basic/string.h"\n'
+             '#include "pf/net/packet/interface.h"\n'
+             '#include "pf/net/packet/factory.h"\n\n')
+  out.append(open_namespace(namespace))
+  for packet in packets:
+    out.append(generate_class(packet))
+  out.append('//Add all the factories of %s.pkt, call it in the function\n'
+             '//register by FactoryManager::set_function_register_factories.\n'
+             'bool %s_register_factories();\n\n' % (base, base))
+  out.append(close_namespace(namespace))
+  out.append('#endif //%s\n' % guard)
+  return ''.join(out)
+
+
+def generate_class(packet):
+  name = packet.name
+  out = []
+  out.append('class %s : public pf_net::packet::Interface {\n\n' % name)
+  out.append(' public:\n   enum { kId = %d, kMaxSize = %d, };\n\n'
+             % (packet.packet_id, packet.max_size()))
+  out.append(' public:\n   %s();\n   virtual ~%s() {}\n\n' % (name, name))
+  out.append(' public:\n'
+             '   virtual void clear();\n'
+             '   virtual bool read(pf_net::stream::Input &);\n'
+             '   virtual bool write(pf_net::stream::Output &);\n'
+             '   virtual uint16_t get_id() const { return kId; };\n'
+             '   virtual uint32_t size() const;\n'
+             '   virtual uint32_t compact_size() const;\n\n')
+  out.append(' public:\n')
+  for field in packet.pod_fields:
+    out.append('   %s get_%s() const { return pod_.%s; };\n'
+               % (field.ctype(), field.name, field.name))
+    out.append('   void set_%s(%s value) { pod_.%s = value; };\n'
+               % (field.name, field.ctype(), field.name))
+  for field in packet.fields:
+    if 'scalar' == field.kind:
+      out.append('   %s get_%s() const { return %s_; };\n'
+                 % (field.ctype(), field.name, field.name))
+      out.append('   void set_%s(%s value) { %s_ = value; };\n'
+                 % (field.name, field.ctype(), field.name))
+    elif 'string' == field.kind:
+      out.append('   const char *get_%s() const { return %s_; };\n'
+                 % (field.name, field.name))
+      out.append('   void set_%s(const char *value) {\n'
+                 '     pf_basic::string::safecopy(%s_, value, sizeof(%s_));\n'
+                 '   };\n' % (field.name, field.name, field.name))
+    elif 'bytes' == field.kind:
+      out.append('   const unsigned char *get_%s() const { return %s_; };\n'
+                 % (field.name, field.name))
+      out.append('   uint32_t get_%s_size() const { return %s_size_; };\n'
+                 % (field.name, field.name))
+      out.append('   bool set_%s(const unsigned char *value, uint32_t size);\n'
+                 % field.name)
+    elif 'array' == field.kind:
+      out.append('   const %s *get_%s() const { return %s_; };\n'
+                 % (field.ctype(), field.name, field.name))
+      out.append('   uint32_t get_%s_count() const { return %s_count_; };\n'
+                 % (field.name, field.name))
+      out.append('   bool set_%s(const %s *values, uint32_t count);\n'
+                 % (field.name, field.ctype()))
+  out.append('\n private:\n')
+  if packet.pod_fields:
+    out.append('#pragma pack(push, 1)\n   struct pod_t {\n')
+    for field in packet.pod_fields:
+      out.append('     %s %s;\n' % (field.ctype(), field.name))
+    out.append('   };\n#pragma pack(pop)\n   pod_t pod_;\n')
+  for field in packet.fields:
+    if 'scalar' == field.kind:
+      out.append('   %s %s_;\n' % (field.ctype(), field.name))
+    elif 'string' == field.kind:
+      out.append('   char %s_[%d];\n' % (field.name, field.capacity + 1))
+    elif 'bytes' == field.kind:
+      out.append('   unsigned char %s_[%d];\n' % (field.name, field.capacity))
+      out.append('   uint32_t %s_size_;\n' % field.name)
+    elif 'array' == field.kind:
+      out.append('   %s %s_[%d];\n'
+                 % (field.ctype(), field.name, field.capacity))
+      out.append('   uint32_t %s_count_;\n' % field.name)
+  out.append('\n};\n\n')
+  out.append('class %sFactory : public pf_net::packet::Factory {\n\n' % name)
+  out.append(' public:\n'
+             '   %sFactory() {}\n'
+             '   virtual ~%sFactory() {}\n\n' % (name, name))
+  out.append(' public:\n'
+             '   virtual pf_net::packet::Interface *packet_create() {\n'
+             '     return new %s();\n'
+             '   };\n'
+             '   virtual uint16_t packet_id() const { return %s::kId; };\n'
+             '   virtual uint32_t packet_max_size() const {\n'
+             '     return %s::kMaxSize;\n'
+             '   };\n' % (name, name, name))
+  if packet.lane != 0:
+    out.append('   virtual uint8_t packet_lane() const { return %d; };\n'
+               % packet.lane)
+  out.append('\n};\n\n')
+  return ''.join(out)
+
+
+def generate_source(base, include_path, namespace, packets):
+  out = [header_comment(base + '.cc', 'The packets of %s.pkt.' % base)]
+  out.append('#include "pf/net/stream/varint.h"\n'
+             '#include "pf/net/packet/factorymanager.h"\n')
+  out.append('#include "%s"\n\n' % include_path)
+  out.append(open_namespace(namespace))
+  for packet in packets:
+    out.append(generate_methods(packet))
+  out.append('bool %s_register_factories() {\n' % base)
+  out.append('  auto manager = NET_PACKET_FACTORYMANAGER_POINTER;\n'
+             '  if (is_null(manager)) return false;\n')
+  for packet in packets:
+    out.append('  manager->add_factory(new %sFactory);\n' % packet.name)
+  out.append('  return true;\n}\n\n')
+  out.append(close_namespace(namespace))
+  return ''.join(out)
+
+
+def indent(lines, prefix='  '):
+  return ''.join(prefix + line + '\n' if line else '\n'
+                 for line in lines.split('\n')[:-1])
+
+
+def compact_branch(stream, packet, lines):
+  """The fields code, branch by the stream mode if the compact is diffrent."""
+  normal = ''.join(lines(field, False) for field in packet.fields)
+  compact = ''.join(lines(field, True) for field in packet.fields)
+  if normal == compact:
+    return normal
+  return ('  if (%s.compact()) {\n%s  } else {\n%s  }\n'
+          % (stream, indent(compact), indent(normal)))
+
+
+def varint_size(field, value):
+  varint = field.varint()
+  bits = varint[-2:]
+  if varint.startswith('varint'):
+    value = 'varint::zigzag_encode%s(%s)' % (bits, value)
+  return 'varint::size%s(%s)' % (bits, value)
+
+
+def read_varint(field, target, space):
+  """Read the varint to the target, the packet read fail if malformed."""
+  if 2 != field.csize():
+    return '%sif (!istream.read_%s(%s)) return false;\n' % (
+        space, field.varint(), target)
+  # The 16 bits use the 32 bits varint, check the range.
+  ctype = field.ctype()
+  vtype = 'uint32_t' if field.varint().startswith('varuint') else 'int32_t'
+  return ('%s%s value{0};\n'
+          '%sif (!istream.read_%s(value) ||\n'
+          '%s    value != static_cast<%s>(static_cast<%s>(value)))\n'
+          '%s  return false;\n'
+          '%s%s = static_cast<%s>(value);\n'
+          % (space, vtype, space, field.varint(), space, vtype, ctype,
+             space, space, target, ctype))
+
+
+def read_lines(field, compact):
+  name = field.name
+  out = []
+  if 'scalar' == field.kind:
+    if compact and field.varint():
+      if 2 == field.csize():
+        out.append('  {\n%s  }\n' % read_varint(field, name + '_', '    '))
+      else:
+        out.append(read_varint(field, name + '_', '  '))
+    elif field.type_name in ('float', 'double'):
+      out.append('  %s_ = istream.read_%s();\n' % (name, field.type_name))
+    else:
+      out.append('  istream >> %s_;\n' % name)
+  elif 'string' == field.kind:
+    out.append('  memset(%s_, 0, sizeof(%s_));\n' % (name, name))
+    if compact:
+      out.append('  {\n'
+                 '    uint32_t length{0};\n'
+                 '    if (!istream.read_varuint32(length)) return false;\n'
+                 '    if (length > sizeof(%s_) - 1) return false;\n'
+                 '    if (length > 0 && istream.read(%s_, length) != length)\n'
+                 '      return false;\n'
+                 '  }\n' % (name, name))
+    else:
+      out.append('  if (!istream.read_string(%s_, sizeof(%s_) - 1)) '
+                 'return false;\n' % (name, name))
+  elif 'bytes' == field.kind:
+    if compact:
+      out.append('  if (!istream.read_varuint32(%s_size_)) return false;\n'
+                 '  if (%s_size_ > sizeof(%s_)) return false;\n'
+                 '  if (%s_size_ > 0 &&\n'
+                 '      istream.read(reinterpret_cast<char *>(%s_), %s_size_) !=\n'
+                 '      %s_size_) return false;\n'
+                 % (name, name, name, name, name, name, name))
+    else:
+      out.append('  if (!istream.read_bytes(%s_, sizeof(%s_), %s_size_))\n'
+                 '    return false;\n' % (name, name, name))
+  elif 'array' == field.kind:
+    if compact:
+      out.append('  if (!istream.read_varuint32(%s_count_)) return false;\n'
+                 % name)
+    else:
+      out.append('  %s_count_ = istream.read_uint32();\n' % name)
+    out.append('  if (%s_count_ > %d) return false;\n' % (name, field.capacity))
+    if compact and 'uint32' == field.type_name:
+      out.append('  if (!istream.read_varuint32_array(%s_, %s_count_)) '
+                 'return false;\n' % (name, name))
+    elif compact and field.varint():
+      out.append('  for (uint32_t i = 0; i < %s_count_; ++i) {\n%s  }\n'
+                 % (name, read_varint(field, name + '_[i]', '    ')))
+    else:
+      out.append('  if (!istream.read_pod_array(%s_, %s_count_)) '
+                 'return false;\n' % (name, name))
+  return ''.join(out)
+
+
+def write_lines(field, compact):
+  name = field.name
+  out = []
+  if 'scalar' == field.kind:
+    if compact and field.varint():
+      out.append('  if (!ostream.write_%s(%s_)) return false;\n'
+                 % (field.varint(), name))
+    elif 'float' == field.type_name:
+      out.append('  ostream.write_float(%s_);\n' % name)
+    elif 'double' == field.type_name:
+      out.append('  ostream.write_dobule(%s_);\n' % name)
+    else:
+      out.append('  ostream << %s_;\n' % name)
+  elif 'string' == field.kind:
+    if compact:
+      out.append('  {\n'
+                 '    auto length = static_cast<uint32_t>(strlen(%s_));\n'
+                 '    if (!ostream.write_varuint32(length)) return false;\n'
+                 '    if (length > 0 && ostream.write(%s_, length) != length)\n'
+                 '      return false;\n'
+                 '  }\n' % (name, name))
+    else:
+      out.append('  ostream << %s_;\n' % name)
+  elif 'bytes' == field.kind:
+    if compact:
+      out.append('  if (!ostream.write_varuint32(%s_size_)) return false;\n'
+                 '  if (%s_size_ > 0 &&\n'
+                 '      ostream.write(reinterpret_cast<char *>(%s_), %s_size_) !=\n'
+                 '      %s_size_) return false;\n'
+                 % (name, name, name, name, name))
+    else:
+      out.append('  ostream.write_bytes(%s_, %s_size_);\n' % (name, name))
+  elif 'array' == field.kind:
+    if compact:
+      out.append('  if (!ostream.write_varuint32(%s_count_)) return false;\n'
+                 % name)
+    else:
+      out.append('  ostream.write_uint32(%s_count_);\n' % name)
+    if compact and 'uint32' == field.type_name:
+      out.append('  if (!ostream.write_varuint32_array(%s_, %s_count_)) '
+                 'return false;\n' % (name, name))
+    elif compact and field.varint():
+      out.append('  for (uint32_t i = 0; i < %s_count_; ++i)\n'
+                 '    if (!ostream.write_%s(%s_[i])) return false;\n'
+                 % (name, field.varint(), name))
+    else:
+      out.append('  if (!ostream.write_pod_array(%s_, %s_count_)) '
+                 'return false;\n' % (name, name))
+  return ''.join(out)
+
+
+def size_lines(field, compact):
+  name = field.name
+  if 'scalar' == field.kind:
+    if compact and field.varint():
+      return '  result += %s;\n' % varint_size(field, name + '_')
+    return '  result += sizeof(%s_);\n' % name
+  if 'string' == field.kind:
+    if compact:
+      return ('  {\n'
+              '    auto length = static_cast<uint32_t>(strlen(%s_));\n'
+              '    result += varint::size32(length) + length;\n'
+              '  }\n' % name)
+    return '  result += sizeof(uint32_t) + strlen(%s_);\n' % name
+  if 'bytes' == field.kind:
+    if compact:
+      return ('  result += varint::size32(%s_size_) + %s_size_;\n'
+              % (name, name))
+    return '  result += sizeof(uint32_t) + %s_size_;\n' % name
+  if compact:
+    out = '  result += varint::size32(%s_count_);\n' % name
+    if field.varint():
+      return out + ('  for (uint32_t i = 0; i < %s_count_; ++i)\n'
+                    '    result += %s;\n'
+                    % (name, varint_size(field, '%s_[i]' % name)))
+    return out + ('  result += sizeof(%s) * %s_count_;\n'
+                  % (field.ctype(), name))
+  return ('  result += sizeof(uint32_t) + sizeof(%s) * %s_count_;\n'
+          % (field.ctype(), name))
+
+
+def generate_methods(packet):
+  name = packet.name
+  out = []
+  out.append('%s::%s() {\n  clear();\n}\n\n' % (name, name))
+  out.append('void %s::clear() {\n' % name)
+  if packet.pod_fields:
+    out.append('  memset(&pod_, 0, sizeof(pod_));\n')
+  for field in packet.fields:
+    if 'scalar' == field.kind:
+      out.append('  %s_ = 0;\n' % field.name)
+    elif 'string' == field.kind:
+      out.append('  memset(%s_, 0, sizeof(%s_));\n' % (field.name, field.name))
+    else:
+      suffix = 'size' if 'bytes' == field.kind else 'count'
+      out.append('  %s_%s_ = 0;\n' % (field.name, suffix))
+  out.append('}\n\n')
+
+  out.append('bool %s::read(pf_net::stream::Input &istream) {\n' % name)
+  if packet.pod_fields:
+    out.append('  if (!istream.read_pod(pod_)) return false;\n')
+  out.append(compact_branch('istream', packet, read_lines))
+  out.append('  return true;\n}\n\n')
+
+  out.append('bool %s::write(pf_net::stream::Output &ostream) {\n' % name)
+  if packet.pod_fields:
+    out.append('  if (!ostream.write_pod(pod_)) return false;\n')
+  out.append(compact_branch('ostream', packet, write_lines))
+  out.append('  return true;\n}\n\n')
+
+  for compact in (False, True):
+    out.append('uint32_t %s::%s() const {\n'
+               % (name, 'compact_size' if compact else 'size'))
+    lines = ''.join(size_lines(field, compact) for field in packet.fields)
+    if 'varint::' in lines:
+      out.append('  namespace varint = pf_net::stream::varint;\n')
+    out.append('  size_t result = 0;\n')
+    if packet.pod_fields:
+      out.append('  result += sizeof(pod_);\n')
+    out.append(lines)
+    out.append('  return static_cast<uint32_t>(result);\n}\n\n')
+
+  for field in packet.fields:
+    if 'bytes' == field.kind:
+      out.append('bool %s::set_%s(const unsigned char *value, uint32_t size) {\n'
+                 '  if (size > sizeof(%s_)) return false;\n'
+                 '  if (size > 0) memcpy(%s_, value, size);\n'
+                 '  %s_size_ = size;\n'
+                 '  return true;\n}\n\n'
+                 % (name, field.name, field.name, field.name, field.name))
+    elif 'array' == field.kind:
+      out.append('bool %s::set_%s(const %s *values, uint32_t count) {\n'
+                 '  if (count > %d) return false;\n'
+                 '  if (count > 0) memcpy(%s_, values, sizeof(%s) * count);\n'
+                 '  %s_count_ = count;\n'
+                 '  return true;\n}\n\n'
+                 % (name, field.name, field.ctype(), field.capacity,
+                    field.name, field.ctype(), field.name))
+  return ''.join(out)
+
+
+def write_if_changed(path, content):
+  if os.path.exists(path):
+    with open(path, 'r') as handle:
+      if handle.read() == content:
+        return
+  with open(path, 'w') as handle:
+    handle.write(content)
+
+
+def main(argv):
+  parser = argparse.ArgumentParser(description='Plain framework packet '
+                                               'schema compiler.')
+  parser.add_argument('--output', required=True, help='output directory')
+  parser.add_argument('--include-prefix', default='',
+                      help='prefix of the generated header in #include')
+  parser.add_argument('schemas', nargs='+', help='the .pkt files')
+  args = parser.parse_args(argv)
+  if not os.path.isdir(args.output):
+    os.makedirs(args.output)
+  for schema in args.schemas:
+    base = os.path.splitext(os.path.basename(schema))[0]
+    try:
+      namespace, packets = parse(schema)
+    except SchemaError as error:
+      sys.stderr.write('packetgen: %s\n' % error)
+      return 1
+    include_path = (args.include_prefix.rstrip('/') + '/' + base + '.h'
+                    if args.include_prefix else base + '.h')
+    write_if_changed(os.path.join(args.output, base + '.h'),
+                     generate_header(base, namespace, packets))
+    write_if_changed(os.path.join(args.output, base + '.cc'),
+                     generate_source(base, include_path, namespace, packets))
+  return 0
+
+
+if __name__ == '__main__':
+  sys.exit(main(sys.argv[1:]))
@@ -0,0 +1,100 @@
+#include "gtest/gtest.h"
+#include "pf/basic/histogram.h"
+
+using namespace pf_basic;
+
+class BasicHistogram : public testing::Test {
+
+ public:
+   static void SetUpTestCase() {
+   }
+
+   static void TearDownTestCase() {
+   }
+
+ public:
+   virtual void SetUp() {
+   }
+   virtual void TearDown() {
+   }
+
+};
+
+//Each value in its bucket range, the linear buckets below the sub count.
+TEST_F(BasicHistogram, testBuckets) {
+  uint64_t values[] = {0, 1, 7, 8, 9, 15, 16, 17, 1000, 123456789, UINT64_MAX};
+  for (auto value : values) {
+    auto index = Histogram::index(value);
+    ASSERT_LT(index, static_cast<uint32_t>(BASIC_HISTOGRAM_SIZE));
+    ASSERT_LE(Histogram::lower(index), value);
+    ASSERT_GE(Histogram::upper(index), value);
+  }
+  for (uint64_t i = 0; i < BASIC_HISTOGRAM_SUB_COUNT; ++i) {
+    ASSERT_EQ(i, Histogram::lower(Histogram::index(i)));
+    ASSERT_EQ(i, Histogram::upper(Histogram::index(i)));
+  }
+  ASSERT_EQ(static_cast<uint32_t>(BASIC_HISTOGRAM_SIZE - 1),
+            Histogram::index(UINT64_MAX));
+  ASSERT_EQ(Histogram::index(1000) + 1,
+            Histogram::index(Histogram::upper(Histogram::index(1000)) + 1));
+}
+
+TEST_F(BasicHistogram, testEmpty) {
+  Histogram histogram;
+  ASSERT_EQ(0u, histogram.count());
+  ASSERT_EQ(0u, histogram.maximum());
+  ASSERT_EQ(0u, histogram.percentile(0.0));
+  ASSERT_EQ(0u, histogram.percentile(0.5));
+  ASSERT_EQ(0u, histogram.percentile(1.0));
+}
+
+//The bucket upper bound not more than the maximum.
+TEST_F(BasicHistogram, testSingle) {
+  Histogram histogram;
+  histogram.record(42);
+  ASSERT_EQ(1u, histogram.count());
+  ASSERT_EQ(42u, histogram.sum());
+  ASSERT_EQ(42u, histogram.percentile(0.0));
+  ASSERT_EQ(42u, histogram.percentile(0.5));
+  ASSERT_EQ(42u, histogram.percentile(1.0));
+  histogram.clear();
+  histogram.record(0);
+  ASSERT_EQ(0u, histogram.percentile(1.0));
+}
+
+//The percentile in the relative error(12.5%) of the real one.
+TEST_F(BasicHistogram, testPercentile) {
+  Histogram histogram;
+  for (uint64_t i = 1; i <= 1000; ++i) histogram.record(i);
+  ASSERT_EQ(1000u, histogram.count());
+  ASSERT_EQ(500500u, histogram.sum());
+  ASSERT_EQ(1000u, histogram.maximum());
+  ASSERT_EQ(1u, histogram.percentile(0.0));
+  ASSERT_EQ(1000u, histogram.percentile(1.0));
+  auto p50 = histogram.percentile(0.5);
+  ASSERT_GE(p50, 500u);
+  ASSERT_LE(p50, 563u);
+  auto p99 = histogram.percentile(0.99);
+  ASSERT_GE(p99, 990u);
+  ASSERT_LE(p99, 1000u);
+}
+
+TEST_F(BasicHistogram, testMerge) {
+  Histogram histogram;
+  Histogram other;
+  for (uint64_t i = 1; i <= 1000; ++i) histogram.record(i);
+  for (uint64_t i = 1001; i <= 2000; ++i) other.record(i);
+  Histogram empty;
+  histogram.merge(empty);
+  ASSERT_EQ(1000u, histogram.count());
+  ASSERT_EQ(1000u, histogram.maximum());
+  histogram.merge(other);
+  ASSERT_EQ(2000u, histogram.count());
+  ASSERT_EQ(2001000u, histogram.sum());
+  ASSERT_EQ(2000u, histogram.maximum());
+  ASSERT_EQ(2000u, histogram.percentile(1.0));
+  auto p50 = histogram.percentile(0.5);
+  ASSERT_GE(p50, 1000u);
+  ASSERT_LE(p50, 1125u);
+  ASSERT_EQ(1000u, other.count()); //The other not changed.
+}
@@ -0,0 +1,152 @@
+#include "gtest/gtest.h"
+#include "pf/basic/logger.h"
+#include "pf/basic/logger.tcc"
+#include "pf/basic/global.h"
+
+using namespace pf_basic;
+
+namespace {
+
+const char *kLoggerTestName = "logger_test";
+const char *kLoggerNolossName = "logger_noloss";
+
+//The line count of the log file.
+uint64_t count_lines(uint8_t type) {
+  char filename[FILENAME_MAX]{0};
+  Logger::get_log_filename(kLoggerNolossName, filename, type);
+  FILE *fp = fopen(filename, "rb");
+  if (is_null(fp)) return 0;
+  uint64_t result{0};
+  char buffer[8192];
+  size_t size{0};
+  while ((size = fread(buffer, 1, sizeof(buffer), fp)) > 0)
+    for (size_t i = 0; i < size; ++i)
+      if ('\n' == buffer[i]) ++result;
+  fclose(fp);
+  return result;
+}
+
+//The binary log arguments like the binary_savelog saved.
+template <typename... TS>
+std::string format(const char *format, const TS &... args) {
+  char buffer[kLogBufferTemp];
+  log_binary::writer_t writer{buffer, 0, sizeof(buffer)};
+  log_binary::encode_all(writer, args...);
+  std::string result;
+  Logger::format_binary(format, buffer, writer.size, result);
+  return result;
+}
+
+} //namespace
+
+class BasicLogger : public testing::Test {
+
+ public:
+   static void SetUpTestCase() {
+   }
+
+   static void TearDownTestCase() {
+   }
+
+ public:
+   virtual void SetUp() {
+   }
+   virtual void TearDown() {
+     GLOBALS["log.binary"] = false;
+     GLOBALS["log.ringsize"] = 1024;
+     config::commit();
+   }
+
+};
+
+TEST_F(BasicLogger, testFormatBinary) {
+  ASSERT_STREQ("1 -2 3 ff", format("%d %d %u %x", 1, -2, 3u, 255).c_str());
+  ASSERT_STREQ("[   7][ab ]", format("[%4d][%-3s]", 7, "ab").c_str());
+  ASSERT_STREQ("[  9]", format("[%*d]", 3, 9).c_str());
+  ASSERT_STREQ("1.50 x str",
+               format("%.2f %c %s", 1.5, 'x', std::string("str")).c_str());
+  ASSERT_STREQ("100%", format("%d%%", 100).c_str());
+  const char *null_string{nullptr};
+  ASSERT_STREQ("(null)", format("%s", null_string).c_str());
+  //The conversion not match use the argument type.
+  ASSERT_STREQ("abc 5 2.000000", format("%d %s %d", "abc", 5, 2.0).c_str());
+  //The missing arguments keep the specifications.
+  ASSERT_STREQ("1 %d %s", format("%d %d %s", 1).c_str());
+  ASSERT_STREQ("end %", format("end %").c_str());
+  //The truncated argument.
+  char buffer[kLogBufferTemp];
+  log_binary::writer_t writer{buffer, 0, sizeof(buffer)};
+  log_binary::encode_all(writer, 1, 2);
+  std::string result;
+  Logger::format_binary("%d %d", buffer, writer.size - 1, result);
+  ASSERT_STREQ("1 %d", result.c_str());
+  result.clear();
+  Logger::format_binary(nullptr, buffer, writer.size, result);
+  ASSERT_TRUE(result.empty());
+}
+
+//The .blog written by the logger thread, decode to the text lines.
+TEST_F(BasicLogger, testDecodeBinary) {
+  GLOBALS["log.binary"] = true;
+  config::commit();
+  char filename[FILENAME_MAX]{0};
+  Logger::get_log_filename(kLoggerTestName, filename);
+  std::string blogname{filename};
+  blogname.replace(blogname.size() - 4, 4, ".blog");
+  remove(blogname.c_str());
+  BINARY_LOG(kLoggerTestName, "decode %d %s %.1f", 42, "text", 0.5);
+  BINARY_LOG(kLoggerTestName, "second %u", 7u);
+  LOGSYSTEM_POINTER->flush_log(kLoggerTestName);
+  FILE *out = tmpfile();
+  ASSERT_NE(nullptr, out);
+  ASSERT_TRUE(Logger::decode_binary(blogname.c_str(), out));
+  rewind(out);
+  std::vector<std::string> lines;
+  char line[1024]{0};
+  while (fgets(line, sizeof(line), out)) lines.push_back(line);
+  fclose(out);
+  ASSERT_EQ(2u, lines.size());
+  std::string first{"decode 42 text 0.5"};
+  std::string second{"second 7"};
+  ASSERT_NE(std::string::npos, lines[0].find(first + LF));
+  ASSERT_NE(std::string::npos, lines[1].find(second + LF));
+  ASSERT_FALSE(Logger::decode_binary("not_exists.blog", out));
+}
+
+//The small buffers full many times, the slow, warning and error logs wait
+//the logger thread and never drop.
+TEST_F(BasicLogger, testNoLoss) {
+  GLOBALS["log.ringsize"] = 64;
+  config::commit();
+  for (uint8_t type = 0; type < 3; ++type) {
+    char filename[FILENAME_MAX]{0};
+    Logger::get_log_filename(kLoggerNolossName, filename, type);
+    remove(filename);
+  }
+  const int32_t threads = 4;
+  const int32_t count = 20000;
+  auto dropped = LOGSYSTEM_POINTER->dropped();
+  std::vector<std::thread> workers;
+  for (int32_t i = 0; i < threads; ++i) {
+    workers.emplace_back([i, count]() {
+      for (int32_t j = 0; j < count; ++j) {
+        switch (j % 3) {
+          case 0:
+            SLOW_LOG(kLoggerNolossName, "thread %d line %d", i, j);
+            break;
+          case 1:
+            SLOW_WARNINGLOG(kLoggerNolossName, "thread %d line %d", i, j);
+            break;
+          default:
+            SLOW_ERRORLOG(kLoggerNolossName, "thread %d line %d", i, j);
+            break;
+        }
+      }
+    });
+  }
+  for (auto &worker : workers) worker.join();
+  LOGSYSTEM_POINTER->flush_log(kLoggerNolossName);
+  ASSERT_EQ(dropped, LOGSYSTEM_POINTER->dropped());
+  ASSERT_EQ(static_cast<uint64_t>(threads * count),
+            count_lines(0) + count_lines(1) + count_lines(2));
+}
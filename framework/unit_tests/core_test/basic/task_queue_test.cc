@@ -0,0 +1,162 @@
+#include "gtest/gtest.h"
+#include "pf/basic/task_queue.tcc"
+
+using namespace pf_basic;
+
+class BasicTaskQueue : public testing::Test {
+
+ public:
+   static void SetUpTestCase() {
+   }
+
+   static void TearDownTestCase() {
+   }
+
+ public:
+   virtual void SetUp() {
+   }
+   virtual void TearDown() {
+   }
+
+};
+
+TEST_F(BasicTaskQueue, testFuture) {
+  TaskQueue queue;
+  auto future = queue.enqueue([](int a, int b) { return a + b; }, 2, 3);
+  ASSERT_EQ(1u, queue.size());
+  ASSERT_EQ(1u, queue.drain());
+  ASSERT_EQ(5, future.get());
+  ASSERT_TRUE(queue.empty());
+}
+
+//The ring full spill to the overflow list, the order still kept.
+TEST_F(BasicTaskQueue, testOverflow) {
+  TaskQueue queue(8);
+  std::vector<int> result;
+  for (int i = 0; i < 100; ++i)
+    queue.post([&result, i]() { result.push_back(i); });
+  ASSERT_EQ(100u, queue.size());
+  ASSERT_EQ(10u, queue.drain(10));
+  for (int i = 100; i < 120; ++i)
+    queue.post([&result, i]() { result.push_back(i); });
+  queue.work_one();
+  ASSERT_EQ(11u, result.size());
+  queue.work_all();
+  ASSERT_EQ(120u, result.size());
+  for (int i = 0; i < 120; ++i) ASSERT_EQ(i, result[i]);
+  ASSERT_TRUE(queue.empty());
+}
+
+//The drain stop at the budget and wakeup again for the left tasks.
+TEST_F(BasicTaskQueue, testBudget) {
+  TaskQueue queue;
+  int32_t wakeups{0};
+  queue.set_wakeup([&wakeups]() { ++wakeups; });
+  int32_t count{0};
+  for (int i = 0; i < 10; ++i) queue.post([&count]() { ++count; });
+  ASSERT_EQ(1, wakeups); //Only the first post to the idle queue.
+  ASSERT_EQ(4u, queue.drain(4));
+  ASSERT_EQ(4, count);
+  ASSERT_EQ(2, wakeups);
+  ASSERT_EQ(4u, queue.drain(4));
+  ASSERT_EQ(2u, queue.drain(4));
+  ASSERT_EQ(10, count);
+  ASSERT_EQ(3, wakeups); //Not wakeup if drained all.
+  ASSERT_EQ(0u, queue.drain(4));
+  queue.set_wakeup(nullptr);
+}
+
+//The large(heap) and move only callables, the exception not lose the tasks.
+TEST_F(BasicTaskQueue, testException) {
+  TaskQueue queue(4);
+  std::unique_ptr<int> pointer(new int(7));
+  int got{0};
+  struct moveonly_struct {
+    std::unique_ptr<int> pointer;
+    int *got;
+    void operator()() { *got = *pointer; }
+  };
+  queue.post(moveonly_struct{std::move(pointer), &got});
+  char big[200] = {1};
+  int sum{0};
+  queue.post([&sum, big]() { sum = big[0]; });
+  queue.post([]() { throw std::runtime_error("task"); });
+  int after{0};
+  queue.post([&after]() { after = 1; });
+  ASSERT_THROW(queue.drain(), std::runtime_error);
+  ASSERT_EQ(7, got);
+  ASSERT_EQ(1, sum);
+  ASSERT_EQ(1u, queue.drain());
+  ASSERT_EQ(1, after);
+  int count{0};
+  for (int round = 0; round < 10; ++round) { //Wrap around the ring.
+    for (int i = 0; i < 3; ++i) queue.post([&count]() { ++count; });
+    queue.drain();
+  }
+  ASSERT_EQ(30, count);
+}
+
+TEST_F(BasicTaskQueue, testReentrant) {
+  TaskQueue queue;
+  int count{0};
+  queue.post([&]() {
+    ++count;
+    queue.post([&]() { ++count; });
+    queue.drain();
+  });
+  queue.drain();
+  ASSERT_EQ(2, count);
+}
+
+//Each producer's tasks run in order.
+TEST_F(BasicTaskQueue, testMultiProducer) {
+  TaskQueue queue(64);
+  std::atomic<int> wakeups{0};
+  queue.set_wakeup([&wakeups]() { ++wakeups; });
+  const int producers = 4, per = 50000;
+  std::vector<int> last(producers, -1);
+  std::atomic<bool> disorder{false};
+  long total{0};
+  std::vector<std::thread> threads;
+  for (int p = 0; p < producers; ++p) {
+    threads.emplace_back([&, p]() {
+      for (int i = 0; i < per; ++i) {
+        queue.post([&, p, i]() {
+          if (last[p] + 1 != i) disorder = true;
+          last[p] = i;
+          ++total;
+        });
+      }
+    });
+  }
+  while (total < producers * per) {
+    if (!queue.wait_for(100)) continue;
+    queue.drain(128);
+  }
+  for (auto &thread : threads) thread.join();
+  ASSERT_FALSE(disorder);
+  ASSERT_EQ(producers * per, total);
+  ASSERT_GT(wakeups.load(), 0);
+  ASSERT_TRUE(queue.empty());
+  ASSERT_FALSE(queue.wait_for(10));
+
+  //The post wakeup the waiting consumer.
+  std::thread thread([&queue]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    queue.post([]() {});
+  });
+  auto start = std::chrono::steady_clock::now();
+  ASSERT_TRUE(queue.wait_for(5000));
+  ASSERT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(2));
+  thread.join();
+  queue.set_wakeup(nullptr);
+}
+
+//The left tasks run when destroy.
+TEST_F(BasicTaskQueue, testStop) {
+  std::unique_ptr<TaskQueue> queue(new TaskQueue);
+  int count{0};
+  queue->post([&count]() { ++count; });
+  queue.reset();
+  ASSERT_EQ(1, count);
+}
@@ -0,0 +1,135 @@
+#include "gtest/gtest.h"
+#include "pf/basic/type/variable.h"
+
+using namespace pf_basic::type;
+
+class BasicVariable : public testing::Test {
+
+ public:
+   static void SetUpTestCase() {
+   }
+
+   static void TearDownTestCase() {
+   }
+
+ public:
+   virtual void SetUp() {
+   }
+   virtual void TearDown() {
+   }
+
+};
+
+//The value read like the string form(std::to_string).
+TEST_F(BasicVariable, testConvert) {
+  variable_t integer{5};
+  ASSERT_STREQ("5", integer.data.c_str());
+  ASSERT_STREQ("5", integer.c_str());
+  ASSERT_EQ(kVariableTypeInt32, integer.type);
+  ASSERT_EQ(5, integer.get<int32_t>());
+  ASSERT_DOUBLE_EQ(5.0, integer.get<double>());
+
+  variable_t real{0.1f};
+  ASSERT_STREQ("0.100000", real.data.c_str());
+  ASSERT_EQ(kVariableTypeFloat, real.type);
+  ASSERT_EQ(0.1, real.get<double>());
+  ASSERT_EQ(0.1f, real.get<float>());
+
+  variable_t third{1.0 / 3};
+  ASSERT_STREQ("0.333333", third.data.c_str());
+  ASSERT_EQ(0.333333, third.get<double>());
+  ASSERT_EQ(0, third.get<int32_t>());
+  ASSERT_EQ(1, variable_t(0.9999999).get<int32_t>());
+  ASSERT_EQ(-6, variable_t(-6.5).get<int32_t>());
+  ASSERT_EQ(INT64_MAX, variable_t(1e20).get<int64_t>());
+
+  variable_t big{UINT64_MAX};
+  ASSERT_STREQ("18446744073709551615", big.data.c_str());
+  ASSERT_EQ(static_cast<uint64_t>(INT64_MAX), big.get<uint64_t>());
+  ASSERT_EQ(INT64_MAX, big.get<int64_t>());
+  ASSERT_DOUBLE_EQ(18446744073709551615.0, big.get<double>());
+  ASSERT_EQ(INT64_MIN, variable_t(INT64_MIN).get<int64_t>());
+  ASSERT_EQ(UINT32_MAX, variable_t(-1).get<uint32_t>());
+
+  ASSERT_EQ(12, variable_t("12abc").get<int32_t>());
+  ASSERT_EQ(0, variable_t("abc").get<int32_t>());
+  ASSERT_DOUBLE_EQ(2.25, variable_t("2.25").get<double>());
+  ASSERT_EQ(INT64_MAX, variable_t("99999999999999999999").get<int64_t>());
+
+  ASSERT_TRUE(variable_t(true).get<bool>());
+  ASSERT_STREQ("1", variable_t(true).c_str());
+  ASSERT_EQ(kVariableTypeBool, variable_t(true).type);
+  ASSERT_FALSE(variable_t(0).get<bool>());
+  ASSERT_TRUE(variable_t(0.0).get<bool>()); //"0.000000"
+  ASSERT_FALSE(variable_t("0").get<bool>());
+  ASSERT_FALSE(variable_t("").get<bool>());
+  ASSERT_TRUE(variable_t("00").get<bool>());
+
+  //The declared type not change the value.
+  variable_t declared = "42";
+  declared.type = kVariableTypeInt64;
+  ASSERT_EQ(42, declared.get<int64_t>());
+}
+
+TEST_F(BasicVariable, testCompare) {
+  ASSERT_TRUE(variable_t(1) == variable_t("1"));
+  ASSERT_TRUE(variable_t(1) == 1);
+  ASSERT_TRUE(variable_t(1.5) == "1.500000");
+  ASSERT_TRUE(variable_t(10) < variable_t(9)); //The string order.
+  ASSERT_TRUE(variable_t("abc") != "abd");
+  ASSERT_TRUE(variable_t("abc") == std::string("abc"));
+  ASSERT_TRUE(variable_t(-1) != variable_t(UINT64_MAX));
+  ASSERT_TRUE(variable_t("b") > "a");
+  variable_t invalid;
+  ASSERT_TRUE(invalid == "");
+  ASSERT_EQ(kVariableTypeInvalid, invalid.type);
+}
+
+TEST_F(BasicVariable, testOperator) {
+  variable_t value{5};
+  value += 1.5;
+  ASSERT_EQ(kVariableTypeInt32, value.type);
+  ASSERT_STREQ("6.500000", value.c_str());
+  ASSERT_EQ(6, value.get<int32_t>());
+
+  variable_t count{5};
+  ++count; count++; count -= 1; count *= 4; count /= 2;
+  ASSERT_EQ(12, count.get<int32_t>());
+  count += "x";
+  ASSERT_STREQ("12x", count.c_str());
+  ASSERT_EQ(kVariableTypeString, count.type);
+  ASSERT_EQ(12, count.get<int32_t>());
+
+  variable_t text{"abc"};
+  text += 1;
+  ASSERT_STREQ("1", text.c_str());
+
+  variable_t copy{text};
+  ASSERT_STREQ("1", copy.c_str());
+  copy = 7;
+  ASSERT_EQ(7, copy.get<int64_t>());
+  ASSERT_STREQ("1", text.c_str());
+  std::stringstream stream;
+  stream << variable_t(3) << variable_t("s");
+  ASSERT_STREQ("3s", stream.str().c_str());
+}
+
+//The reads not change the value(safe to read in threads).
+TEST_F(BasicVariable, testConstRead) {
+  const variable_t value{123456789};
+  auto pointer = value.c_str();
+  std::vector<std::thread> threads;
+  std::atomic<int32_t> errors{0};
+  for (int32_t i = 0; i < 4; ++i) {
+    threads.emplace_back([&value, &errors]() {
+      for (int32_t j = 0; j < 10000; ++j) {
+        if (value.get<int32_t>() != 123456789) ++errors;
+        if (strcmp(value.c_str(), "123456789") != 0) ++errors;
+        if (value.get<double>() != 123456789.0) ++errors;
+      }
+    });
+  }
+  for (auto &thread : threads) thread.join();
+  ASSERT_EQ(0, errors.load());
+  ASSERT_EQ(pointer, value.c_str());
+}
@@ -0,0 +1,131 @@
+#include "gtest/gtest.h"
+#include "pf/net/capture.h"
+#include "pf/net/connection/basic.h"
+#include "pf/net/connection/manager/listener.h"
+#include "pf/net/connection/manager/connector.h"
+#include "pf/net/packet/dynamic.h"
+#include "pf/net/packet/factorymanager.h"
+
+using namespace pf_net;
+using namespace pf_net::connection::manager;
+
+namespace {
+
+const char *kCaptureFile = "capture_test.cap";
+const uint16_t kCapturePort = 17241;
+const uint16_t kPacketNormal = NET_PACKET_ID_DYNAMIC_BEGIN;
+const uint16_t kPacketLimited = NET_PACKET_ID_DYNAMIC_BEGIN + 1;
+
+//The executed packets(id and the first int32 value).
+std::vector< std::pair<uint16_t, int32_t> > g_executed;
+
+uint32_t __stdcall packet_execute(connection::Basic *,
+                                  packet::Interface *packet) {
+  auto dynamic = dynamic_cast<packet::Dynamic *>(packet);
+  if (is_null(dynamic)) return kPacketExecuteStatusError;
+  dynamic->set_readable(true);
+  g_executed.push_back(std::make_pair(packet->get_id(), dynamic->read_int32()));
+  return kPacketExecuteStatusContinue;
+}
+
+} //namespace
+
+class NetCapture : public testing::Test {
+
+ public:
+   static void SetUpTestCase() {
+   }
+
+   static void TearDownTestCase() {
+   }
+
+ public:
+   virtual void SetUp() {
+     g_executed.clear();
+   }
+   virtual void TearDown() {
+     if (NET_PACKET_FACTORYMANAGER_POINTER) {
+       NET_PACKET_FACTORYMANAGER_POINTER->set_function_packet_execute(
+           nullptr);
+     }
+     capture::close();
+     remove(kCaptureFile);
+   }
+
+};
+
+//Only the admitted packets recorded, the replay execute them again with the
+//listener's limit rules.
+TEST_F(NetCapture, testRoundTrip) {
+  ASSERT_TRUE(capture::open(kCaptureFile));
+  Listener server;
+  ASSERT_TRUE(server.init(4, kCapturePort, "127.0.0.1"));
+  //The factory manager created by the first manager.
+  NET_PACKET_FACTORYMANAGER_POINTER->set_function_packet_execute(
+      packet_execute);
+  server.set_capture(true);
+  server.set_packet_limit(kPacketLimited, 
+      connection::limit_rule_t(1, 1, connection::kLimitActionDrop));
+  Connector client;
+  ASSERT_TRUE(client.init(2));
+  auto connection = client.connect("127.0.0.1", kCapturePort);
+  ASSERT_NE(nullptr, connection);
+  for (int32_t i = 0; i < 3; ++i) {
+    packet::Dynamic normal(kPacketNormal);
+    normal.write_int32(i);
+    ASSERT_TRUE(connection->send(&normal));
+    packet::Dynamic limited(kPacketLimited);
+    limited.write_int32(10 + i);
+    ASSERT_TRUE(connection->send(&limited));
+  }
+  //The saved time not changed, so the limited bucket never refill.
+  auto timeout = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (server.limit_counters().dropped.load() < 2 &&
+         std::chrono::steady_clock::now() < timeout) {
+    client.tick();
+    server.tick();
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  decltype(g_executed) executed = {
+    {kPacketNormal, 0}, {kPacketLimited, 10},
+    {kPacketNormal, 1}, {kPacketNormal, 2}
+  };
+  ASSERT_EQ(executed, g_executed);
+  ASSERT_EQ(4u, server.limit_counters().passed.load());
+  ASSERT_EQ(2u, server.limit_counters().dropped.load());
+  capture::close();
+
+  capture::Reader reader;
+  ASSERT_TRUE(reader.open(kCaptureFile));
+  capture::record_t record;
+  uint32_t count{0};
+  while (reader.next(record)) {
+    ++count;
+    ASSERT_EQ(NET_PACKET_HEADERSIZE + sizeof(int32_t), record.data.size());
+  }
+  ASSERT_EQ(4u, count);
+  reader.close();
+
+  g_executed.clear();
+  capture::Replayer replayer;
+  ASSERT_TRUE(replayer.init(kCaptureFile, &server));
+  ASSERT_TRUE(replayer.run(0));
+  ASSERT_EQ(4u, replayer.stat().records);
+  ASSERT_EQ(0u, replayer.stat().failed);
+  ASSERT_EQ(executed, g_executed);
+  ASSERT_EQ(8u, server.limit_counters().passed.load());
+  client.destroy();
+  server.destroy();
+}
+
+TEST_F(NetCapture, testReaderInvalid) {
+  capture::Reader reader;
+  ASSERT_FALSE(reader.open("not_exists.cap"));
+  FILE *fp = fopen(kCaptureFile, "wb");
+  ASSERT_NE(nullptr, fp);
+  fwrite("PFXX0000", 1, 8, fp);
+  fclose(fp);
+  ASSERT_FALSE(reader.open(kCaptureFile));
+  capture::Replayer replayer;
+  ASSERT_FALSE(replayer.init(kCaptureFile, nullptr));
+}
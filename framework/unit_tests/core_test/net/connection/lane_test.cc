@@ -0,0 +1,235 @@
+#include "gtest/gtest.h"
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "pf/net/connection/basic.h"
+#include "pf/net/connection/manager/interface.h"
+#include "pf/net/packet/factorymanager.h"
+#include "pf/net/stream/output.h"
+
+using namespace pf_net;
+
+namespace {
+
+const uint32_t kChunkSize = NET_CONNECTION_LANE_QUANTUM;
+
+void set_nonblocking(int32_t fd) {
+  fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+}
+
+//Read all the available bytes from the peer.
+void read_peer(int32_t fd, std::string &data) {
+  char buffer[8192];
+  ssize_t count = 0;
+  while ((count = recv(fd, buffer, sizeof(buffer), 0)) > 0)
+    data.append(buffer, static_cast<size_t>(count));
+}
+
+//One chunk of the quantum size in the lane as a packet.
+void lane_write(connection::Basic &connection, uint8_t lane, char tag) {
+  std::string chunk(kChunkSize, tag);
+  connection.lane_ostream(lane).write(chunk.data(), kChunkSize);
+  connection.lane_commit(lane, kChunkSize);
+}
+
+int32_t get_cork(int32_t fd) {
+  int32_t value{0};
+  socklen_t length = sizeof(value);
+  getsockopt(fd, IPPROTO_TCP, TCP_CORK, &value, &length);
+  return value;
+}
+
+//The packet write some bytes then failed.
+class BadPacket : public packet::Interface {
+
+ public:
+   virtual bool read(stream::Input &) { return false; }
+   virtual bool write(stream::Output &ostream) {
+     ostream.write("badbad", 6);
+     return false;
+   }
+   virtual uint16_t get_id() const { return 0xfff0; }
+   virtual uint32_t size() const { return 6; }
+
+};
+
+} //namespace
+
+class NetConnectionLane : public testing::Test {
+
+ public:
+   static void SetUpTestCase() {
+     //The protocol send need the packet lanes from the factory manager.
+     if (is_null(NET_PACKET_FACTORYMANAGER_POINTER)) {
+       using FactoryManager = pf_net::packet::FactoryManager;
+       std::unique_ptr<FactoryManager> tmp(new FactoryManager());
+       g_packetfactory_manager = std::move(tmp);
+     }
+     NET_PACKET_FACTORYMANAGER_POINTER->init();
+   }
+
+   static void TearDownTestCase() {
+   }
+
+ public:
+   virtual void SetUp() {
+     peer_ = -1;
+     ASSERT_TRUE(connection_.init(
+           connection::manager::Interface::protocol_default()));
+     connection_.set_protocol(
+         connection::manager::Interface::protocol_default());
+   }
+   virtual void TearDown() {
+     if (peer_ >= 0) close(peer_);
+   }
+
+ protected:
+   //The local stream pair, the connection own the socket.
+   void pair() {
+     int32_t fds[2];
+     ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+     set_nonblocking(fds[0]);
+     set_nonblocking(fds[1]);
+     connection_.socket()->set_id(fds[0]);
+     peer_ = fds[1];
+   }
+
+   //The TCP loopback pair(TCP_CORK only work on it).
+   void tcp_pair(int32_t sendbuffer) {
+     int32_t server = ::socket(AF_INET, SOCK_STREAM, 0);
+     ASSERT_GE(server, 0);
+     sockaddr_in address;
+     memset(&address, 0, sizeof(address));
+     address.sin_family = AF_INET;
+     address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+     address.sin_port = 0;
+     socklen_t length = sizeof(address);
+     ASSERT_EQ(0, bind(server, (sockaddr *)&address, sizeof(address)));
+     ASSERT_EQ(0, listen(server, 1));
+     ASSERT_EQ(0, getsockname(server, (sockaddr *)&address, &length));
+     int32_t client = ::socket(AF_INET, SOCK_STREAM, 0);
+     ASSERT_GE(client, 0);
+     if (sendbuffer > 0) {
+       setsockopt(client, SOL_SOCKET, SO_SNDBUF,
+                  &sendbuffer, sizeof(sendbuffer));
+     }
+     ASSERT_EQ(0, connect(client, (sockaddr *)&address, sizeof(address)));
+     peer_ = accept(server, nullptr, nullptr);
+     close(server);
+     ASSERT_GE(peer_, 0);
+     set_nonblocking(client);
+     set_nonblocking(peer_);
+     connection_.socket()->set_id(client);
+   }
+
+ protected:
+   connection::Basic connection_;
+   int32_t peer_;
+
+};
+
+//The lane 0 first, then the lanes take turns by the weights(3:2).
+TEST_F(NetConnectionLane, testSchedule) {
+  pair();
+  for (int32_t i = 0; i < 4; ++i) {
+    lane_write(connection_, 1, 'a');
+    lane_write(connection_, 2, 'b');
+  }
+  connection_.ostream().write("zzzzzzzzzz", 10);
+  ASSERT_TRUE(connection_.flush());
+  ASSERT_EQ(0u, connection_.output_pending());
+  std::string data;
+  read_peer(peer_, data);
+  ASSERT_EQ(10 + 8 * kChunkSize, data.size());
+  ASSERT_EQ(std::string(10, 'z'), data.substr(0, 10));
+  std::string order;
+  for (size_t i = 10; i < data.size(); i += kChunkSize)
+    order += data[i];
+  ASSERT_STREQ("aaabbabb", order.c_str());
+}
+
+//The output stream only refill to the budget each flush, the order kept.
+TEST_F(NetConnectionLane, testBudget) {
+  pair();
+  const int32_t count = 100;
+  for (int32_t i = 0; i < count; ++i)
+    lane_write(connection_, 1, static_cast<char>('0' + i % 64));
+  ASSERT_TRUE(connection_.flush());
+  ASSERT_GT(connection_.output_pending(), 0u);
+  std::string data;
+  for (int32_t i = 0; i < count && connection_.output_pending() > 0; ++i) {
+    read_peer(peer_, data);
+    ASSERT_TRUE(connection_.flush());
+  }
+  read_peer(peer_, data);
+  ASSERT_EQ(0u, connection_.output_pending());
+  ASSERT_EQ(count * kChunkSize, data.size());
+  for (int32_t i = 0; i < count; ++i)
+    ASSERT_EQ(static_cast<char>('0' + i % 64), data[i * kChunkSize]);
+}
+
+//The failed packet not left in the stream, disconnect if can't roll back.
+TEST_F(NetConnectionLane, testRollback) {
+  BadPacket packet;
+  auto &ostream = connection_.ostream();
+  ASSERT_FALSE(connection_.send(&packet));
+  ASSERT_EQ(0u, ostream.size());
+  ASSERT_FALSE(connection_.is_disconnect());
+  connection_.encrypt_set_key("lane_test");
+  connection_.encrypt_enable(true);
+  ASSERT_FALSE(connection_.send(&packet));
+  ASSERT_TRUE(connection_.is_disconnect());
+  connection_.encrypt_enable(false);
+}
+
+//The cork keep across the ticks, opened by the flush.
+TEST_F(NetConnectionLane, testCork) {
+  tcp_pair(0);
+  auto fd = connection_.socket()->get_id();
+  connection_.set_send_policy(connection::kSendPolicyCork);
+  connection_.ostream().write("cork", 4);
+  ASSERT_TRUE(connection_.process_output());
+  ASSERT_EQ(1, get_cork(fd));
+  ASSERT_TRUE(connection_.process_output());
+  ASSERT_EQ(1, get_cork(fd));
+  ASSERT_TRUE(connection_.flush());
+  ASSERT_EQ(0, get_cork(fd));
+  std::string data;
+  for (int32_t i = 0; i < 1000 && data.size() < 4; ++i) {
+    read_peer(peer_, data);
+    usleep(1000);
+  }
+  ASSERT_STREQ("cork", data.c_str());
+}
+
+//The bulk output can't send in one tick, opened when all sent.
+TEST_F(NetConnectionLane, testCorkBulk) {
+  tcp_pair(4096);
+  auto fd = connection_.socket()->get_id();
+  connection_.set_send_policy(connection::kSendPolicyCork);
+  const uint32_t size = 1024 * 1024;
+  std::string bulk(size, 'x');
+  connection_.ostream().write(bulk.data(), size);
+  ASSERT_TRUE(connection_.process_output());
+  ASSERT_GT(connection_.output_pending(), 0u);
+  ASSERT_GE(connection_.get_flush_stalls(), 1u);
+  ASSERT_EQ(1, get_cork(fd));
+  std::string data;
+  auto timeout = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  while (connection_.output_pending() > 0 &&
+         std::chrono::steady_clock::now() < timeout) {
+    read_peer(peer_, data);
+    ASSERT_TRUE(connection_.process_output());
+    usleep(100);
+  }
+  ASSERT_EQ(0u, connection_.output_pending());
+  ASSERT_EQ(0, get_cork(fd));
+  for (int32_t i = 0; i < 1000 && data.size() < size; ++i) {
+    read_peer(peer_, data);
+    usleep(1000);
+  }
+  ASSERT_EQ(size, data.size());
+}
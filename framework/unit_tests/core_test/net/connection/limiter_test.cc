@@ -0,0 +1,121 @@
+#include "gtest/gtest.h"
+#include "pf/net/connection/limiter.h"
+
+using namespace pf_net::connection;
+
+class NetConnectionLimiter : public testing::Test {
+
+ public:
+   static void SetUpTestCase() {
+   }
+
+   static void TearDownTestCase() {
+   }
+
+ public:
+   virtual void SetUp() {
+   }
+   virtual void TearDown() {
+   }
+
+};
+
+//The token refill by milliseconds, the capacity is the burst.
+TEST_F(NetConnectionLimiter, testTokenBucket) {
+  limit_rule_t rule(10, 2, kLimitActionDrop); //One token each 100ms.
+  token_bucket_t bucket;
+  bucket.tokens = 2 * NET_CONNECTION_LIMIT_TOKEN_SCALE;
+  ASSERT_TRUE(bucket.take(rule, 0));
+  ASSERT_TRUE(bucket.take(rule, 0));
+  ASSERT_FALSE(bucket.take(rule, 0));
+  ASSERT_FALSE(bucket.take(rule, 50));
+  ASSERT_EQ(500u, bucket.tokens); //The half token kept.
+  ASSERT_TRUE(bucket.take(rule, 100));
+  ASSERT_EQ(0u, bucket.tokens);
+
+  //The idle not more than the burst.
+  ASSERT_TRUE(bucket.take(rule, 10000));
+  ASSERT_TRUE(bucket.take(rule, 10000));
+  ASSERT_FALSE(bucket.take(rule, 10000));
+
+  //Not the whole milliseconds(3/s is 333.3ms).
+  limit_rule_t slow(3, 2, kLimitActionDrop);
+  token_bucket_t slow_bucket;
+  ASSERT_FALSE(slow_bucket.take(slow, 333));
+  ASSERT_EQ(999u, slow_bucket.tokens);
+  ASSERT_TRUE(slow_bucket.take(slow, 334));
+  ASSERT_EQ(2u, slow_bucket.tokens);
+
+  //The burst 0 hold one token.
+  limit_rule_t single(10, 0, kLimitActionDrop);
+  token_bucket_t single_bucket;
+  ASSERT_TRUE(single_bucket.take(single, 1000));
+  ASSERT_FALSE(single_bucket.take(single, 1000));
+}
+
+TEST_F(NetConnectionLimiter, testRules) {
+  Limiter limiter;
+  ASSERT_EQ(kLimitActionNone, limiter.check(1, 0)); //Not any rule.
+  limit_rules_t rules;
+  rules.connection = limit_rule_t(10, 2, kLimitActionDrop);
+  rules.packets[5] = limit_rule_t(1, 1, kLimitActionDisconnect);
+  rules.packets[6] = limit_rule_t(1, 1, kLimitActionDelay);
+  rules.packets[7] = limit_rule_t(0, 0, kLimitActionDisconnect); //No limit.
+  limiter.set_rules(&rules, 1000);
+  ASSERT_EQ(kLimitActionNone, limiter.check(1, 1000));
+  ASSERT_EQ(kLimitActionNone, limiter.check(1, 1000));
+  ASSERT_EQ(kLimitActionDrop, limiter.check(1, 1000));
+  ASSERT_EQ(kLimitActionNone, limiter.check(1, 1100));
+  ASSERT_EQ(kLimitActionDrop, limiter.check(1, 1150));
+
+  //The packet bucket full at the first check.
+  ASSERT_EQ(kLimitActionNone, limiter.check(5, 2000));
+  ASSERT_EQ(kLimitActionNone, limiter.check(6, 2100));
+  ASSERT_EQ(kLimitActionDelay, limiter.check(6, 2200));
+  ASSERT_EQ(kLimitActionNone, limiter.check(7, 2300));
+  ASSERT_EQ(kLimitActionDisconnect, limiter.check(5, 2400));
+  ASSERT_EQ(kLimitActionNone, limiter.check(5, 3000));
+
+  //The connection bucket check first.
+  ASSERT_EQ(kLimitActionNone, limiter.check(1, 3000));
+  ASSERT_EQ(kLimitActionDrop, limiter.check(6, 3000));
+
+  auto &counters = limiter.counters();
+  ASSERT_EQ(8u, counters.passed.load());
+  ASSERT_EQ(3u, counters.dropped.load());
+  ASSERT_EQ(1u, counters.delayed.load());
+  ASSERT_EQ(1u, counters.disconnected.load());
+
+  //The rules counters are the total of the connections.
+  Limiter other;
+  other.set_rules(&rules, 3000);
+  ASSERT_EQ(kLimitActionNone, other.check(5, 3000));
+  ASSERT_EQ(kLimitActionDisconnect, other.check(5, 3000));
+  ASSERT_EQ(9u, rules.counters.passed.load());
+  ASSERT_EQ(2u, rules.counters.disconnected.load());
+  ASSERT_EQ(1u, other.counters().disconnected.load());
+
+  limiter.clear();
+  ASSERT_EQ(nullptr, limiter.rules());
+  ASSERT_EQ(0u, limiter.counters().passed.load());
+  ASSERT_EQ(kLimitActionNone, limiter.check(5, 3000));
+}
+
+//The delayed packet retry not take the connection token or count again.
+TEST_F(NetConnectionLimiter, testDelay) {
+  Limiter limiter;
+  limit_rules_t rules;
+  rules.connection = limit_rule_t(2, 3, kLimitActionDrop);
+  rules.packets[6] = limit_rule_t(1, 1, kLimitActionDelay);
+  limiter.set_rules(&rules, 1000);
+  ASSERT_EQ(kLimitActionNone, limiter.check(6, 1000));
+  for (int32_t i = 0; i < 5; ++i)
+    ASSERT_EQ(kLimitActionDelay, limiter.check(6, 1000));
+  ASSERT_EQ(1u, limiter.counters().delayed.load());
+  ASSERT_EQ(kLimitActionNone, limiter.check(1, 1000));
+  ASSERT_EQ(kLimitActionNone, limiter.check(1, 1000));
+  ASSERT_EQ(kLimitActionDrop, limiter.check(1, 1000));
+  ASSERT_EQ(kLimitActionNone, limiter.check(6, 2000));
+  ASSERT_EQ(kLimitActionDelay, limiter.check(6, 2000)); //A new delay.
+  ASSERT_EQ(2u, rules.counters.delayed.load());
+}
@@ -0,0 +1,45 @@
+#include <thread>
+#include "gtest/gtest.h"
+#include "pf/net/metrics.h"
+
+using namespace pf_net;
+
+class NetMetrics : public testing::Test {
+
+ public:
+   static void SetUpTestCase() {
+   }
+
+   static void TearDownTestCase() {
+   }
+
+ public:
+   virtual void SetUp() {
+   }
+   virtual void TearDown() {
+   }
+
+};
+
+//The stats of each thread merged in the snapshot.
+TEST_F(NetMetrics, testSnapshot) {
+  const uint16_t id = 65077; //Not the packets used by others.
+  auto stat = metrics::packet_stat(id);
+  ASSERT_NE(nullptr, stat);
+  ASSERT_EQ(stat, metrics::packet_stat(id)); //The same in a thread.
+  stat->on_read(10, 100);
+  std::thread thread([id]() { metrics::packet_stat(id)->on_read(5, 200); });
+  thread.join();
+  std::vector<metrics::packet_snapshot_t> snapshots;
+  metrics::packet_snapshot(snapshots);
+  metrics::packet_snapshot_t *snapshot{nullptr};
+  for (auto &item : snapshots) {
+    if (id == item.id) snapshot = &item;
+  }
+  ASSERT_NE(nullptr, snapshot);
+  ASSERT_EQ(2u, snapshot->count);
+  ASSERT_EQ(15u, snapshot->bytes);
+  ASSERT_EQ(2u, snapshot->decode->count());
+  ASSERT_EQ(200u, snapshot->decode->maximum());
+  ASSERT_EQ(0u, snapshot->execute->count());
+}
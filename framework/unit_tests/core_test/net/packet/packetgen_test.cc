@@ -0,0 +1,218 @@
+#include "gtest/gtest.h"
+#include "pf/net/stream/input.h"
+#include "pf/net/stream/output.h"
+#include "example.h" //Generated from framework/tools/packetgen/example.pkt.
+
+using namespace pf_net::stream;
+using namespace example::packet;
+
+namespace {
+
+//Take the written bytes out from the output ring(as flush does).
+class TestOutput : public Output {
+
+ public:
+   TestOutput(uint32_t length) : Output(nullptr, length, length * 64) {}
+
+ public:
+   uint32_t take(char *buffer, uint32_t length) {
+     uint32_t count = 0;
+     while (count < length && !empty()) {
+       buffer[count++] = streamdata_.buffer[streamdata_.head];
+       streamdata_.head = (streamdata_.head + 1) % streamdata_.bufferlength;
+     }
+     return count;
+   }
+
+};
+
+} //namespace
+
+class NetPacketgen : public testing::Test {
+
+ public:
+   static void SetUpTestCase() {
+   }
+
+   static void TearDownTestCase() {
+   }
+
+ public:
+   virtual void SetUp() {
+     output_.reset(new TestOutput(8192));
+     output_->init();
+     reset_input();
+   }
+   virtual void TearDown() {
+     output_.reset();
+     input_.reset();
+   }
+
+ protected:
+   void reset_input() {
+     input_.reset(new Input(nullptr, 8192, 8192 * 64));
+     input_->init();
+   }
+   void set_compact(bool compact) {
+     output_->set_compact(compact);
+     input_->set_compact(compact);
+   }
+   //Write the packet and move the bytes to the input, return the size.
+   uint32_t transfer(pf_net::packet::Interface &packet) {
+     auto before = output_->size();
+     if (!packet.write(*output_)) return 0;
+     auto length = static_cast<uint32_t>(output_->size() - before);
+     std::unique_ptr<char[]> buffer(new char[length]);
+     if (output_->take(buffer.get(), length) != length) return 0;
+     if (input_->write(buffer.get(), length) != length) return 0;
+     return length;
+   }
+
+ protected:
+   std::unique_ptr<TestOutput> output_;
+   std::unique_ptr<Input> input_;
+
+};
+
+TEST_F(NetPacketgen, testRoundTrip) {
+  for (int32_t compact = 0; compact < 2; ++compact) {
+    set_compact(1 == compact);
+    Move move;
+    move.set_x(-100);
+    move.set_y(200);
+    move.set_direction(3);
+    move.set_speed(1.5f);
+    move.set_guid(1ULL << 40);
+    auto size = compact ? move.compact_size() : move.size();
+    ASSERT_EQ(size, transfer(move));
+    Move move_result;
+    ASSERT_TRUE(move_result.read(*input_));
+    ASSERT_EQ(-100, move_result.get_x());
+    ASSERT_EQ(200, move_result.get_y());
+    ASSERT_EQ(3, move_result.get_direction());
+    ASSERT_EQ(1.5f, move_result.get_speed());
+    ASSERT_EQ(1ULL << 40, move_result.get_guid());
+
+    Chat chat;
+    unsigned char voice[300]{0};
+    for (uint32_t i = 0; i < sizeof(voice); ++i)
+      voice[i] = static_cast<unsigned char>(i);
+    uint32_t targets[3]{1, 300, 0xffffffff};
+    chat.set_channel(2);
+    chat.set_content("hello");
+    ASSERT_TRUE(chat.set_voice(voice, sizeof(voice)));
+    ASSERT_TRUE(chat.set_targets(targets, 3));
+    ASSERT_FALSE(chat.set_targets(targets, 17));
+    size = compact ? chat.compact_size() : chat.size();
+    ASSERT_EQ(size, transfer(chat));
+    Chat chat_result;
+    ASSERT_TRUE(chat_result.read(*input_));
+    ASSERT_EQ(2, chat_result.get_channel());
+    ASSERT_STREQ("hello", chat_result.get_content());
+    ASSERT_EQ(sizeof(voice), chat_result.get_voice_size());
+    ASSERT_EQ(0, memcmp(voice, chat_result.get_voice(), sizeof(voice)));
+    ASSERT_EQ(3u, chat_result.get_targets_count());
+    ASSERT_EQ(0, memcmp(targets, chat_result.get_targets(), sizeof(targets)));
+    ASSERT_TRUE(input_->empty());
+  }
+}
+
+TEST_F(NetPacketgen, testCompactSize) {
+  MapChunk chunk;
+  unsigned char data[100]{0};
+  chunk.set_offset(5);
+  ASSERT_TRUE(chunk.set_data(data, sizeof(data)));
+  ASSERT_EQ(4u + 4u + 100u, chunk.size());
+  ASSERT_EQ(1u + 1u + 100u, chunk.compact_size());
+  chunk.set_offset(0xffffffff);
+  ASSERT_EQ(5u + 1u + 100u, chunk.compact_size());
+
+  //The max size cover both modes(the compact lengths are 5 bytes at most).
+  ASSERT_EQ(5u + 5u + 4096u, static_cast<uint32_t>(MapChunk::kMaxSize));
+  MapChunkFactory factory;
+  ASSERT_EQ(2, factory.packet_lane());
+  ASSERT_EQ(1003, factory.packet_id());
+  ASSERT_EQ(static_cast<uint32_t>(MapChunk::kMaxSize),
+            factory.packet_max_size());
+}
+
+TEST_F(NetPacketgen, testReadFail) {
+  //The string more than the capacity.
+  char content[300];
+  memset(content, 'a', sizeof(content) - 1);
+  content[sizeof(content) - 1] = '\0';
+  output_->write_uint8(1);
+  output_->write_string(content);
+  char buffer[512]{0};
+  auto length = output_->take(buffer, sizeof(buffer));
+  input_->write(buffer, length);
+  Chat chat;
+  ASSERT_FALSE(chat.read(*input_));
+  reset_input();
+
+  //The bytes length more than the data.
+  output_->write_uint32(7);
+  output_->write_uint32(10);
+  output_->write_uint32(0);
+  length = output_->take(buffer, sizeof(buffer));
+  input_->write(buffer, length);
+  MapChunk chunk;
+  ASSERT_FALSE(chunk.read(*input_));
+  reset_input();
+
+  //The compact array count more than the capacity.
+  set_compact(true);
+  output_->write_uint8(1);
+  output_->write_varuint32(0);
+  output_->write_varuint32(0);
+  output_->write_varuint32(17);
+  length = output_->take(buffer, sizeof(buffer));
+  input_->write(buffer, length);
+  ASSERT_FALSE(chat.read(*input_));
+  reset_input();
+  set_compact(true);
+
+  //The compact varint incomplete or malformed.
+  Move move;
+  move.set_guid(1ULL << 40);
+  ASSERT_TRUE(move.write(*output_));
+  length = output_->take(buffer, sizeof(buffer));
+  input_->write(buffer, length - 1);
+  Move move_result;
+  ASSERT_FALSE(move_result.read(*input_));
+  reset_input();
+  set_compact(true);
+  memset(buffer + length - 6, 0x80, 11);
+  input_->write(buffer, length - 6 + 11);
+  ASSERT_FALSE(move_result.read(*input_));
+  reset_input();
+  set_compact(true);
+
+  //The compact 16 bits fields out of the range.
+  Emote emote;
+  output_->write_varuint32(0x10000);
+  output_->write_varuint32(0);
+  length = output_->take(buffer, sizeof(buffer));
+  input_->write(buffer, length);
+  ASSERT_FALSE(emote.read(*input_));
+  reset_input();
+  set_compact(true);
+  output_->write_varuint32(5);
+  output_->write_varuint32(2);
+  output_->write_varint32(-7);
+  output_->write_varint32(-40000);
+  length = output_->take(buffer, sizeof(buffer));
+  input_->write(buffer, length);
+  ASSERT_FALSE(emote.read(*input_));
+  reset_input();
+  set_compact(true);
+  int16_t targets[2]{-7, INT16_MIN};
+  emote.set_emote(UINT16_MAX);
+  ASSERT_TRUE(emote.set_targets(targets, 2));
+  ASSERT_EQ(emote.compact_size(), transfer(emote));
+  Emote emote_result;
+  ASSERT_TRUE(emote_result.read(*input_));
+  ASSERT_EQ(UINT16_MAX, emote_result.get_emote());
+  ASSERT_EQ(2u, emote_result.get_targets_count());
+  ASSERT_EQ(INT16_MIN, emote_result.get_targets()[1]);
+}
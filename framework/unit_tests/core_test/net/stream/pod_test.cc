@@ -0,0 +1,114 @@
+#include "gtest/gtest.h"
+#include "pf/net/stream/input.h"
+#include "pf/net/stream/output.h"
+
+using namespace pf_net::stream;
+
+namespace {
+
+//Take the written bytes out from the output ring(as flush does).
+class TestOutput : public Output {
+
+ public:
+   TestOutput(uint32_t length) : Output(nullptr, length, length * 64) {}
+
+ public:
+   uint32_t take(char *buffer, uint32_t length) {
+     uint32_t count = 0;
+     while (count < length && !empty()) {
+       buffer[count++] = streamdata_.buffer[streamdata_.head];
+       streamdata_.head = (streamdata_.head + 1) % streamdata_.bufferlength;
+     }
+     return count;
+   }
+
+};
+
+#pragma pack(push, 1)
+struct pod_test_t {
+  int32_t a;
+  uint16_t b;
+  int64_t c;
+  float d;
+};
+#pragma pack(pop)
+
+} //namespace
+
+class NetStreamPod : public testing::Test {
+
+};
+
+TEST_F(NetStreamPod, testRoundTrip) {
+  TestOutput output(64);
+  output.init();
+  Input input(nullptr, 64, 64 * 64);
+  input.init();
+  pod_test_t value{-7, 65535, 1LL << 40, 1.5f};
+  ASSERT_TRUE(output.write_pod(value));
+  ASSERT_EQ(sizeof(value), output.size());
+  char buffer[64]{0};
+  auto length = output.take(buffer, sizeof(buffer));
+  ASSERT_EQ(length, input.write(buffer, length));
+  pod_test_t result;
+  ASSERT_TRUE(input.read_pod(result));
+  ASSERT_EQ(value.a, result.a);
+  ASSERT_EQ(value.b, result.b);
+  ASSERT_EQ(value.c, result.c);
+  ASSERT_EQ(value.d, result.d);
+  ASSERT_TRUE(input.empty());
+}
+
+TEST_F(NetStreamPod, testArrayWrap) {
+  for (int32_t encrypt = 0; encrypt < 2; ++encrypt) {
+    TestOutput output(32);
+    output.init();
+    output.encryptenable(1 == encrypt);
+    char buffer[64]{0};
+    //Move the head forward so the next write wraps around the ring end.
+    uint32_t skip[5]{0};
+    ASSERT_TRUE(output.write_pod_array(skip, 5));
+    ASSERT_EQ(20, output.take(buffer, sizeof(buffer)));
+    uint32_t values[6]{1, 2, 3, 0xffffffff, 5, 6};
+    ASSERT_TRUE(output.write_pod_array(values, 6));
+    ASSERT_EQ(24, output.take(buffer, sizeof(buffer)));
+    Input input(nullptr, 64, 64 * 64);
+    input.init();
+    input.encryptenable(1 == encrypt);
+    //The input encrypt on write and decrypt on read, so give it raw bytes.
+    if (1 == encrypt) output.getencryptor()->decrypt(buffer, buffer, 24);
+    ASSERT_EQ(24, input.write(buffer, 24));
+    uint32_t result[6]{0};
+    ASSERT_TRUE(input.read_pod_array(result, 6));
+    for (int32_t i = 0; i < 6; ++i)
+      ASSERT_EQ(values[i], result[i]);
+  }
+}
+
+//The oversize payload skipped, so the next field still can read.
+TEST_F(NetStreamPod, testStringBytes) {
+  TestOutput output(64);
+  output.init();
+  ASSERT_TRUE(output.write_string("hello"));
+  unsigned char bytes[8]{1, 2, 3, 4, 5, 6, 7, 8};
+  ASSERT_TRUE(output.write_bytes(bytes, sizeof(bytes)));
+  ASSERT_TRUE(output.write_uint32(7));
+  ASSERT_TRUE(output.write_bytes(bytes, 3));
+  ASSERT_TRUE(output.write_uint32(3)); //Length without data.
+  char buffer[128]{0};
+  auto length = output.take(buffer, sizeof(buffer));
+  Input input(nullptr, 128, 128 * 64);
+  input.init();
+  ASSERT_EQ(length, input.write(buffer, length));
+  char small[4]{0};
+  ASSERT_FALSE(input.read_string(small, sizeof(small) - 1));
+  unsigned char result[4]{0};
+  uint32_t size{1};
+  ASSERT_FALSE(input.read_bytes(result, sizeof(result), size));
+  ASSERT_EQ(0u, size);
+  ASSERT_EQ(7u, input.read_uint32());
+  ASSERT_EQ(3u, input.read_bytes(result, sizeof(result)));
+  ASSERT_EQ(0, memcmp(bytes, result, 3));
+  ASSERT_FALSE(input.read_bytes(result, sizeof(result), size));
+  ASSERT_TRUE(input.empty());
+}
@@ -0,0 +1,254 @@
+#include "gtest/gtest.h"
+#include "pf/net/socket/basic.h"
+#include "pf/net/stream/input.h"
+#include "pf/net/stream/output.h"
+#include "pf/net/stream/varint.h"
+#include "pf/net/packet/dynamic.h"
+#include "pf/net/protocol/compact.h"
+
+using namespace pf_net;
+using namespace pf_net::stream;
+
+//The header functions are protected.
+class CompactHeader : public protocol::Compact {
+
+ public:
+   using protocol::Compact::peek_header;
+   using protocol::Compact::write_header;
+
+};
+
+class NetVarint : public testing::Test {
+
+ public:
+   static void SetUpTestCase() {
+   }
+
+   static void TearDownTestCase() {
+   }
+
+ public:
+   virtual void SetUp() {
+     int fds[2]{-1, -1};
+     ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+     sender_.set_id(fds[0]);
+     receiver_.set_id(fds[1]);
+     ostream_.reset(new Output(&sender_));
+     istream_.reset(new Input(&receiver_));
+     ostream_->init();
+     istream_->init();
+   }
+   virtual void TearDown() {
+     ostream_.reset();
+     istream_.reset();
+     sender_.close();
+     receiver_.close();
+   }
+
+ protected:
+   //Send the written bytes to the input.
+   bool transfer() {
+     auto length = static_cast<int32_t>(ostream_->size());
+     if (ostream_->flush() != length) return false;
+     return 0 == length || istream_->fill() == length;
+   }
+
+ protected:
+   socket::Basic sender_;
+   socket::Basic receiver_;
+   std::unique_ptr<Output> ostream_;
+   std::unique_ptr<Input> istream_;
+
+};
+
+TEST_F(NetVarint, testZigzag) {
+  ASSERT_EQ(0u, varint::zigzag_encode32(0));
+  ASSERT_EQ(1u, varint::zigzag_encode32(-1));
+  ASSERT_EQ(2u, varint::zigzag_encode32(1));
+  ASSERT_EQ(0xffffffffu, varint::zigzag_encode32(INT32_MIN));
+  ASSERT_EQ(0xfffffffeu, varint::zigzag_encode32(INT32_MAX));
+  ASSERT_EQ(UINT64_MAX, varint::zigzag_encode64(INT64_MIN));
+  ASSERT_EQ(UINT64_MAX - 1, varint::zigzag_encode64(INT64_MAX));
+  int64_t values[] = {0, -1, 1, INT64_MIN, INT64_MAX, -64, 64};
+  for (auto value : values)
+    ASSERT_EQ(value, varint::zigzag_decode64(varint::zigzag_encode64(value)));
+  ASSERT_EQ(INT32_MIN,
+            varint::zigzag_decode32(varint::zigzag_encode32(INT32_MIN)));
+}
+
+TEST_F(NetVarint, testBoundary) {
+  char buffer[NET_STREAM_VARINT64_SIZEMAX + 1]{0};
+  uint64_t value{1};
+  ASSERT_EQ(1u, varint::encode64(0, buffer));
+  ASSERT_EQ(1, varint::decode64(buffer, 1, value));
+  ASSERT_EQ(0u, value);
+  ASSERT_EQ(1u, varint::size64(0x7f));
+  ASSERT_EQ(2u, varint::size64(0x80));
+  ASSERT_EQ(5u, varint::size32(UINT32_MAX));
+  ASSERT_EQ(9u, varint::size64(INT64_MAX));
+  ASSERT_EQ(10u, varint::size64(UINT64_MAX));
+
+  //-1 is the max value(10 bytes) without zigzag.
+  ASSERT_EQ(10u, varint::encode64(static_cast<uint64_t>(-1), buffer));
+  ASSERT_EQ(10, varint::decode64(buffer, 10, value));
+  ASSERT_EQ(UINT64_MAX, value);
+  ASSERT_EQ(0, varint::decode64(buffer, 9, value)); //Incomplete.
+
+  //INT64_MIN/MAX.
+  ASSERT_EQ(10u, varint::encode64(varint::zigzag_encode64(INT64_MIN), buffer));
+  ASSERT_EQ(10, varint::decode64(buffer, 10, value));
+  ASSERT_EQ(INT64_MIN, varint::zigzag_decode64(value));
+  ASSERT_EQ(10u, varint::encode64(varint::zigzag_encode64(INT64_MAX), buffer));
+  ASSERT_EQ(10, varint::decode64(buffer, 10, value));
+  ASSERT_EQ(INT64_MAX, varint::zigzag_decode64(value));
+
+  //10 bytes overflow: the continue bit on the last byte, or more than 64 bits.
+  memset(buffer, 0x80, sizeof(buffer));
+  ASSERT_EQ(-1, varint::decode64(buffer, sizeof(buffer), value));
+  memset(buffer, 0xff, 9);
+  buffer[9] = 0x02;
+  ASSERT_EQ(-1, varint::decode64(buffer, 10, value));
+
+  //The 32 bits value more than 5 bytes or 32 bits.
+  uint32_t value32{0};
+  memset(buffer, 0xff, 5);
+  buffer[4] = 0x0f;
+  ASSERT_EQ(5, varint::decode32(buffer, 5, value32));
+  ASSERT_EQ(UINT32_MAX, value32);
+  buffer[4] = 0x1f;
+  ASSERT_EQ(-1, varint::decode32(buffer, 5, value32));
+  buffer[4] = static_cast<char>(0x8f);
+  ASSERT_EQ(-1, varint::decode32(buffer, 6, value32));
+}
+
+TEST_F(NetVarint, testArray) {
+  uint32_t values[100]{0};
+  char buffer[sizeof(values) * 2]{0};
+  uint32_t length{0};
+  for (uint32_t i = 0; i < 100; ++i) {
+    values[i] = i < 50 ? i : i << 20; //The single bytes(SSE2) and the others.
+    length += varint::encode32(values[i], buffer + length);
+  }
+  uint32_t result[100]{0};
+  uint32_t consumed{0};
+  ASSERT_EQ(100, varint::decode32_array(buffer, length, result, 100, consumed));
+  ASSERT_EQ(length, consumed);
+  ASSERT_EQ(0, memcmp(values, result, sizeof(values)));
+  ASSERT_EQ(99, varint::decode32_array(
+        buffer, length - 1, result, 100, consumed)); //Incomplete last.
+}
+
+TEST_F(NetVarint, testStream) {
+  int64_t values[] = {0, -1, 1, INT64_MIN, INT64_MAX};
+  for (auto value : values) {
+    ASSERT_TRUE(ostream_->write_varint64(value));
+    ASSERT_TRUE(ostream_->write_varuint64(static_cast<uint64_t>(value)));
+  }
+  ASSERT_TRUE(ostream_->write_varint32(INT32_MIN));
+  ASSERT_TRUE(ostream_->write_varuint32(UINT32_MAX));
+  uint32_t array[20]{0};
+  for (uint32_t i = 0; i < 20; ++i) array[i] = i * 1000;
+  ASSERT_TRUE(ostream_->write_varuint32_array(array, 20));
+  ASSERT_TRUE(transfer());
+  for (auto value : values) {
+    ASSERT_EQ(value, istream_->read_varint64());
+    ASSERT_EQ(static_cast<uint64_t>(value), istream_->read_varuint64());
+  }
+  ASSERT_EQ(INT32_MIN, istream_->read_varint32());
+  ASSERT_EQ(UINT32_MAX, istream_->read_varuint32());
+  uint32_t result[20]{0};
+  ASSERT_TRUE(istream_->read_varuint32_array(result, 20));
+  ASSERT_EQ(0, memcmp(array, result, sizeof(array)));
+  ASSERT_TRUE(istream_->empty());
+}
+
+//The failed read not skip the bytes.
+TEST_F(NetVarint, testReadError) {
+  uint32_t value32{7};
+  uint64_t value64{7};
+  ASSERT_FALSE(istream_->read_varuint32(value32)); //Empty.
+  char buffer[16]{0};
+  memset(buffer, 0x80, 3);
+  istream_->write(buffer, 3);
+  ASSERT_FALSE(istream_->read_varuint32(value32)); //Incomplete.
+  ASSERT_FALSE(istream_->read_varuint64(value64));
+  ASSERT_EQ(3u, istream_->size());
+  ASSERT_TRUE(istream_->skip(3));
+  memset(buffer, 0xff, 6);
+  istream_->write(buffer, 6);
+  ASSERT_FALSE(istream_->read_varuint32(value32)); //More than 5 bytes.
+  ASSERT_EQ(0u, istream_->read_varuint32());
+  ASSERT_EQ(6u, istream_->size());
+  ASSERT_TRUE(istream_->skip(6));
+  memset(buffer, 0x80, 11);
+  istream_->write(buffer, 11);
+  ASSERT_FALSE(istream_->read_varuint64(value64)); //More than 10 bytes.
+  ASSERT_TRUE(istream_->skip(11));
+
+  int32_t signed32{0};
+  int64_t signed64{0};
+  ASSERT_TRUE(ostream_->write_varint32(-3));
+  ASSERT_TRUE(ostream_->write_varint64(INT64_MIN));
+  ASSERT_TRUE(transfer());
+  ASSERT_TRUE(istream_->read_varint32(signed32));
+  ASSERT_EQ(-3, signed32);
+  ASSERT_TRUE(istream_->read_varint64(signed64));
+  ASSERT_EQ(INT64_MIN, signed64);
+  ASSERT_TRUE(istream_->empty());
+}
+
+TEST_F(NetVarint, testDynamic) {
+  packet::Dynamic packet(30000);
+  packet.write_varint32(-5);
+  packet.write_varuint64(1ULL << 60);
+  packet.write_varint64(INT64_MIN);
+  ASSERT_EQ(1u + 9u + 10u, packet.size());
+}
+
+TEST_F(NetVarint, testCompactHeader) {
+  CompactHeader protocol;
+  protocol::header_t header;
+  header.id = 1001;
+  header.size = 100;
+  header.index = 7;
+  ASSERT_EQ(4u, protocol.write_header(*ostream_, header));
+  header.id = 0xffff;
+  header.size = 0xffffff;
+  header.index = 0xff;
+  ASSERT_EQ(8u, protocol.write_header(*ostream_, header));
+  header.size = 0x1000000;
+  ASSERT_EQ(0u, protocol.write_header(*ostream_, header)); //Too large.
+  header.id = 1;
+  header.size = 0;
+  header.index = 0;
+  ASSERT_EQ(3u, protocol.write_header(*ostream_, header));
+  ASSERT_TRUE(transfer());
+
+  protocol::header_t result;
+  ASSERT_EQ(4, protocol.peek_header(*istream_, result));
+  ASSERT_EQ(1001, result.id);
+  ASSERT_EQ(100u, result.size);
+  ASSERT_EQ(7u, result.index);
+  ASSERT_TRUE(istream_->skip(4));
+  ASSERT_EQ(8, protocol.peek_header(*istream_, result));
+  ASSERT_EQ(0xffff, result.id);
+  ASSERT_EQ(0xffffffu, result.size);
+  ASSERT_EQ(0xffu, result.index);
+  ASSERT_TRUE(istream_->skip(8));
+  ASSERT_EQ(3, protocol.peek_header(*istream_, result));
+  ASSERT_EQ(1, result.id);
+  ASSERT_EQ(0u, result.size);
+  ASSERT_TRUE(istream_->skip(3));
+
+  //Incomplete and malformed(the id more than 16 bits).
+  char buffer[8]{0};
+  auto length = varint::encode32(1001, buffer);
+  istream_->write(buffer, length);
+  ASSERT_EQ(0, protocol.peek_header(*istream_, result));
+  istream_->skip(length);
+  length = varint::encode32(0x10000, buffer);
+  length += varint::encode32(1, buffer + length);
+  buffer[length++] = 0;
+  istream_->write(buffer, length);
+  ASSERT_EQ(-1, protocol.peek_header(*istream_, result));
+}
@@ -0,0 +1,147 @@
+#include "gtest/gtest.h"
+#include "env.h"
+#include "pf/sys/awaitable.h"
+#include "pf/sys/executor.h"
+
+using namespace pf_sys;
+
+class SysAwaitable : public testing::Test {
+
+ public:
+   static void SetUpTestCase() {
+   }
+
+   static void TearDownTestCase() {
+   }
+
+ public:
+   virtual void SetUp() {
+     resumer_ = [this](const std::function<void()> &function) {
+       std::unique_lock<std::mutex> autolock(mutex_);
+       loop_.push_back(function);
+     };
+   }
+   virtual void TearDown() {
+     loop_.clear();
+   }
+
+ protected:
+   //Run the loop until the flag set or timeout.
+   bool run_until(const std::atomic<bool> &flag) {
+     auto timeout = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+     while (!flag && std::chrono::steady_clock::now() < timeout) {
+       std::deque< std::function<void()> > functions;
+       {
+         std::unique_lock<std::mutex> autolock(mutex_);
+         functions.swap(loop_);
+       }
+       for (auto &function : functions) function();
+       std::this_thread::sleep_for(std::chrono::milliseconds(1));
+     }
+     return flag;
+   }
+
+ protected:
+   resumer_t resumer_;
+   std::mutex mutex_;
+   std::deque< std::function<void()> > loop_;
+
+};
+
+//The steps resume in the loop which created the chain.
+TEST_F(SysAwaitable, testChain) {
+  auto loop_id = std::this_thread::get_id();
+  std::atomic<bool> done{false};
+  std::vector<std::thread::id> ids;
+  Executor executor(2);
+  {
+    ResumerGuard guard(resumer_);
+    Promise<int> promise;
+    promise.awaitable().then([&](int value) {
+      ids.push_back(std::this_thread::get_id());
+      Promise<std::string> next;
+      executor.submit([next, value]() mutable {
+        next.set_value(std::to_string(value * 2));
+      });
+      return next.awaitable();
+    }).then([&](std::string &value) {
+      ids.push_back(std::this_thread::get_id());
+      ASSERT_EQ("84", value);
+    }).then([&](bool result) {
+      ids.push_back(std::this_thread::get_id());
+      done = result;
+    });
+    std::thread thread([promise]() mutable { promise.set_value(42); });
+    thread.join();
+  }
+  ASSERT_TRUE(run_until(done));
+  ASSERT_EQ(3u, ids.size());
+  for (auto &id : ids) ASSERT_EQ(loop_id, id);
+}
+
+TEST_F(SysAwaitable, testReady) {
+  Promise<int> promise;
+  promise.set_value(1);
+  promise.set_value(2); //Only set once.
+  promise.set_error("ignored");
+  int value{0};
+  promise.awaitable().then([&](int result) { value = result; });
+  ASSERT_EQ(1, value);
+  ASSERT_TRUE(promise.awaitable().ready());
+  ASSERT_FALSE(promise.awaitable().failed());
+}
+
+//The error skip the then functions and pass to the chain end.
+TEST_F(SysAwaitable, testError) {
+  std::atomic<bool> done{false};
+  std::string error;
+  int32_t steps{0};
+  Executor executor(1);
+  Promise<int> promise(resumer_);
+  auto awaitable = promise.awaitable();
+  ASSERT_FALSE(awaitable.failed()); //Pending.
+  awaitable.then([&](int) {
+    ++steps;
+    Promise<int> next;
+    executor.submit([next]() mutable { next.set_error("worker failed"); });
+    return next.awaitable();
+  }).then([&](int) {
+    ++steps;
+  }).on_error([&](const std::string &_error) {
+    error = _error;
+    done = true;
+  });
+  promise.set_value(1);
+  ASSERT_TRUE(run_until(done));
+  ASSERT_EQ(1, steps);
+  ASSERT_EQ("worker failed", error);
+
+  //Fail at the first.
+  Promise<int> failed;
+  failed.set_error("first");
+  ASSERT_TRUE(failed.awaitable().ready());
+  ASSERT_TRUE(failed.awaitable().failed());
+  ASSERT_EQ("first", failed.awaitable().error());
+  auto last = failed.awaitable().then([&](int) { ++steps; });
+  ASSERT_TRUE(last.failed());
+  ASSERT_EQ("first", last.error());
+  ASSERT_EQ(1, steps);
+}
+
+//The invalid awaitable returned by then resolve the chain with error.
+TEST_F(SysAwaitable, testInvalid) {
+  Promise<int> promise;
+  auto last = promise.awaitable().then([](int) { return Awaitable<int>(); });
+  promise.set_value(1);
+  ASSERT_TRUE(last.ready());
+  ASSERT_TRUE(last.failed());
+  ASSERT_NE("", last.error());
+}
+
+TEST_F(SysAwaitable, testQueryError) {
+  std::string error;
+  auto awaitable = engine->query("select 1", "not_exists_db");
+  ASSERT_TRUE(awaitable.failed());
+  awaitable.on_error([&error](const std::string &_error) { error = _error; });
+  ASSERT_NE("", error);
+}